@@ -32,8 +32,9 @@ using namespace hdate;
 int
 main (int argc, char* argv[])
 {
-	// create a new Hdate object
+	// create a new Hdate object, set to the current local date
 	Hdate h;
+	h.set_today ();
 
 	// print gregorian date
 	cout << "Today is :" << endl;
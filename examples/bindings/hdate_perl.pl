@@ -31,6 +31,9 @@ use hdate;
 # Create a new Hdate object
 $h = new hdate::Hdate();
 
+# A new Hdate holds no date until one is set
+$h->set_today();
+
 # Print gregorian date
 print "Today is:\n";
 print $h->get_gday() . "," . $h->get_gmonth() . "," . $h->get_gyear() . "\n";
@@ -31,6 +31,9 @@ require ("hdate.php");
 # Create a new Hdate object
 $h = new Hdate();
 
+# A new Hdate holds no date until one is set
+$h->set_today();
+
 # Print gregorian date
 echo "Today is:\n";
 echo $h->get_gday().".".$h->get_gmonth().",".$h->get_gyear()."\n";
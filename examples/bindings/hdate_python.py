@@ -35,6 +35,9 @@ from hdate import *;
 # Create a new Hdate object
 h = Hdate ();
 
+# A new Hdate holds no date until one is set
+h.set_today ();
+
 # Print gregorian date
 print "Today is:"
 print str (h.get_gday ()) + "," + str (h.get_gmonth ()) + "," + str (h.get_gyear ())
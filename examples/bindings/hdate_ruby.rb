@@ -31,6 +31,9 @@ require 'hdate'
 # Create a new Hdate object
 h = Hdate::Hdate.new
 
+# A new Hdate holds no date until one is set
+h.set_today
+
 # Print gregorian date
 puts "Today is:"
 puts "#{h.get_gday()},#{h.get_gmonth()},#{h.get_gyear()}"
@@ -153,7 +153,6 @@ typedef struct {
 			int* jdn_list_ptr;		/// for custom_days
 			char* string_list_ptr;	/// for custom_days
 			int tzif_entries;
-			int tzif_index;			/// counter into tzif_entries
 			void* tzif_data;
 			time_t epoch_start;		/// for dst transition calc
 			time_t epoch_end;		/// for dst transition calc
@@ -1408,9 +1407,10 @@ void print_week( int jd, const int month, option_list* opt)
 	/// for bidi column alignment
 	int print_len;
 
+	hdate_set_jd (&h, jd);
 	for (calendar_column = 0; calendar_column < 7; calendar_column++)
 	{
-		hdate_set_jd (&h, jd);
+		if (calendar_column) hdate_advance (&h, 1);
 		if ( ((opt->shabbat) || (opt->parasha)) && (calendar_column == 5) )
 			yom_shishi = h;
 		if (opt->html) html_print_day ( h, month, opt );
@@ -1484,10 +1484,10 @@ void print_week( int jd, const int month, option_list* opt)
 			tzset();
 
 			sunset = sunset + get_tz_adjustment( sunset_epoch_time,
-											opt->tz, &opt->tzif_index,
+											opt->tz,
 											opt->tzif_entries, opt->tzif_data );
 			three_stars = three_stars + get_tz_adjustment(three_stars_epoch_time,
-											opt->tz, &opt->tzif_index,
+											opt->tz,
 											opt->tzif_entries, opt->tzif_data );
 
 
@@ -2455,17 +2455,14 @@ int main (int argc, char *argv[])
 	* tzif_entries - number of DST transitions found for the interval
 	*        and the number of entries in each of the associated
 	*        data structures.
-	* tzif_index - DST transition information will always be sorted
-	*        in ascending date order, so this is useful for resuming
-	*        a scan/search
-	* tzif_data -
+	* tzif_data - DST transition information, sorted in ascending
+	*        date order, so get_tz_adjustment can binary search it
 	* epoch_start - date, in epoch format for the beginning of the
 	*        interval
 	* epoch_end - date, in epoch format for the end of the interval.
     * 
 	*****************************************************************/
 	opt.tzif_entries = 0;
-	opt.tzif_index = 0;
 	opt.tzif_data = NULL;
 	opt.epoch_start = 0;
 	opt.epoch_end = 0;
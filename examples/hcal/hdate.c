@@ -160,7 +160,6 @@ typedef struct  {
 				/// double tz_lat;		/// unnecessary, here for parallelism
 				double tz_lon;			/// for sanity checking user input longitude
 				int tzif_entries;
-				int tzif_index;			/// counter into tzif_entries
 				void* tzif_data;
 				int tz_offset;
 				double lat;
@@ -549,7 +548,7 @@ int print_astronomical_time( char *description,	const int timeval_0, option_list
 	if (!opt->print_epoch)
 	{
 		timeval_1 = ( timeval_0 / 60 ) +
-				get_tz_adjustment( timeval_1, opt->tz_offset, &opt->tzif_index,
+				get_tz_adjustment( timeval_1, opt->tz_offset,
 									opt->tzif_entries, opt->tzif_data );
 		if (timeval_1 < 0) timeval_1 = SECONDS_PER_DAY + timeval_1;
 	}
@@ -582,7 +581,7 @@ void print_astronomical_time_tabular( const int  timeval_0, option_list* opt)
 	if (!opt->print_epoch)
 	{
 		timeval_1 = ( timeval_0 / 60 ) +
-				get_tz_adjustment( timeval_1, opt->tz_offset, &opt->tzif_index,
+				get_tz_adjustment( timeval_1, opt->tz_offset,
 									opt->tzif_entries, opt->tzif_data );
 		if (timeval_1 < 0) timeval_1 = SECONDS_PER_DAY + timeval_1;
 		printf(",%02ld:%02ld", (timeval_1 / 60) % 24, timeval_1 % 60 );
@@ -1092,7 +1091,7 @@ int print_times ( hdate_struct * h, option_list* opt, const int holiday)
 	//		line specifying a month range that includes erev pesach, or a year range,
 	//		then just use the code as is now (ie. ignore on days that are not erev pesach
 	// TODO - erev pesach times for tabular output
-	if ( (h->hd_mon = 7) && (h->hd_day == 14) )
+	if ( (h->hd_mon == 7) && (h->hd_day == 14) )
 	{
 		//	print_astronomical_time( "Magen Avraham sun hour", ma_sun_hour, 0);
 		if (opt->end_eating_chometz_ma)
@@ -1612,7 +1611,7 @@ int print_day_tabular (hdate_struct* h, option_list* opt)
 	//		- however, if the explicit erev pesach time request was made with a command
 	//		line specifying a month range that includes erev pesach, or a year range,
 	//		then just use the code as is now (ie. ignore on days that are not erev pesach
-	if ( (h->hd_mon = 7) && (h->hd_day == 14) )
+	if ( (h->hd_mon == 7) && (h->hd_day == 14) )
 	{
 		//	print_astronomical_time( "Magen Avraham sun hour", ma_sun_hour, 0);
 		if (opt->end_eating_chometz_ma)  print_astronomical_time_tabular( first_light + (4 * ma_sun_hour), opt);
@@ -1932,18 +1931,15 @@ int print_day (hdate_struct * h, option_list* opt)
 int print_gmonth_tabular( option_list* opt, const int month, const int year)
 {
 	hdate_struct h;
-	int jd;
 
 	/// get date of month start
 	hdate_set_gdate (&h, 1, month, year);
-	jd = h.hd_jd;
 
 	/// print month days
 	while (h.gd_mon == month)
 	{
 		print_day_tabular (&h, opt);
-		jd++;
-		hdate_set_jd (&h, jd);
+		hdate_advance (&h, 1);
 	}
 
 	return 0;
@@ -1957,11 +1953,9 @@ int print_gmonth_tabular( option_list* opt, const int month, const int year)
 int print_gmonth ( option_list* opt, int month, int year)
 {
 	hdate_struct h;
-	int jd;
 
 	/// get date of month start
 	hdate_set_gdate (&h, 1, month, year);
-	jd = h.hd_jd;
 
 	/// print month header
 	if (!opt->iCal && !opt->short_format)
@@ -1972,8 +1966,7 @@ int print_gmonth ( option_list* opt, int month, int year)
 	while (h.gd_mon == month)
 	{
 		print_day (&h, opt);
-		jd++;
-		hdate_set_jd (&h, jd);
+		hdate_advance (&h, 1);
 	}
 
 	return 0;
@@ -1988,18 +1981,15 @@ int print_hmonth_tabular
 	(	option_list* opt, const int month, const int year)
 {
 	hdate_struct h;
-	int jd;
 
 	/// get date of month start
 	hdate_set_hdate (&h, 1, month, year);
-	jd = h.hd_jd;
 
 	/// print month days
 	while (h.hd_mon == month)
 	{
 		print_day_tabular (&h, opt);
-		jd++;
-		hdate_set_jd (&h, jd);
+		hdate_advance (&h, 1);
 	}
 
 	return 0;
@@ -2012,13 +2002,9 @@ int print_hmonth_tabular
 int print_hmonth (hdate_struct * h, option_list* opt,
 					const int month, const int year)
 {
-	int jd;
 	int bidi_buffer_len;
 	char* bidi_buffer;
 
-	/// get date of month start
-	jd = h->hd_jd;
-
 	/// print month header
 	if (!opt->iCal && !opt->short_format)
 	{
@@ -2042,8 +2028,7 @@ int print_hmonth (hdate_struct * h, option_list* opt,
 	{
 		print_day (h, opt);
 
-		jd++;
-		hdate_set_jd (h, jd);
+		hdate_advance (h, 1);
 	}
 	return 0;
 }
@@ -2816,7 +2801,6 @@ int main (int argc, char *argv[])
 	opt.tz_offset = BAD_TIMEZONE;
 	opt.tzif_entries =0;
 	opt.tzif_data = NULL;
-	opt.tzif_index = 0;
 	opt.print_tomorrow = 0;		/// TRUE if currently after sunset
 	opt.time_option_requested = FALSE;
 	opt.epoch_start= 0;			/// for checking dst transitions
@@ -3310,7 +3294,7 @@ int main (int argc, char *argv[])
 	if (hdate_action == PROCESS_EPOCH_DAY)
 	{
 		opt.epoch_start = opt.epoch_today + (60 * get_tz_adjustment(  opt.epoch_today, opt.tz_offset,
-										&opt.tzif_index, opt.tzif_entries, opt.tzif_data ));
+										opt.tzif_entries, opt.tzif_data ));
 	/* temp, delete this! */ printf("epoch value = %ld, epoch start = %ld, adjustment = %ld\n", opt.epoch_today,
 												opt.epoch_start, opt.epoch_start - opt.epoch_today);
 		opt.epoch_end = opt.epoch_start + SECONDS_PER_DAY;
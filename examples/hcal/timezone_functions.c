@@ -872,7 +872,7 @@ int get_lat_lon_from_zonetab_file( const char* input_string, char** tz_name, dou
 
 
 /// get tz adjustment (with daylight savings time awareness)
-int get_tz_adjustment(	const time_t t, const int tz, int *tzif_index,
+int get_tz_adjustment(	const time_t t, const int tz,
 						const int tzif_entries, const void *tzif_data )
 {
 	int tz_adjustment = JERUSALEM_STANDARD_TIME_IN_MINUTES;
@@ -882,13 +882,8 @@ int get_tz_adjustment(	const time_t t, const int tz, int *tzif_index,
 		error(0,0,"run time error: function get_tz_adjustment, reverting to Jerusalem Standard time");
 	else
 	{
-		zd = tzif_data;
-		if (   (*tzif_index < (tzif_entries - 1) )
-			&& (zd[*tzif_index + 1].start < t ) )
-		{
-			*tzif_index = *tzif_index + 1;
-		}
-		tz_adjustment = (zd[*tzif_index].utc_offset) / 60 ;
+		zd = (zdumpinfo*) tzif_data;
+		tz_adjustment = (zd[ zdump_entry_at( zd, tzif_entries, t ) ].utc_offset) / 60 ;
 	}
 	return tz_adjustment;
 }
@@ -28,5 +28,5 @@ char*
 read_sys_tz_string_from_file();
 
 int
-get_tz_adjustment(  const time_t t, const int tz, int *tzif_index,
+get_tz_adjustment(  const time_t t, const int tz,
 					const int tzif_entries, const void *tzif_data );
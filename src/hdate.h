@@ -27,6 +27,9 @@
 #ifndef __HDATE_H__
 #define __HDATE_H__
 
+#include <stddef.h> /// for size_t
+#include <time.h> /// for time_t
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -170,6 +173,137 @@ hdate_set_hdate (hdate_struct *h, int d, int m, int y);
 hdate_struct *
 hdate_set_jd (hdate_struct *h, int jd);
 
+/**
+ @brief the julian day of a moment, as a local date
+
+ Pure arithmetic; does not consult the time zone database or the
+ environment, so is safe and cheap to call from any thread.
+
+ @param t the moment, in seconds since the epoch
+ @param tz_offset the local offset from UTC in seconds, east positive
+	(as tm_gmtoff)
+ @return the julian day number of the local date of t
+ */
+int
+hdate_time_to_jd (time_t t, long tz_offset);
+
+/**
+ @brief compute date structure from a moment in time
+
+ A reentrant alternative to passing a zero day or month to
+ hdate_set_gdate or hdate_set_hdate.
+
+ @param h pointer this hdate struct.
+ @param t the moment, in seconds since the epoch
+ @param tz_offset the local offset from UTC in seconds, east positive
+	(as tm_gmtoff)
+ @return pointer to this hdate struct
+ */
+hdate_struct *
+hdate_set_time (hdate_struct *h, time_t t, long tz_offset);
+
+/**
+ @brief compute date structure for the current local date
+
+ The same as passing a zero day or month to hdate_set_gdate.
+ All three use localtime_r, so are safe to call from any thread.
+
+ @param h pointer this hdate struct.
+ @return pointer to this hdate struct
+ */
+hdate_struct *
+hdate_set_today (hdate_struct *h);
+
+/** @def HDATE_FIELD_HDATE
+  @brief for hdate_set_jd_fields: hd_day, hd_mon, hd_year
+*/
+#define HDATE_FIELD_HDATE  1
+
+/** @def HDATE_FIELD_GDATE
+  @brief for hdate_set_jd_fields: gd_day, gd_mon, gd_year
+*/
+#define HDATE_FIELD_GDATE  2
+
+/** @def HDATE_FIELD_DW
+  @brief for hdate_set_jd_fields: hd_dw
+*/
+#define HDATE_FIELD_DW     4
+
+/** @def HDATE_FIELD_YEAR
+  @brief for hdate_set_jd_fields: hd_size_of_year, hd_new_year_dw, hd_year_type
+*/
+#define HDATE_FIELD_YEAR   8
+
+/** @def HDATE_FIELD_DAYS
+  @brief for hdate_set_jd_fields: hd_days, hd_weeks
+*/
+#define HDATE_FIELD_DAYS   16
+
+/** @def HDATE_FIELD_ALL
+  @brief for hdate_set_jd_fields: every field, same as hdate_set_jd
+*/
+#define HDATE_FIELD_ALL    31
+
+/** @def HDATE_FIELD_UNSET
+  @brief value of a field that hdate_set_jd_fields was not asked to compute
+*/
+#define HDATE_FIELD_UNSET  (-2147483647 - 1)
+
+/**
+ @brief compute some fields of the date structure from the Julian day
+
+ Only the fields named in the mask are computed; the others are set to
+ HDATE_FIELD_UNSET. The hdate_get_ accessor functions compute an unset
+ field on demand, but the holiday, parasha, omer and format functions
+ read the struct directly and need HDATE_FIELD_ALL.
+
+ @param h pointer this hdate struct.
+ @param jd the julian day number.
+ @param fields bitwise or of HDATE_FIELD_HDATE, HDATE_FIELD_GDATE,
+	HDATE_FIELD_DW, HDATE_FIELD_YEAR, HDATE_FIELD_DAYS
+ @return pointer to this hdate struct
+ */
+hdate_struct *
+hdate_set_jd_fields (hdate_struct *h, int jd, int fields);
+
+/**
+ @brief move the date structure by a number of days
+
+ A cheap alternative to hdate_set_jd (h, h->hd_jd + ndays) for walking
+ a calendar: within the Hebrew year of the date, the fields are updated
+ in place; only crossing 1 Tishrey does the full conversion.
+
+ @param h pointer this hdate struct, with all fields set.
+ @param ndays the number of days to move, negative for the past
+ @return pointer to this hdate struct
+ */
+hdate_struct *
+hdate_advance (hdate_struct *h, int ndays);
+
+/**
+ @brief compute dates for an array of julian days
+
+ Output is one array per field; any output array may be NULL, except
+ that gd_day, gd_mon and gd_year are filled together or not at all.
+
+ @param jd array of julian day numbers.
+ @param count number of entries in jd and in each output array.
+ @param hd_day return the Hebrew day of month 1..30
+ @param hd_mon return the Hebrew month 1..14 (13 - Adar 1, 14 - Adar 2)
+ @param hd_year return the Hebrew year
+ @param gd_day return the Gregorian day of month 1..31
+ @param gd_mon return the Gregorian month 1..12
+ @param gd_year return the Gregorian year
+ @param dw return the day of the week 1..7 (1 - sunday)
+ @param year_type return the Hebrew year type 1..14
+ @return the number of dates converted
+ */
+int
+hdate_set_jd_array (int const *jd, int count,
+	int *hd_day, int *hd_mon, int *hd_year,
+	int *gd_day, int *gd_mon, int *gd_year,
+	int *dw, int *year_type);
+
 /*************************************************************/
 /*************************************************************/
 
@@ -192,6 +326,24 @@ hdate_set_jd (hdate_struct *h, int jd);
 char *
 hdate_get_format_date (hdate_struct const * h, int diaspora, int s);
 
+/**
+ @brief Write the hebrew date into a buffer.
+
+ The same text as hdate_get_format_date, written snprintf style into a
+ caller supplied buffer, without using the heap.
+
+ @param h pointer this hdate struct.
+ @param diaspora if true give diaspora holydays
+ @param short_format A short flag (true - returns a short string, false returns a long string).
+ @param buffer the buffer to write into, may be NULL if buffer_len is 0
+ @param buffer_len the size of buffer
+ @return the length of the formated date, not counting the terminating
+ null, even if it did not all fit into the buffer; -1 upon failure.
+*/
+int
+hdate_format_date_r (hdate_struct const * h, int diaspora, int short_format,
+					 char *buffer, size_t buffer_len);
+
 /**
  @brief get the number of hebrew parasha.
 
@@ -203,6 +355,94 @@ hdate_get_format_date (hdate_struct const * h, int diaspora, int s);
 int
 hdate_get_parasha (hdate_struct const * h, int diaspora);
 
+/**
+ @brief Return number of hebrew parasha of the week of a julian day.
+
+ @param jd the julian day number.
+ @param diaspora if true give diaspora readings
+ @return the number of parasha read on the Shabbat ending the week of
+	jd, or 0 if that Shabbat has a holiday reading.
+*/
+int
+hdate_get_parasha_for_week (int jd, int diaspora);
+
+/** @struct hdate_parasha_iter
+  @brief iterator over the parasha readings of a range of days
+*/
+typedef struct
+{
+	/** The next julian day to look at. */
+	int jd;
+	/** The last julian day of the range. */
+	int jd_end;
+	/** True for diaspora readings. */
+	int diaspora;
+	/** The Hebrew year of jd. */
+	int hd_year;
+	/** The julian day of 1 Tishrey of hd_year. */
+	int jd_tishrey1;
+	/** The length of hd_year in days. */
+	int size_of_year;
+} hdate_parasha_iter;
+
+/**
+ @brief Start iterating over the parasha readings between two julian days.
+
+ @param it the iterator to set.
+ @param jd_start first julian day of the range
+ @param jd_end last julian day of the range
+ @param diaspora if true give diaspora readings
+*/
+void
+hdate_parasha_iter_init (hdate_parasha_iter *it, int jd_start, int jd_end, int diaspora);
+
+/**
+ @brief Start iterating over the parasha readings of a Hebrew year.
+
+ @param it the iterator to set.
+ @param hebrew_year the Hebrew year
+ @param diaspora if true give diaspora readings
+*/
+void
+hdate_parasha_iter_hebrew_year (hdate_parasha_iter *it, int hebrew_year, int diaspora);
+
+/**
+ @brief Start iterating over the parasha readings of a Gregorian year.
+
+ @param it the iterator to set.
+ @param year the Gregorian year
+ @param diaspora if true give diaspora readings
+*/
+void
+hdate_parasha_iter_gregorian_year (hdate_parasha_iter *it, int year, int diaspora);
+
+/**
+ @brief Get the next parasha reading of an iterator.
+
+ Gives every day for which hdate_get_parasha is not 0.
+
+ @param it the iterator.
+ @param jd return the julian day of the reading
+ @param parasha return the number of the parasha
+ @return true if a reading was returned, false at the end of the range
+*/
+int
+hdate_parasha_iter_next (hdate_parasha_iter *it, int *jd, int *parasha);
+
+/**
+ @brief Find the days a parasha is read in a Hebrew year.
+
+ @param hebrew_year the Hebrew year
+ @param parasha the parasha number, as hdate_get_parasha returns it
+ @param diaspora if true give diaspora readings
+ @param jd return the julian days of the reading, may be NULL
+ @param size number of entries jd has room for
+ @return the number of days the parasha is read in the year, which may
+	be more than size
+*/
+int
+hdate_find_parasha (int hebrew_year, int parasha, int diaspora, int *jd, int size);
+
 /**
  @brief Return number of hebrew halachic holiday.
 
@@ -233,6 +473,58 @@ hdate_get_israeli_day (hdate_struct const * h, int diaspora);
 int
 hdate_get_holyday (hdate_struct const * h, int diaspora);
 
+/**
+ @brief Return the next day after a julian day that is a holiday.
+
+ @param jd the julian day number to search from (not included).
+ @param diaspora if true give diaspora holidays
+ @param holiday return the number of the holiday found, may be NULL
+ @return the julian day of the holiday, or 0 if out of range
+*/
+int
+hdate_next_holiday (int jd, int diaspora, int *holiday);
+
+/**
+ @brief Return the last day before a julian day that is a holiday.
+
+ @param jd the julian day number to search from (not included).
+ @param diaspora if true give diaspora holidays
+ @param holiday return the number of the holiday found, may be NULL
+ @return the julian day of the holiday, or 0 if out of range
+*/
+int
+hdate_prev_holiday (int jd, int diaspora, int *holiday);
+
+/**
+ @brief List the holidays between two julian days.
+
+ @param jd_start first julian day of the range
+ @param jd_end last julian day of the range
+ @param diaspora if true give diaspora holidays
+ @param jd return the julian days of the holidays, may be NULL
+ @param holiday return the numbers of the holidays, may be NULL
+ @param size number of entries jd and holiday have room for
+ @return the number of holidays in the range, which may be more than
+	size; or -1 if the range is out of bounds
+*/
+int
+hdate_holidays_in_range (int jd_start, int jd_end, int diaspora,
+						 int *jd, int *holiday, int size);
+
+/**
+ @brief Find the days of a holiday in a Hebrew year.
+
+ @param hebrew_year the Hebrew year
+ @param holiday the holiday number, as hdate_get_holyday returns it
+ @param diaspora if true give diaspora holidays
+ @param jd return the julian days of the holiday, may be NULL
+ @param size number of entries jd has room for
+ @return the number of days of the holiday in the year, which may be
+	more than size; or -1 if the year is out of range
+*/
+int
+hdate_find_holyday (int hebrew_year, int holiday, int diaspora, int *jd, int size);
+
 /*************************************************************/
 /*************************************************************/
 
@@ -403,6 +695,21 @@ hdate_days_from_3744 (int hebrew_year);
 int
 hdate_get_year_type (int size_of_year, int new_year_dw);
 
+/**
+ @brief Return Tishrey 1, length and type of a Hebrew year.
+ 
+ Years from HDATE_HEB_YR_LOWER_BOUND to HDATE_HEB_YR_UPPER_BOUND are
+ read from a table that is filled once per year; other years are
+ computed from the molad.
+ 
+ @param hebrew_year The Hebrew year
+ @param jd_tishrey1 return the julian number of 1 Tishrey this year
+ @param size_of_year return the length of the year in days
+ @return the number for year type (1..14)
+*/
+int
+hdate_get_year_info (int hebrew_year, int *jd_tishrey1, int *size_of_year);
+
 /**
  @brief Compute Julian day from Gregorian date
 
@@ -444,6 +751,36 @@ hdate_hdate_to_jd (int day, int month, int year, int *jd_tishrey1, int *jd_tishr
 void
 hdate_jd_to_gdate (int jd, int *day, int *month, int *year);
 
+/**
+ @brief Compute an array of Julian days from Gregorian dates
+
+ Same results as hdate_gdate_to_jd, vectorized where the machine allows.
+
+ @param day Day of month 1..31
+ @param month Month 1..12
+ @param year Year in 4 digits e.g. 2001
+ @param jd return the julian day numbers
+ @param count number of entries in each array
+ @return the number of dates converted
+ */
+int
+hdate_gdate_to_jd_array (int const *day, int const *month, int const *year, int *jd, int count);
+
+/**
+ @brief Converting an array of Julian days to Gregorian dates
+
+ Same results as hdate_jd_to_gdate, vectorized where the machine allows.
+
+ @param jd array of Julian days
+ @param day return Day of month 1..31
+ @param month return Month 1..12
+ @param year return Year in 4 digits e.g. 2001
+ @param count number of entries in each array
+ @return the number of dates converted
+ */
+int
+hdate_jd_to_gdate_array (int const *jd, int *day, int *month, int *year, int count);
+
 /**
  @brief Converting from the Julian day to the Hebrew day
  
@@ -523,6 +860,44 @@ hdate_get_utc_sun_time_deg_seconds ( const int day, const int month, const int y
 							 const double latitude, const double longitude, const double deg,
 							 int *sunrise, int *sunset);
 
+/** @def HDATE_SUN_NORMAL
+  @brief sun status: the sun gets to the altitude
+*/
+#define HDATE_SUN_NORMAL       0
+
+/** @def HDATE_SUN_NEVER_RISES
+  @brief sun status: the sun stays below the altitude all day
+*/
+#define HDATE_SUN_NEVER_RISES  1
+
+/** @def HDATE_SUN_NEVER_SETS
+  @brief sun status: the sun stays above the altitude all day
+*/
+#define HDATE_SUN_NEVER_SETS   2
+
+/**
+ @brief utc sun times for altitude at a gregorian date - reentrant
+
+ Returns the sunset and sunrise times in seconds from 00:00 (utc time)
+ if sun altitude in sunrise is deg degrees, and whether the sun gets
+ to that altitude at all. errno is neither used nor changed.
+
+ @param day this day of month
+ @param month this month
+ @param year this year
+ @param longitude longitude to use in calculations
+ @param latitude latitude to use in calculations
+ @param deg degrees of sun's altitude (0 -  Zenith .. 90 - Horizon)
+ @param sunrise return the utc sunrise in seconds, -720 if none
+ @param sunset return the utc sunset in seconds, -720 if none
+ @return HDATE_SUN_NORMAL, or HDATE_SUN_NEVER_RISES if the sun stays
+	below the altitude all day, HDATE_SUN_NEVER_SETS if above it
+*/
+int
+hdate_get_utc_sun_time_deg_seconds_r ( const int day, const int month, const int year,
+							 const double latitude, const double longitude, const double deg,
+							 int *sunrise, int *sunset);
+
 /**
  @brief utc sunrise/set time for a gregorian date
   
@@ -564,6 +939,103 @@ hdate_get_utc_sun_time_full (const int day, const int month, const int year,
 	int *sun_hour, int *first_light, int *talit, int *sunrise,
 	int *midday, int *sunset, int *first_stars, int *three_stars);
 
+/**
+ @brief utc sun times for altitude at a gregorian date, many locations
+
+ Same as hdate_get_utc_sun_time_deg_seconds for each location, but the
+ sun position of the date is computed once, and the locations are done
+ several at a time where the machine allows. A time may differ from the
+ one of hdate_get_utc_sun_time_deg_seconds by a second: the vector code
+ uses polynomials for sin, cos and acos that agree with libm only to an
+ ulp or two, so a time falling on a whole second may round the other
+ way.
+
+ @param day this day of month
+ @param month this month
+ @param year this year
+ @param latitude array of latitudes to use in calculations
+ @param longitude array of longitudes to use in calculations
+ @param count number of entries in each array
+ @param deg degrees of sun's altitude (0 -  Zenith .. 90 - Horizon)
+ @param sunrise return the utc sunrise in seconds
+ @param sunset return the utc sunset in seconds
+ @param status return HDATE_SUN_NORMAL, or HDATE_SUN_NEVER_RISES /
+	HDATE_SUN_NEVER_SETS if the sun never gets to this altitude, and
+	sunrise and sunset are -720; may be NULL
+ @return the number of locations computed
+*/
+int
+hdate_get_utc_sun_time_deg_seconds_array (const int day, const int month, const int year,
+	double const *latitude, double const *longitude, int count, const double deg,
+	int *sunrise, int *sunset, int *status);
+
+/** @def HDATE_SUN_ANGLES
+  @brief number of sun altitudes of hdate_get_utc_sun_time_full
+*/
+#define HDATE_SUN_ANGLES 5
+
+/** @struct hdate_sun_location
+  @brief sun time context of a location
+*/
+typedef struct
+{
+	/** The latitude in degrees, negative values are south. */
+	double latitude;
+	/** The longitude in degrees, negative values are east. */
+	double longitude;
+	/** cos of the latitude. */
+	double cos_latitude;
+	/** tan of the latitude. */
+	double tan_latitude;
+	/** cos of each sun altitude of hdate_get_utc_sun_time_full. */
+	double cos_angle[HDATE_SUN_ANGLES];
+} hdate_sun_location;
+
+/**
+ @brief set a sun time context for a location
+
+ @param loc the context to set
+ @param latitude latitude to use in calculations
+	degrees, negative values are south
+ @param longitude longitude to use in calculations
+	degrees, negative values are east
+*/
+void
+hdate_sun_location_init (hdate_sun_location *loc,
+	const double latitude, const double longitude);
+
+/**
+ @brief utc sun times for a range of days at a location
+
+ Same results as hdate_get_utc_sun_time_full for each day. Each output
+ is an array of count entries, and may be NULL, but for status, which
+ has HDATE_SUN_ANGLES entries a day: those of day i start at
+ status[i * HDATE_SUN_ANGLES], one for each altitude, in the order
+ sunrise and sunset, first light, talit, first stars, three stars.
+ A time whose status is not HDATE_SUN_NORMAL is meaningless.
+
+ @param loc the location context
+ @param jd julian day number of the first day
+ @param count number of days
+ @param sun_hour return the length of shaa zaminit in minutes
+ @param first_light return the utc alut ha-shachar in minutes
+ @param talit return the utc tphilin and talit in minutes
+ @param sunrise return the utc sunrise in minutes
+ @param midday return the utc midday in minutes
+ @param sunset return the utc sunset in minutes
+ @param first_stars return the utc tzeit hacochavim in minutes
+ @param three_stars return the utc shlosha cochavim in minutes
+ @param status return HDATE_SUN_NORMAL, or HDATE_SUN_NEVER_RISES /
+	HDATE_SUN_NEVER_SETS if the sun never gets to an altitude that day;
+	sun_hour and midday are meaningless unless sunrise and sunset are
+	HDATE_SUN_NORMAL
+*/
+void
+hdate_sun_location_times (hdate_sun_location const *loc, int jd, int count,
+	int *sun_hour, int *first_light, int *talit, int *sunrise,
+	int *midday, int *sunset, int *first_stars, int *three_stars,
+	int *status);
+
 /*************************************************************/
 /*************************************************************/
 
@@ -741,6 +1213,125 @@ hdate_is_hebrew_locale();
 */
 char* hdate_string( int type_of_string, int index, int short_form, int hebrew_form);
 
+/**
+ @brief   Write string values for hdate information into a buffer
+ @return  the length of the string, not counting the terminating null,
+          even if it did not all fit into the buffer (as snprintf does);
+          -1 upon failure. Integers and omer days are built in place,
+          without using the heap.
+ @param type_of_string 	as in hdate_string
+ @param index			as in hdate_string
+ @param short_form   0 = short format
+ @param hebrew_form  0 = not hebrew (native/embedded)
+ @param buffer       the buffer to write into, may be NULL if buffer_len is 0
+ @param buffer_len   the size of buffer
+*/
+int
+hdate_string_r (int type_of_string, int index, int short_form, int hebrew_form,
+				char *buffer, size_t buffer_len);
+
+/**
+ @brief   Return read-only string values for hdate information
+ @return  a pointer to a static string, that must not be freed or
+          changed; or a null pointer for an integer or omer day that
+          is not interned, or upon failure. Integers 1 .. 49 and
+          5000 .. 6999 and all omer days are interned; for other
+          integers use hdate_string or hdate_string_r.
+ @param type_of_string 	as in hdate_string
+ @param index			as in hdate_string
+ @param short_form   0 = short format
+ @param hebrew_form  0 = not hebrew (native/embedded)
+*/
+const char *
+hdate_string_static (int type_of_string, int index, int short_form, int hebrew_form);
+
+/** @def HDATE_CONTEXT_NAME_SIZE
+  @brief size of each name held in a hdate_format_context
+*/
+#define HDATE_CONTEXT_NAME_SIZE 64
+
+/** @struct hdate_format_context
+  @brief formatting and parsing settings, taken from the locale once
+*/
+typedef struct
+{
+	/** True for diaspora holydays. */
+	int diaspora;
+	/** HDATE_STRING_SHORT or HDATE_STRING_LONG. */
+	int short_form;
+	/** HDATE_STRING_HEBREW in a hebrew locale, else HDATE_STRING_LOCAL. */
+	int hebrew_form;
+	/** Gregorian month names, long then short. */
+	char months[2][12][HDATE_CONTEXT_NAME_SIZE];
+	/** Week day names, long then short. */
+	char days[2][7][HDATE_CONTEXT_NAME_SIZE];
+	/** The LC_TIME month names and abbreviations, for parsing. */
+	char locale_months[24][HDATE_CONTEXT_NAME_SIZE];
+	/** Hebrew month names, long then short. */
+	const char *hebrew_months[2][14];
+	/** Parasha names, long then short. */
+	const char *parashaot[2][62];
+	/** Holyday names, long then short. */
+	const char *holidays[2][40];
+} hdate_format_context;
+
+/**
+ @brief Set a formatting context from the current locale.
+
+ Probes the locale (hebrew or latin, the LC_TIME month and week day
+ names) once, so that the hdate_*_ctx functions need not.
+ Call again if the locale changes.
+
+ @param ctx the context to set
+ @param diaspora if true give diaspora holydays
+ @param short_form HDATE_STRING_SHORT or HDATE_STRING_LONG
+*/
+void
+hdate_format_context_init (hdate_format_context *ctx, int diaspora, int short_form);
+
+/**
+ @brief   Return read-only string values for hdate information, using a context
+ @return  as hdate_string_static, but week days and gregorian months
+          come from the context, and the short and hebrew forms are
+          those of the context.
+ @param ctx the formatting context
+ @param type_of_string 	as in hdate_string
+ @param index			as in hdate_string
+*/
+const char *
+hdate_string_ctx (hdate_format_context const *ctx, int type_of_string, int index);
+
+/**
+ @brief Write the hebrew date into a buffer, using a context.
+
+ As hdate_format_date_r, with the diaspora flag, short format and
+ hebrew locale taken from the context.
+
+ @param ctx the formatting context
+ @param h The hdate_struct of the date to print.
+ @param buffer the buffer to write into, may be NULL if buffer_len is 0
+ @param buffer_len the size of buffer
+ @return the length of the formated date, not counting the terminating
+ null, even if it did not all fit into the buffer; -1 upon failure.
+*/
+int
+hdate_format_date_ctx (hdate_format_context const *ctx, hdate_struct const * h,
+					   char *buffer, size_t buffer_len);
+
+/**
+ @brief Parse a month name, using a context.
+
+ As hdate_parse_month_text_string, with the locale's month names taken
+ from the context instead of setting the locale.
+
+ @param ctx the formatting context
+ @param month_text the month name
+ @return month number 1 - 12 for gregorian, 101 - 114 for Hebrew,
+ 0 on failure
+*/
+int
+hdate_parse_month_text_ctx (hdate_format_context const *ctx, const char* month_text);
+
 /** @def HDATE_STRING_INT
   @brief for function hdate_string: identifies string type: integer
 */
@@ -815,6 +1406,118 @@ int hdate_parse_date( const char* parm_a, const char* parm_b, const char* parm_c
 					 const int prefer_hebrew, const int prefer_2_parm_ym,
 					 const int base_year_h, const int base_year_g );
 
+/** @def HDATE_PARSE_OK
+  @brief for hdate_parse_date_records: a whole date
+*/
+#define HDATE_PARSE_OK               0
+/** @def HDATE_PARSE_INCOMPLETE
+  @brief for hdate_parse_date_records: a month or a year without a day;
+  the julian day is that of its first day
+*/
+#define HDATE_PARSE_INCOMPLETE       1
+/** @def HDATE_PARSE_BAD_YEAR
+  @brief for hdate_parse_date_records: a year non-numeric or out of bounds
+*/
+#define HDATE_PARSE_BAD_YEAR         2
+/** @def HDATE_PARSE_BAD_MONTH
+  @brief for hdate_parse_date_records: a month unknown or out of bounds
+*/
+#define HDATE_PARSE_BAD_MONTH        3
+/** @def HDATE_PARSE_BAD_DAY
+  @brief for hdate_parse_date_records: a day out of bounds
+*/
+#define HDATE_PARSE_BAD_DAY          4
+/** @def HDATE_PARSE_MISMATCH
+  @brief for hdate_parse_date_records: a Hebrew/gregorian mix
+*/
+#define HDATE_PARSE_MISMATCH         5
+/** @def HDATE_PARSE_MULTIPLE_MONTHS
+  @brief for hdate_parse_date_records: more than one month name
+*/
+#define HDATE_PARSE_MULTIPLE_MONTHS  6
+/** @def HDATE_PARSE_MULTIPLE_YEARS
+  @brief for hdate_parse_date_records: more than one year
+*/
+#define HDATE_PARSE_MULTIPLE_YEARS   7
+/** @def HDATE_PARSE_FIELD_COUNT
+  @brief for hdate_parse_date_records: no date column, or not one to
+  three parts in it
+*/
+#define HDATE_PARSE_FIELD_COUNT      8
+/** @def HDATE_PARSE_UNSUPPORTED
+  @brief for hdate_parse_date_records: three numbers in a form the
+  parser does not handle yet
+*/
+#define HDATE_PARSE_UNSUPPORTED      9
+/** @def HDATE_PARSE_INVALID_DATE
+  @brief for hdate_parse_date_records: no such day, eg. 30 February
+*/
+#define HDATE_PARSE_INVALID_DATE    10
+/** @def HDATE_PARSE_UNEXPECTED
+  @brief for hdate_parse_date_records: an internal error
+*/
+#define HDATE_PARSE_UNEXPECTED      11
+
+/** @struct hdate_parse_options
+  @brief settings for hdate_parse_date_records
+*/
+typedef struct
+{
+	/** ',' or '\t' for CSV or TSV records, 0 for one date per line. */
+	char field_separator;
+	/** The column holding the date, from 0. */
+	int column;
+	/** As for hdate_parse_date. */
+	int prefer_hebrew;
+	/** As for hdate_parse_date: HDATE_PREFER_YM or HDATE_PREFER_MD. */
+	int prefer_2_parm_ym;
+	/** As for hdate_parse_date. */
+	int base_year_h;
+	/** As for hdate_parse_date. */
+	int base_year_g;
+	/** The date to complete dates without a year from. */
+	hdate_struct today;
+	/** The month names to recognize. */
+	hdate_format_context names;
+} hdate_parse_options;
+
+/**
+ @brief Set parse options to their defaults.
+
+ One date per line, Hebrew preferred, two parts taken as year and
+ month, HDATE_DEFAULT_BASE_YEAR_H and HDATE_DEFAULT_BASE_YEAR_G,
+ today's date and the current locale's month names.
+
+ @param options the options to set
+*/
+void hdate_parse_options_init( hdate_parse_options* options );
+
+/**
+ @brief Parse a buffer of date records.
+
+ Each line is a record; its date (the whole line, or a CSV or TSV
+ column, possibly in double quotes) has one to three parts, separated
+ by spaces, '/', '-', '.' or ',', which are interpreted as
+ hdate_parse_date does. Nothing is printed and nothing is allocated.
+
+ To parse a stream in pieces, pass at_end false until the last piece,
+ and start the next piece at the first byte not consumed.
+
+ @param options the parse options, see hdate_parse_options_init
+ @param text the records
+ @param length the length of text
+ @param at_end if false, a last line without a newline is left unconsumed
+ @param jd return the julian day of each record, or 0 if it has none
+ @param error_code return an HDATE_PARSE_* code for each record
+ @param size the size of the jd and error_code arrays
+ @param consumed if not NULL, return the number of bytes of text parsed
+ @return the number of records parsed, or -1 if options or text is NULL,
+ size is negative, or size is positive and jd or error_code is NULL
+*/
+int hdate_parse_date_records( const hdate_parse_options* options,
+							  const char* text, size_t length, int at_end,
+							  int* jd, int* error_code, int size, size_t* consumed );
+
 int hdate_get_size_of_hebrew_month( const unsigned int month, const unsigned int hebrew_year_type);
 
 int hdate_get_size_of_gregorian_month( const unsigned int month, const unsigned int year);
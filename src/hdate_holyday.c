@@ -18,9 +18,120 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
  
+#include <string.h>
+
 #include "hdate.h"
 #include "support.h"
 
+/** Holiday index
+ **
+ ** Which day of a year is which holiday depends only on the week day
+ ** of 1 Tishrey, the length of the year, the diaspora flag and, for the
+ ** Israeli days, on which of the gregorian-year cutoffs in
+ ** hdate_get_israeli_day the year is past (its "era"). So there are at
+ ** most 7 x 6 x 2 x 7 distinct holiday calendars (fewer in practice, as
+ ** only 14 week day and length pairs are valid year types). Each is built the first time a year needing it is seen,
+ ** by running the day-by-day rules over that year, and holds both the
+ ** holiday of every day of the year and a sorted list of the days that
+ ** are holidays.
+ **
+ ** An index is published with an atomic state flag; a thread that finds
+ ** an index being built by another thread builds a private copy instead
+ ** of waiting. **/
+#define HOLIDAY_INDEX_DAYS    385
+#define HOLIDAY_INDEX_MAX     64
+#define HOLIDAY_INDEX_ERAS    7
+#define HOLIDAY_INDEX_EMPTY   0
+#define HOLIDAY_INDEX_BUSY    1
+#define HOLIDAY_INDEX_READY   2
+
+typedef struct {
+	int state;
+	int count;
+	unsigned char code[HOLIDAY_INDEX_DAYS];	/// holiday of each day, 0 = 1 Tishrey
+	unsigned short day[HOLIDAY_INDEX_MAX];	/// days of the year that are holidays
+	} holiday_index;
+
+static holiday_index holiday_indexes[7][6][2][HOLIDAY_INDEX_ERAS];
+
+/** First Hebrew year of each era after the first. These follow the
+ ** gd_year checks in hdate_get_israeli_day: Cheshvan of Hebrew year y
+ ** falls in gregorian year y - 3761, Nisan to Tammuz in y - 3760. **/
+static const int holiday_era_start[HOLIDAY_INDEX_ERAS - 1] = {
+	5708,	/// 1948 Yom HaAtzma'ut, Yom HaZikaron
+	5718,	/// 1958 Yom HaShoah
+	5728,	/// 1968 Yom Yerushalayim
+	5758,	/// 1997 Rabin memorial day
+	5764,	/// 2004 Yom HaAtzma'ut, Yom HaZikaron postponement rules
+	5765	/// 2005 Zhabotinsky day
+	};
+
+/**
+ @brief fill a holiday index from the rules, day by day
+*/
+static void
+build_holiday_index (holiday_index *idx, int jd_tishrey1, int size_of_year, int diaspora)
+{
+	hdate_struct h;
+	int i, code;
+
+	idx->count = 0;
+	memset (idx->code, 0, sizeof (idx->code));
+	for (i = 0; i < size_of_year && i < HOLIDAY_INDEX_DAYS; i++)
+	{
+		hdate_set_jd (&h, jd_tishrey1 + i);
+		code = hdate_get_halachic_day (&h, diaspora);
+		if (code == 0)
+			code = hdate_get_israeli_day (&h, diaspora);
+		idx->code[i] = code;
+		if (code && idx->count < HOLIDAY_INDEX_MAX)
+			idx->day[idx->count++] = i;
+	}
+}
+
+/**
+ @brief get the holiday index of a Hebrew year
+
+ @param hebrew_year the Hebrew year
+ @param diaspora if True give diaspora holydays
+ @param scratch space to build a private index in, if need be
+ @param jd_tishrey1 return the julian day of 1 Tishrey of the year
+ @return the index, or NULL if the year is out of range
+*/
+static holiday_index const *
+get_holiday_index (int hebrew_year, int diaspora, holiday_index *scratch, int *jd_tishrey1)
+{
+	holiday_index *idx;
+	int size_of_year, size_class, era;
+
+	if (hebrew_year < HDATE_HEB_YR_LOWER_BOUND || hebrew_year > HDATE_HEB_YR_UPPER_BOUND)
+		return NULL;
+	hdate_get_year_info (hebrew_year, jd_tishrey1, &size_of_year);
+
+	/* 353, 354, 355, 383, 384, 385 => 0..5 */
+	size_class = size_of_year - 353;
+	if (size_class > 2) size_class -= 27;
+	if (size_class < 0 || size_class > 5) return NULL;
+
+	diaspora = diaspora ? 1 : 0;
+	for (era = 0; era < HOLIDAY_INDEX_ERAS - 1; era++)
+		if (hebrew_year < holiday_era_start[era]) break;
+	idx = &holiday_indexes[(*jd_tishrey1 + 1) % 7][size_class][diaspora][era];
+
+	if (__atomic_load_n (&idx->state, __ATOMIC_ACQUIRE) == HOLIDAY_INDEX_READY)
+		return idx;
+
+	if (__sync_bool_compare_and_swap (&idx->state, HOLIDAY_INDEX_EMPTY, HOLIDAY_INDEX_BUSY))
+	{
+		build_holiday_index (idx, *jd_tishrey1, size_of_year, diaspora);
+		__atomic_store_n (&idx->state, HOLIDAY_INDEX_READY, __ATOMIC_RELEASE);
+		return idx;
+	}
+
+	build_holiday_index (scratch, *jd_tishrey1, size_of_year, diaspora);
+	return scratch;
+}
+
 /**
  @brief Return number of halachic holiday or Israeli custom day.
 
@@ -31,13 +142,194 @@
 int
 hdate_get_holyday (hdate_struct const * h, int diaspora)
 {
+	holiday_index scratch;
+	holiday_index const *idx;
+	int jd_tishrey1;
 	int day_code = 0;
+
+	/* a fully populated struct can use the holiday index */
+	if (h->hd_days >= 1 && h->hd_days <= HOLIDAY_INDEX_DAYS)
+	{
+		idx = get_holiday_index (h->hd_year, diaspora, &scratch, &jd_tishrey1);
+		if (idx && (jd_tishrey1 + h->hd_days - 1 == h->hd_jd))
+			return idx->code[h->hd_days - 1];
+	}
+
 	day_code = hdate_get_halachic_day( h, diaspora);
 	if (day_code == 0)
 		day_code = hdate_get_israeli_day( h, diaspora);
 	return day_code;
 }
 
+/**
+ @brief Find the days of a holiday in a Hebrew year.
+
+ @param hebrew_year the Hebrew year
+ @param holiday the holiday number, as hdate_get_holyday returns it
+ @param diaspora if True give diaspora holydays
+ @param jd return the julian days of the holiday, may be NULL
+ @param size number of entries jd has room for
+ @return the number of days of the holiday in the year, which may be
+	more than size; or -1 if the year is out of range
+*/
+int
+hdate_find_holyday (int hebrew_year, int holiday, int diaspora, int *jd, int size)
+{
+	holiday_index scratch;
+	holiday_index const *idx;
+	int jd_tishrey1, i;
+	int found = 0;
+
+	idx = get_holiday_index (hebrew_year, diaspora, &scratch, &jd_tishrey1);
+	if (!idx) return -1;
+	if (holiday == 0) return 0;
+
+	for (i = 0; i < idx->count; i++)
+	{
+		if (idx->code[idx->day[i]] != holiday) continue;
+		if (jd && found < size) jd[found] = jd_tishrey1 + idx->day[i];
+		found++;
+	}
+
+	return found;
+}
+
+/**
+ @brief Return the next day after a julian day that is a holiday.
+
+ @param jd the julian day number to search from (not included).
+ @param diaspora if True give diaspora holydays
+ @param holiday return the number of the holiday found, may be NULL
+ @return the julian day of the holiday, or 0 if out of range
+*/
+int
+hdate_next_holiday (int jd, int diaspora, int *holiday)
+{
+	holiday_index scratch;
+	holiday_index const *idx;
+	hdate_struct h;
+	int jd_tishrey1, year, day, lo, hi, mid;
+
+	hdate_set_jd_fields (&h, jd, HDATE_FIELD_HDATE | HDATE_FIELD_DAYS);
+
+	/* day of year of jd + 1, counting 1 Tishrey as 0 */
+	day = h.hd_days;
+	for (year = h.hd_year; year <= h.hd_year + 1; year++, day = 0)
+	{
+		idx = get_holiday_index (year, diaspora, &scratch, &jd_tishrey1);
+		if (!idx) break;
+
+		/* first listed day >= day */
+		lo = 0;
+		hi = idx->count;
+		while (lo < hi)
+		{
+			mid = (lo + hi) / 2;
+			if (idx->day[mid] < day) lo = mid + 1;
+			else hi = mid;
+		}
+		if (lo < idx->count)
+		{
+			if (holiday) *holiday = idx->code[idx->day[lo]];
+			return jd_tishrey1 + idx->day[lo];
+		}
+	}
+
+	return 0;
+}
+
+/**
+ @brief Return the last day before a julian day that is a holiday.
+
+ @param jd the julian day number to search from (not included).
+ @param diaspora if True give diaspora holydays
+ @param holiday return the number of the holiday found, may be NULL
+ @return the julian day of the holiday, or 0 if out of range
+*/
+int
+hdate_prev_holiday (int jd, int diaspora, int *holiday)
+{
+	holiday_index scratch;
+	holiday_index const *idx;
+	hdate_struct h;
+	int jd_tishrey1, year, day, lo, hi, mid;
+
+	hdate_set_jd_fields (&h, jd, HDATE_FIELD_HDATE | HDATE_FIELD_DAYS);
+
+	/* day of year of jd - 1, counting 1 Tishrey as 0 */
+	day = h.hd_days - 2;
+	for (year = h.hd_year; year >= h.hd_year - 1; year--, day = HOLIDAY_INDEX_DAYS)
+	{
+		idx = get_holiday_index (year, diaspora, &scratch, &jd_tishrey1);
+		if (!idx) break;
+
+		/* last listed day <= day */
+		lo = 0;
+		hi = idx->count;
+		while (lo < hi)
+		{
+			mid = (lo + hi) / 2;
+			if (idx->day[mid] <= day) lo = mid + 1;
+			else hi = mid;
+		}
+		if (lo > 0)
+		{
+			if (holiday) *holiday = idx->code[idx->day[lo - 1]];
+			return jd_tishrey1 + idx->day[lo - 1];
+		}
+	}
+
+	return 0;
+}
+
+/**
+ @brief List the holidays between two julian days.
+
+ @param jd_start first julian day of the range
+ @param jd_end last julian day of the range
+ @param diaspora if True give diaspora holydays
+ @param jd return the julian days of the holidays, may be NULL
+ @param holiday return the numbers of the holidays, may be NULL
+ @param size number of entries jd and holiday have room for
+ @return the number of holidays in the range, which may be more than
+	size; or -1 if the range is out of bounds
+*/
+int
+hdate_holidays_in_range (int jd_start, int jd_end, int diaspora,
+						 int *jd, int *holiday, int size)
+{
+	holiday_index scratch;
+	holiday_index const *idx;
+	hdate_struct h;
+	int jd_tishrey1, year, i, day_jd;
+	int found = 0;
+
+	if (jd_end < jd_start) return 0;
+
+	hdate_set_jd_fields (&h, jd_start, HDATE_FIELD_HDATE);
+	for (year = h.hd_year; ; year++)
+	{
+		idx = get_holiday_index (year, diaspora, &scratch, &jd_tishrey1);
+		if (!idx) return -1;
+		if (jd_tishrey1 > jd_end) break;
+
+		for (i = 0; i < idx->count; i++)
+		{
+			day_jd = jd_tishrey1 + idx->day[i];
+			if (day_jd < jd_start) continue;
+			if (day_jd > jd_end) break;
+			if (found < size)
+			{
+				if (jd) jd[found] = day_jd;
+				if (holiday) holiday[found] = idx->code[idx->day[i]];
+			}
+			found++;
+		}
+	}
+
+	return found;
+}
+
 
 /**
  @brief Return number of hebrew halachic holiday.
@@ -30,15 +30,15 @@
 #define MONTH (DAY+M(12,793))	/* Tikun for regular month */
 
 /**
- @brief Days since bet (?) Tishrey 3744
+ @brief Days since bet (?) Tishrey 3744, by molad arithmetic
  
  @author Amos Shapir 1984 (rev. 1985, 1992) Yaacov Zamir 2003-2005 
  
  @param hebrew_year The Hebrew year
  @return Number of days since 3,1,3744
 */
-int
-hdate_days_from_3744 (int hebrew_year)
+static int
+days_from_3744_molad (int hebrew_year)
 {
 	int years_from_3744;
 	int molad_3744;
@@ -87,6 +87,113 @@ hdate_days_from_3744 (int hebrew_year)
 	return days;
 }
 
+/** The year table holds one packed entry per Hebrew year in the
+ ** supported range (plus the following year, so that the last year
+ ** also knows where it ends). An entry is filled the first time its
+ ** year is asked for, and never changes after that; two threads
+ ** racing to fill the same entry will both store the same value.
+ **
+ **  bits  0-20  Tishrey 1 JDN, less HDATE_JUL_DY_LOWER_BOUND
+ **  bits 21-23  year length class, 0..5 = 353,354,355,383,384,385
+ **  bits 24-27  year type, 1..14
+ **  bit     31  entry is filled **/
+#define YEAR_TABLE_FIRST   HDATE_HEB_YR_LOWER_BOUND
+#define YEAR_TABLE_LAST    (HDATE_HEB_YR_UPPER_BOUND + 1)
+#define YEAR_TABLE_SIZE    (YEAR_TABLE_LAST - YEAR_TABLE_FIRST + 1)
+#define YEAR_JD_BITS       21
+#define YEAR_JD_MASK       ((1u << YEAR_JD_BITS) - 1)
+#define YEAR_SIZE_SHIFT    21
+#define YEAR_TYPE_SHIFT    24
+#define YEAR_FILLED        (1u << 31)
+#define JD_OF_3744         1715119
+
+static unsigned int year_table[YEAR_TABLE_SIZE];
+
+/**
+ @brief Look up (and if need be, fill) the year table entry for a year
+
+ @param hebrew_year The Hebrew year
+ @return the packed entry, or 0 if the year is outside the table
+*/
+static unsigned int
+year_table_entry (int hebrew_year)
+{
+	unsigned int entry;
+	int days, size_of_year, size_class;
+
+	if (hebrew_year < YEAR_TABLE_FIRST || hebrew_year > YEAR_TABLE_LAST)
+		return 0;
+
+	entry = __atomic_load_n (&year_table[hebrew_year - YEAR_TABLE_FIRST], __ATOMIC_RELAXED);
+	if (entry) return entry;
+
+	days = days_from_3744_molad (hebrew_year);
+	size_of_year = days_from_3744_molad (hebrew_year + 1) - days;
+	size_class = (size_of_year > 355) ? size_of_year - 380 : size_of_year - 353;
+
+	entry = YEAR_FILLED
+		| ((unsigned int) (days + JD_OF_3744 - HDATE_JUL_DY_LOWER_BOUND) & YEAR_JD_MASK)
+		| ((unsigned int) size_class << YEAR_SIZE_SHIFT)
+		| ((unsigned int) hdate_get_year_type (size_of_year, (days + JD_OF_3744 + 1) % 7 + 1)
+			<< YEAR_TYPE_SHIFT);
+	__atomic_store_n (&year_table[hebrew_year - YEAR_TABLE_FIRST], entry, __ATOMIC_RELAXED);
+
+	return entry;
+}
+
+/**
+ @brief Tishrey 1 JDN, length and type of a Hebrew year
+
+ Uses the year table within HDATE_HEB_YR_LOWER_BOUND..HDATE_HEB_YR_UPPER_BOUND,
+ and the molad arithmetic outside it.
+
+ @param hebrew_year The Hebrew year
+ @param jd_tishrey1 return the julian number of 1 Tishrey this year
+ @param size_of_year return the length of the year in days
+ @return the year type (1..14)
+*/
+int
+hdate_get_year_info (int hebrew_year, int *jd_tishrey1, int *size_of_year)
+{
+	unsigned int entry;
+	int size_class;
+	int days;
+
+	entry = year_table_entry (hebrew_year);
+	if (entry)
+	{
+		size_class = (entry >> YEAR_SIZE_SHIFT) & 7;
+		*jd_tishrey1 = (int) (entry & YEAR_JD_MASK) + HDATE_JUL_DY_LOWER_BOUND;
+		*size_of_year = (size_class > 2) ? size_class + 380 : size_class + 353;
+		return (entry >> YEAR_TYPE_SHIFT) & 15;
+	}
+
+	days = days_from_3744_molad (hebrew_year);
+	*jd_tishrey1 = days + JD_OF_3744;
+	*size_of_year = days_from_3744_molad (hebrew_year + 1) - days;
+	return hdate_get_year_type (*size_of_year, (*jd_tishrey1 + 1) % 7 + 1);
+}
+
+/**
+ @brief Days since bet (?) Tishrey 3744
+ 
+ @author Amos Shapir 1984 (rev. 1985, 1992) Yaacov Zamir 2003-2005 
+ 
+ @param hebrew_year The Hebrew year
+ @return Number of days since 3,1,3744
+*/
+int
+hdate_days_from_3744 (int hebrew_year)
+{
+	unsigned int entry;
+
+	entry = year_table_entry (hebrew_year);
+	if (entry)
+		return (int) (entry & YEAR_JD_MASK) + HDATE_JUL_DY_LOWER_BOUND - JD_OF_3744;
+
+	return days_from_3744_molad (hebrew_year);
+}
+
 /**
  @brief Size of Hebrew year in days
  
@@ -96,8 +203,11 @@ hdate_days_from_3744 (int hebrew_year)
 int
 hdate_get_size_of_hebrew_year (int hebrew_year)
 {
-	return hdate_days_from_3744 (hebrew_year + 1) -
-		hdate_days_from_3744 (hebrew_year);
+	int jd_tishrey1, size_of_year;
+
+	hdate_get_year_info (hebrew_year, &jd_tishrey1, &size_of_year);
+
+	return size_of_year;
 }
 
 /**
@@ -188,6 +298,7 @@ hdate_hdate_to_jd (int day, int month, int year, int *jd_tishrey1, int *jd_tishr
 	int length_of_year;
 	int jd;
 	int days_from_3744;
+	int internal_jd_tishrey1;
 
 	/* Adjust for leap year */
 	if (month == 13)
@@ -200,12 +311,10 @@ hdate_hdate_to_jd (int day, int month, int year, int *jd_tishrey1, int *jd_tishr
 		day += 30;
 	}
 
-	/* Calculate days since 1,1,3744 */
-	days_from_3744 = hdate_days_from_3744 (year);
+	/* Calculate days since 1,1,3744, and length of year */
+	hdate_get_year_info (year, &internal_jd_tishrey1, &length_of_year);
+	days_from_3744 = internal_jd_tishrey1 - JD_OF_3744;
 	day = days_from_3744 + (59 * (month - 1) + 1) / 2 + day;
-
-	/* length of year */
-	length_of_year = hdate_days_from_3744 (year + 1) - days_from_3744;
 	
 	/* Special cases for this year */
 	if (length_of_year % 10 > 4 && month > 2)	/* long Heshvan */
@@ -221,8 +330,8 @@ hdate_hdate_to_jd (int day, int month, int year, int *jd_tishrey1, int *jd_tishr
 	/* return the 1 of tishrey julians */
 	if (jd_tishrey1 && jd_tishrey1_next_year)
 	{
-		*jd_tishrey1 = days_from_3744 + 1715119;
-		*jd_tishrey1_next_year = *jd_tishrey1 + length_of_year;
+		*jd_tishrey1 = internal_jd_tishrey1;
+		*jd_tishrey1_next_year = internal_jd_tishrey1 + length_of_year;
 	}
 	
 	return jd;
@@ -258,44 +367,18 @@ hdate_jd_to_gdate (int jd, int *d, int *m, int *y)
 }
 
 /**
- @brief Converting from the Julian day to the Hebrew day
+ @brief Hebrew day and month from the days passed since 1 Tishrey
  
  @author Amos Shapir 1984 (rev. 1985, 1992) Yaacov Zamir 2003-2008
 
- @param jd Julian day
+ @param days days into this year, 1 Tishrey is 0
+ @param size_of_year length of this year in days
  @param day Return Day of month 1..31
  @param month Return Month 1..14 (13 - Adar 1, 14 - Adar 2)
- @param year Return Year in 4 digits e.g. 2001
  */
-void
-hdate_jd_to_hdate (int jd, int *day, int *month, int *year, int *jd_tishrey1, int *jd_tishrey1_next_year)
+static void
+days_to_hdate (int days, int size_of_year, int *day, int *month)
 {
-	int days;
-	int size_of_year;
-	int internal_jd_tishrey1, internal_jd_tishrey1_next_year;
-	
-	/* calculate Gregorian date */
-	hdate_jd_to_gdate (jd, day, month, year);
-
-	/* Guess Hebrew year is Gregorian year + 3760 */
-	*year = *year + 3760;
-
-	internal_jd_tishrey1 = hdate_days_from_3744 (*year) + 1715119;
-	internal_jd_tishrey1_next_year = hdate_days_from_3744 (*year + 1) + 1715119;
-	
-	/* Check if computed year was underestimated */
-	if (internal_jd_tishrey1_next_year <= jd)
-	{
-		*year = *year + 1;
-		internal_jd_tishrey1 = internal_jd_tishrey1_next_year;
-		internal_jd_tishrey1_next_year = hdate_days_from_3744 (*year + 1) + 1715119;
-	}
-
-	size_of_year = internal_jd_tishrey1_next_year - internal_jd_tishrey1;
-	
-	/* days into this year, first month 0..29 */
-	days = jd - internal_jd_tishrey1;
-	
 	/* last 8 months allways have 236 days */
 	if (days >= (size_of_year - 236)) /* in last 8 months */
 	{
@@ -336,11 +419,48 @@ hdate_jd_to_hdate (int jd, int *day, int *month, int *year, int *jd_tishrey1, in
 		*month = *month + 1;
 	}
 	
+	return;
+}
+
+/**
+ @brief Converting from the Julian day to the Hebrew day
+ 
+ @author Amos Shapir 1984 (rev. 1985, 1992) Yaacov Zamir 2003-2008
+
+ @param jd Julian day
+ @param day Return Day of month 1..31
+ @param month Return Month 1..14 (13 - Adar 1, 14 - Adar 2)
+ @param year Return Year in 4 digits e.g. 2001
+ */
+void
+hdate_jd_to_hdate (int jd, int *day, int *month, int *year, int *jd_tishrey1, int *jd_tishrey1_next_year)
+{
+	int size_of_year;
+	int internal_jd_tishrey1;
+	
+	/* calculate Gregorian date */
+	hdate_jd_to_gdate (jd, day, month, year);
+
+	/* Guess Hebrew year is Gregorian year + 3760 */
+	*year = *year + 3760;
+
+	hdate_get_year_info (*year, &internal_jd_tishrey1, &size_of_year);
+	
+	/* Check if computed year was underestimated */
+	if (internal_jd_tishrey1 + size_of_year <= jd)
+	{
+		*year = *year + 1;
+		hdate_get_year_info (*year, &internal_jd_tishrey1, &size_of_year);
+	}
+
+	/* days into this year, first month 0..29 */
+	days_to_hdate (jd - internal_jd_tishrey1, size_of_year, day, month);
+	
 	/* return the 1 of tishrey julians */
 	if (jd_tishrey1 && jd_tishrey1_next_year)
 	{
 		*jd_tishrey1 = internal_jd_tishrey1;
-		*jd_tishrey1_next_year = internal_jd_tishrey1_next_year;
+		*jd_tishrey1_next_year = internal_jd_tishrey1 + size_of_year;
 	}
 	
 	return;
@@ -349,6 +469,26 @@ hdate_jd_to_hdate (int jd, int *day, int *month, int *year, int *jd_tishrey1, in
 /********************************************************************************/
 /********************************************************************************/
 
+/**
+ @brief the julian day of the current local date
+
+ Uses localtime_r, so is safe to call from any thread.
+
+ @return the julian day number of today
+ */
+static int
+today_jd ()
+{
+	struct tm tm;
+	time_t t;
+
+	/* FIXME: day start at sunset or gregorian midnight? */
+	t = time (0);
+	if (localtime_r (&t, &tm) == NULL)
+		return hdate_time_to_jd (t, 0);
+	return hdate_gdate_to_jd (tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900);
+}
+
 /**
  @brief compute date structure from the Gregorian date
 
@@ -371,19 +511,8 @@ hdate_set_gdate (hdate_struct * h, int d, int m, int y)
 	if (!h) return NULL;
 	
 	/* check for null dates (kobi) */
-	if ((d == 0) || (m == 0) )
-	{
-		struct tm *tm;
-		long t;
-		/* FIXME: day start at sunset or gregorian midnight? */
-		t = time (0);
-		tm = localtime (&t);
-		d = tm->tm_mday;
-		m = tm->tm_mon + 1;
-		y = tm->tm_year + 1900;
-	}
-
-	jd = hdate_gdate_to_jd (d, m, y);
+	if ((d == 0) || (m == 0) ) jd = today_jd ();
+	else jd = hdate_gdate_to_jd (d, m, y);
 /*	BUGFIX (baruch)
 	1) There was no validation of input parms d, m, y, so if one passed
 	   to this function 29 2 2013 or 32 3 2012, the function would return
@@ -432,24 +561,62 @@ hdate_set_hdate (hdate_struct * h, int d, int m, int y)
 	
 	if (!h) return NULL;
 	
-	if ((d == 0) || (m == 0) )
-	{
-		struct tm *tm;
-		long t;
-		/* FIXME: day start at sunset or gregorian midnight? */
-		t = time (0);
-		tm = localtime (&t);
-		d = tm->tm_mday;
-		m = tm->tm_mon + 1;
-		y = tm->tm_year + 1900;
-		jd = hdate_gdate_to_jd (d, m, y);
-	}
+	if ((d == 0) || (m == 0) ) jd = today_jd ();
 	else jd = hdate_hdate_to_jd (d, m, y, &jd_tishrey1, &jd_tishrey1_next_year);
 	hdate_set_jd(h, jd);
 	
 	return (h);
 }
 
+/**
+ @brief the julian day of a moment, as a local date
+
+ Pure arithmetic; does not consult the time zone database or the
+ environment, so is safe and cheap to call from any thread.
+
+ @param t the moment, in seconds since the epoch
+ @param tz_offset the local offset from UTC in seconds, east positive
+ @return the julian day number of the local date of t
+ */
+int
+hdate_time_to_jd (time_t t, long tz_offset)
+{
+	long long seconds = (long long) t + tz_offset;
+	long long days = seconds / 86400;
+
+	/* round towards the past for moments before the epoch */
+	if (seconds % 86400 < 0) days--;
+
+	return (int) (days + 2440588);
+}
+
+/**
+ @brief compute date structure from a moment in time
+
+ @param t the moment, in seconds since the epoch
+ @param tz_offset the local offset from UTC in seconds, east positive
+ */
+hdate_struct *
+hdate_set_time (hdate_struct * h, time_t t, long tz_offset)
+{
+	if (!h) return NULL;
+
+	return hdate_set_jd (h, hdate_time_to_jd (t, tz_offset));
+}
+
+/**
+ @brief compute date structure for the current local date
+
+ Uses localtime_r, so is safe to call from any thread.
+ */
+hdate_struct *
+hdate_set_today (hdate_struct * h)
+{
+	if (!h) return NULL;
+
+	return hdate_set_jd (h, today_jd ());
+}
+
 /**
  @brief compute date structure from julian day
 
@@ -458,25 +625,280 @@ hdate_set_hdate (hdate_struct * h, int d, int m, int y)
 hdate_struct *
 hdate_set_jd (hdate_struct * h, int jd)
 {
-	int jd_tishrey1, jd_tishrey1_next_year;
+	return hdate_set_jd_fields (h, jd, HDATE_FIELD_ALL);
+}
+
+/**
+ @brief compute some fields of the date structure from julian day
+
+ Fields not asked for are set to HDATE_FIELD_UNSET; hd_jd is always set.
+
+ @param jd the julian day number.
+ @param fields bitwise or of HDATE_FIELD_* values
+ */
+hdate_struct *
+hdate_set_jd_fields (hdate_struct * h, int jd, int fields)
+{
+	int jd_tishrey1;
+	int day, month, year;
+	int size_of_year, year_type;
 	
 	if (!h) return NULL;
 	
-	hdate_jd_to_gdate (jd, &(h->gd_day), &(h->gd_mon), &(h->gd_year));
-	hdate_jd_to_hdate (jd, &(h->hd_day), &(h->hd_mon), &(h->hd_year), &jd_tishrey1, &jd_tishrey1_next_year);
+	h->hd_jd = jd;
+	
+	/* the Gregorian year is needed anyway, to guess the Hebrew year */
+	hdate_jd_to_gdate (jd, &day, &month, &year);
+	if (fields & HDATE_FIELD_GDATE)
+	{
+		h->gd_day = day;
+		h->gd_mon = month;
+		h->gd_year = year;
+	}
+	else
+		h->gd_day = h->gd_mon = h->gd_year = HDATE_FIELD_UNSET;
+	
+	if (fields & HDATE_FIELD_DW)
+		h->hd_dw = (jd + 1) % 7 + 1;
+	else
+		h->hd_dw = HDATE_FIELD_UNSET;
+	
+	h->hd_day = h->hd_mon = h->hd_year = HDATE_FIELD_UNSET;
+	h->hd_size_of_year = h->hd_new_year_dw = h->hd_year_type = HDATE_FIELD_UNSET;
+	h->hd_days = h->hd_weeks = HDATE_FIELD_UNSET;
+	
+	/* the rest all start from the Hebrew date */
+	if (!(fields & (HDATE_FIELD_HDATE | HDATE_FIELD_YEAR | HDATE_FIELD_DAYS)))
+		return (h);
+	
+	/* Guess Hebrew year is Gregorian year + 3760 */
+	year = year + 3760;
+	year_type = hdate_get_year_info (year, &jd_tishrey1, &size_of_year);
+	if (jd_tishrey1 + size_of_year <= jd)
+	{
+		year++;
+		year_type = hdate_get_year_info (year, &jd_tishrey1, &size_of_year);
+	}
+	
+	if (fields & HDATE_FIELD_HDATE)
+	{
+		days_to_hdate (jd - jd_tishrey1, size_of_year, &day, &month);
+		h->hd_day = day;
+		h->hd_mon = month;
+		h->hd_year = year;
+	}
+	
+	if (fields & HDATE_FIELD_YEAR)
+	{
+		h->hd_size_of_year = size_of_year;
+		h->hd_new_year_dw = (jd_tishrey1 + 1) % 7 + 1;
+		h->hd_year_type = year_type;
+	}
+	
+	if (fields & HDATE_FIELD_DAYS)
+	{
+		h->hd_days = jd - jd_tishrey1 + 1;
+		h->hd_weeks = ((h->hd_days - 1) + ((jd_tishrey1 + 1) % 7)) / 7 + 1;
+	}
+	
+	return (h);
+}
+
+/**
+ @brief move the date structure by a number of days
+
+ Within the Hebrew year of the date the fields are updated in place:
+ a step of one day rolls the day and month over by the month lengths,
+ a longer step decodes the days since 1 Tishrey from the known year
+ length. Crossing 1 Tishrey, or starting from a struct with unset
+ fields, falls back to hdate_set_jd.
+
+ @param h pointer this hdate struct, as hdate_set_jd leaves it.
+ @param ndays the number of days to move, negative for the past
+ */
+hdate_struct *
+hdate_advance (hdate_struct * h, int ndays)
+{
+	int jd, days, length;
+	
+	if (!h) return NULL;
+	
+	jd = h->hd_jd + ndays;
+	days = h->hd_days - 1 + ndays;	/* days into this year, 1 Tishrey is 0 */
+	
+	if (h->hd_days == HDATE_FIELD_UNSET || h->hd_size_of_year == HDATE_FIELD_UNSET
+	    || h->hd_day == HDATE_FIELD_UNSET || h->gd_day == HDATE_FIELD_UNSET
+	    || h->hd_dw == HDATE_FIELD_UNSET
+	    || days < 0 || days >= h->hd_size_of_year)
+		return hdate_set_jd (h, jd);
+	
+	if (ndays == 1)
+	{
+		length = hdate_get_size_of_gregorian_month (h->gd_mon, h->gd_year);
+		if (length == -1) return hdate_set_jd (h, jd);
+		if (h->gd_day < length)
+			h->gd_day++;
+		else
+		{
+			h->gd_day = 1;
+			if (h->gd_mon < 12)
+				h->gd_mon++;
+			else
+			{
+				h->gd_mon = 1;
+				h->gd_year++;
+			}
+		}
+		
+		length = hdate_get_size_of_hebrew_month (h->hd_mon, h->hd_year_type);
+		if (length == -1) return hdate_set_jd (h, jd);
+		if (h->hd_day < length)
+			h->hd_day++;
+		else
+		{
+			h->hd_day = 1;
+			/* Shvat is followed by Adar, or by Adar 1 in a leap year */
+			if (h->hd_mon == 5 && h->hd_size_of_year > 355)
+				h->hd_mon = 13;
+			else if (h->hd_mon == 14)
+				h->hd_mon = 7;
+			else
+				h->hd_mon++;
+		}
+		
+		h->hd_dw = (h->hd_dw < 7) ? h->hd_dw + 1 : 1;
+	}
+	else if (ndays == -1)
+	{
+		if (h->gd_day > 1)
+			h->gd_day--;
+		else
+		{
+			if (h->gd_mon > 1)
+				h->gd_mon--;
+			else
+			{
+				h->gd_mon = 12;
+				h->gd_year--;
+			}
+			h->gd_day = hdate_get_size_of_gregorian_month (h->gd_mon, h->gd_year);
+			if (h->gd_day == -1) return hdate_set_jd (h, jd);
+		}
+		
+		if (h->hd_day > 1)
+			h->hd_day--;
+		else
+		{
+			/* Nisan follows Adar, or Adar 2 in a leap year */
+			if (h->hd_mon == 7 && h->hd_size_of_year > 355)
+				h->hd_mon = 14;
+			else if (h->hd_mon == 13)
+				h->hd_mon = 5;
+			else
+				h->hd_mon--;
+			h->hd_day = hdate_get_size_of_hebrew_month (h->hd_mon, h->hd_year_type);
+			if (h->hd_day == -1) return hdate_set_jd (h, jd);
+		}
+		
+		h->hd_dw = (h->hd_dw > 1) ? h->hd_dw - 1 : 7;
+	}
+	else
+	{
+		hdate_jd_to_gdate (jd, &(h->gd_day), &(h->gd_mon), &(h->gd_year));
+		days_to_hdate (days, h->hd_size_of_year, &(h->hd_day), &(h->hd_mon));
+		h->hd_dw = (jd + 1) % 7 + 1;
+	}
 	
-	h->hd_dw = (jd + 1) % 7 + 1;
-	h->hd_size_of_year = jd_tishrey1_next_year - jd_tishrey1;
-	h->hd_new_year_dw = (jd_tishrey1 + 1) % 7 + 1;
-	h->hd_year_type = hdate_get_year_type (h->hd_size_of_year , h->hd_new_year_dw);
 	h->hd_jd = jd;
-	h->hd_days = jd - jd_tishrey1 + 1;
+	h->hd_days = days + 1;
 	h->hd_weeks = ((h->hd_days - 1) + (h->hd_new_year_dw - 1)) / 7 + 1;
 	
 	return (h);
 }
 
+/**
+ @brief compute dates for an array of julian days
+
+ Output is one array per field. Any output array may be NULL, except
+ that the three Gregorian arrays are filled together, or not at all.
+
+ The Gregorian dates come from hdate_jd_to_gdate_array, and the day
+ of week loop is plain arithmetic the compiler can vectorize. The
+ Hebrew loop remembers the year
+ it last looked up, so a run of dates within one year needs a single
+ year lookup.
+
+ @param jd array of julian day numbers.
+ @param count number of entries in jd and in each output array.
+ @param hd_day return the Hebrew day of month 1..30
+ @param hd_mon return the Hebrew month 1..14
+ @param hd_year return the Hebrew year
+ @param gd_day return the Gregorian day of month 1..31
+ @param gd_mon return the Gregorian month 1..12
+ @param gd_year return the Gregorian year
+ @param dw return the day of the week 1..7
+ @param year_type return the Hebrew year type 1..14
+ @return the number of dates converted
+ */
+int
+hdate_set_jd_array (int const *jd, int count,
+	int *hd_day, int *hd_mon, int *hd_year,
+	int *gd_day, int *gd_mon, int *gd_year,
+	int *dw, int *year_type)
+{
+	int i;
+	int jd_tishrey1 = 0;
+	int size_of_year = 0;
+	int type = 0;
+	int year = 0;
+	int day, month, g;
+	int gdate_filled = gd_day && gd_mon && gd_year;
+
+	if (!jd || count <= 0) return 0;
+
+	if (gdate_filled)
+		hdate_jd_to_gdate_array (jd, gd_day, gd_mon, gd_year, count);
+
+	if (dw)
+	{
+		for (i = 0; i < count; i++)
+			dw[i] = (jd[i] + 1) % 7 + 1;
+	}
+
+	if (!hd_day && !hd_mon && !hd_year && !year_type) return count;
+
+	for (i = 0; i < count; i++)
+	{
+		/* look up the year only when leaving the last one */
+		if (jd[i] < jd_tishrey1 || jd[i] >= jd_tishrey1 + size_of_year)
+		{
+			if (gdate_filled) g = gd_year[i];
+			else hdate_jd_to_gdate (jd[i], &day, &month, &g);
+
+			/* Guess Hebrew year is Gregorian year + 3760 */
+			year = g + 3760;
+			type = hdate_get_year_info (year, &jd_tishrey1, &size_of_year);
+			if (jd_tishrey1 + size_of_year <= jd[i])
+			{
+				year++;
+				type = hdate_get_year_info (year, &jd_tishrey1, &size_of_year);
+			}
+		}
+
+		days_to_hdate (jd[i] - jd_tishrey1, size_of_year, &day, &month);
+		if (hd_day) hd_day[i] = day;
+		if (hd_mon) hd_mon[i] = month;
+		if (hd_year) hd_year[i] = year;
+		if (year_type) year_type[i] = type;
+	}
+
+	return count;
+}
+
 /********************************************************************************/
+/* The accessors below compute a field left unset by hdate_set_jd_fields
+ * from hd_jd, without changing the struct.
+ */
 /********************************************************************************/
 
 /**
@@ -488,7 +910,10 @@ hdate_set_jd (hdate_struct * h, int jd)
 int
 hdate_get_gday (hdate_struct const * h)
 {
-	return h->gd_day;
+	hdate_struct on_demand;
+	
+	if (h->gd_day != HDATE_FIELD_UNSET) return h->gd_day;
+	return hdate_set_jd_fields (&on_demand, h->hd_jd, HDATE_FIELD_GDATE)->gd_day;
 }
 
 /**
@@ -500,7 +925,10 @@ hdate_get_gday (hdate_struct const * h)
 int
 hdate_get_gmonth (hdate_struct const * h)
 {
-	return h->gd_mon;
+	hdate_struct on_demand;
+	
+	if (h->gd_mon != HDATE_FIELD_UNSET) return h->gd_mon;
+	return hdate_set_jd_fields (&on_demand, h->hd_jd, HDATE_FIELD_GDATE)->gd_mon;
 }
 
 /**
@@ -512,7 +940,10 @@ hdate_get_gmonth (hdate_struct const * h)
 int
 hdate_get_gyear (hdate_struct const * h)
 {
-	return h->gd_year;
+	hdate_struct on_demand;
+	
+	if (h->gd_year != HDATE_FIELD_UNSET) return h->gd_year;
+	return hdate_set_jd_fields (&on_demand, h->hd_jd, HDATE_FIELD_GDATE)->gd_year;
 }
 
 /**
@@ -524,7 +955,10 @@ hdate_get_gyear (hdate_struct const * h)
 int
 hdate_get_hday (hdate_struct const * h)
 {
-	return h->hd_day;
+	hdate_struct on_demand;
+	
+	if (h->hd_day != HDATE_FIELD_UNSET) return h->hd_day;
+	return hdate_set_jd_fields (&on_demand, h->hd_jd, HDATE_FIELD_HDATE)->hd_day;
 }
 
 /**
@@ -536,7 +970,10 @@ hdate_get_hday (hdate_struct const * h)
 int
 hdate_get_hmonth (hdate_struct const * h)
 {
-	return h->hd_mon;
+	hdate_struct on_demand;
+	
+	if (h->hd_mon != HDATE_FIELD_UNSET) return h->hd_mon;
+	return hdate_set_jd_fields (&on_demand, h->hd_jd, HDATE_FIELD_HDATE)->hd_mon;
 }
 
 /**
@@ -548,7 +985,10 @@ hdate_get_hmonth (hdate_struct const * h)
 int
 hdate_get_hyear (hdate_struct const * h)
 {
-	return h->hd_year;
+	hdate_struct on_demand;
+	
+	if (h->hd_year != HDATE_FIELD_UNSET) return h->hd_year;
+	return hdate_set_jd_fields (&on_demand, h->hd_jd, HDATE_FIELD_HDATE)->hd_year;
 }
 
 /**
@@ -560,7 +1000,10 @@ hdate_get_hyear (hdate_struct const * h)
 int
 hdate_get_day_of_the_week (hdate_struct const * h)
 {
-	return h->hd_dw;
+	hdate_struct on_demand;
+	
+	if (h->hd_dw != HDATE_FIELD_UNSET) return h->hd_dw;
+	return hdate_set_jd_fields (&on_demand, h->hd_jd, HDATE_FIELD_DW)->hd_dw;
 }
 
 /**
@@ -572,7 +1015,10 @@ hdate_get_day_of_the_week (hdate_struct const * h)
 int
 hdate_get_size_of_year (hdate_struct const * h)
 {
-	return h->hd_size_of_year;
+	hdate_struct on_demand;
+	
+	if (h->hd_size_of_year != HDATE_FIELD_UNSET) return h->hd_size_of_year;
+	return hdate_set_jd_fields (&on_demand, h->hd_jd, HDATE_FIELD_YEAR)->hd_size_of_year;
 }
 
 /**
@@ -584,7 +1030,10 @@ hdate_get_size_of_year (hdate_struct const * h)
 int
 hdate_get_new_year_day_of_the_week (hdate_struct const * h)
 {
-	return h->hd_new_year_dw;
+	hdate_struct on_demand;
+	
+	if (h->hd_new_year_dw != HDATE_FIELD_UNSET) return h->hd_new_year_dw;
+	return hdate_set_jd_fields (&on_demand, h->hd_jd, HDATE_FIELD_YEAR)->hd_new_year_dw;
 }
 
 /**
@@ -608,7 +1057,10 @@ hdate_get_julian (hdate_struct const * h)
 int
 hdate_get_days (hdate_struct const * h)
 {
-	return h->hd_days;
+	hdate_struct on_demand;
+	
+	if (h->hd_days != HDATE_FIELD_UNSET) return h->hd_days;
+	return hdate_set_jd_fields (&on_demand, h->hd_jd, HDATE_FIELD_DAYS)->hd_days;
 }
 
 /**
@@ -620,7 +1072,10 @@ hdate_get_days (hdate_struct const * h)
 int
 hdate_get_weeks (hdate_struct const * h)
 {
-	return h->hd_weeks;
+	hdate_struct on_demand;
+	
+	if (h->hd_weeks != HDATE_FIELD_UNSET) return h->hd_weeks;
+	return hdate_set_jd_fields (&on_demand, h->hd_jd, HDATE_FIELD_DAYS)->hd_weeks;
 }
 
 /********************************************************************************/
@@ -0,0 +1,365 @@
+/*  libhdate - Hebrew calendar library
+ *
+ *  Copyright (C) 1984-2003 Amos Shapir, 2004-2007  Yaacov Zamir <kzamir@walla.co.il>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Array versions of hdate_gdate_to_jd and hdate_jd_to_gdate.
+ *
+ * On x86 the arrays are processed 4 (SSE2) or 8 (AVX2) dates at a time,
+ * the choice being made at run time; the kernels carry their own target
+ * attributes, so the file also builds for i386 without -msse2 and then
+ * falls back to the scalar code on a CPU that lacks it. Divisions by
+ * constants are done as a multiply by a "magic" reciprocal followed by a
+ * shift; each magic number is exact only for the range of values noted
+ * next to it, so a vector of dates that strays outside those ranges is
+ * handed to the scalar functions instead. Any other machine uses the
+ * scalar functions.
+ */
+
+#include "hdate.h"
+#include "support.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HDATE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/** inputs accepted by the vector code; beyond these the magic numbers
+ ** below are no longer exact **/
+#define SIMD_JD_MIN     0
+#define SIMD_JD_MAX     9999999
+#define SIMD_YEAR_MIN   -4799
+#define SIMD_YEAR_MAX   1000000
+
+/** magic reciprocals: x / d == (x * magic) >> (32 + shift) */
+#define DIV_146097_MAGIC  0x00e5ac1bu	/* x < 41,000,000 */
+#define DIV_146097_SHIFT  9
+#define DIV_1461001_MAGIC 0x05bddf17u	/* x < 600,000,000 */
+#define DIV_1461001_SHIFT 15
+#define DIV_2447_MAGIC    0x001ac83eu	/* x < 40,000 */
+#define DIV_80_MAGIC      0x03333334u	/* x < 40,000 */
+#define DIV_11_MAGIC      0x1745d175u	/* x < 1,000 */
+#define DIV_5_MAGIC       0x33333334u	/* x < 2,000 */
+#define DIV_100_MAGIC     0x028f5c29u	/* x < 2,097,152 */
+#define DIV_400_MAGIC     0x00a3d70bu	/* x < 2,097,152 */
+
+#ifdef HDATE_X86_SIMD
+
+/**
+ @brief low 32 bits of a * c, four lanes (SSE2 has no pmulld)
+*/
+__attribute__ ((target ("sse2")))
+static inline __m128i
+mullo_sse2 (__m128i a, int c)
+{
+	__m128i b = _mm_set1_epi32 (c);
+	__m128i even = _mm_mul_epu32 (a, b);
+	__m128i odd = _mm_mul_epu32 (_mm_srli_epi64 (a, 32), b);
+
+	return _mm_unpacklo_epi32 (_mm_shuffle_epi32 (even, _MM_SHUFFLE (0, 0, 2, 0)),
+							   _mm_shuffle_epi32 (odd, _MM_SHUFFLE (0, 0, 2, 0)));
+}
+
+/**
+ @brief unsigned x / d by magic reciprocal, four lanes
+*/
+__attribute__ ((target ("sse2")))
+static inline __m128i
+div_sse2 (__m128i x, unsigned int magic, int shift)
+{
+	__m128i m = _mm_set1_epi32 ((int) magic);
+	__m128i even = _mm_srli_epi64 (_mm_mul_epu32 (x, m), 32);
+	__m128i odd = _mm_mul_epu32 (_mm_srli_epi64 (x, 32), m);
+	__m128i hi = _mm_or_si128 (even, _mm_and_si128 (odd, _mm_set_epi32 (-1, 0, -1, 0)));
+
+	return _mm_srli_epi32 (hi, shift);
+}
+
+/**
+ @brief true if any lane of x is outside lo..hi
+*/
+__attribute__ ((target ("sse2")))
+static inline int
+out_of_range_sse2 (__m128i x, int lo, int hi)
+{
+	__m128i bad = _mm_or_si128 (_mm_cmplt_epi32 (x, _mm_set1_epi32 (lo)),
+								_mm_cmpgt_epi32 (x, _mm_set1_epi32 (hi)));
+
+	return _mm_movemask_epi8 (bad);
+}
+
+/**
+ @brief Fliegel - Van Flandern, julian day to gregorian, four dates
+ @return FALSE if the dates were out of range and nothing was written
+*/
+__attribute__ ((target ("sse2")))
+static int
+jd_to_gdate_sse2 (int const *jd, int *d, int *m, int *y)
+{
+	__m128i l, n, i, j, t;
+
+	l = _mm_loadu_si128 ((__m128i const *) jd);
+	if (out_of_range_sse2 (l, SIMD_JD_MIN, SIMD_JD_MAX)) return FALSE;
+
+	l = _mm_add_epi32 (l, _mm_set1_epi32 (68569));
+	n = div_sse2 (_mm_slli_epi32 (l, 2), DIV_146097_MAGIC, DIV_146097_SHIFT);
+	t = _mm_add_epi32 (mullo_sse2 (n, 146097), _mm_set1_epi32 (3));
+	l = _mm_sub_epi32 (l, _mm_srli_epi32 (t, 2));
+	t = mullo_sse2 (_mm_add_epi32 (l, _mm_set1_epi32 (1)), 4000);
+	i = div_sse2 (t, DIV_1461001_MAGIC, DIV_1461001_SHIFT);
+	l = _mm_sub_epi32 (l, _mm_srli_epi32 (mullo_sse2 (i, 1461), 2));
+	l = _mm_add_epi32 (l, _mm_set1_epi32 (31));
+	j = div_sse2 (mullo_sse2 (l, 80), DIV_2447_MAGIC, 0);
+	t = div_sse2 (mullo_sse2 (j, 2447), DIV_80_MAGIC, 0);
+	_mm_storeu_si128 ((__m128i *) d, _mm_sub_epi32 (l, t));
+	l = div_sse2 (j, DIV_11_MAGIC, 0);
+	t = _mm_sub_epi32 (_mm_add_epi32 (j, _mm_set1_epi32 (2)), mullo_sse2 (l, 12));
+	_mm_storeu_si128 ((__m128i *) m, t);
+	t = mullo_sse2 (_mm_sub_epi32 (n, _mm_set1_epi32 (49)), 100);
+	_mm_storeu_si128 ((__m128i *) y, _mm_add_epi32 (_mm_add_epi32 (t, i), l));
+
+	return TRUE;
+}
+
+/**
+ @brief wikipedia's gregorian to julian day, four dates
+ @return FALSE if the dates were out of range and nothing was written
+*/
+__attribute__ ((target ("sse2")))
+static int
+gdate_to_jd_sse2 (int const *day, int const *month, int const *year, int *jd)
+{
+	__m128i d, m, y, a, t;
+
+	d = _mm_loadu_si128 ((__m128i const *) day);
+	m = _mm_loadu_si128 ((__m128i const *) month);
+	y = _mm_loadu_si128 ((__m128i const *) year);
+	if (out_of_range_sse2 (m, 1, 12) || out_of_range_sse2 (y, SIMD_YEAR_MIN, SIMD_YEAR_MAX))
+		return FALSE;
+
+	/* a = (14 - month) / 12, which is 1 for jan and feb, 0 otherwise */
+	a = _mm_srli_epi32 (_mm_cmplt_epi32 (m, _mm_set1_epi32 (3)), 31);
+	y = _mm_sub_epi32 (_mm_add_epi32 (y, _mm_set1_epi32 (4800)), a);
+	m = _mm_sub_epi32 (_mm_add_epi32 (m, mullo_sse2 (a, 12)), _mm_set1_epi32 (3));
+
+	t = _mm_add_epi32 (mullo_sse2 (m, 153), _mm_set1_epi32 (2));
+	d = _mm_add_epi32 (d, div_sse2 (t, DIV_5_MAGIC, 0));
+	d = _mm_add_epi32 (d, mullo_sse2 (y, 365));
+	d = _mm_add_epi32 (d, _mm_srli_epi32 (y, 2));
+	d = _mm_sub_epi32 (d, div_sse2 (y, DIV_100_MAGIC, 0));
+	d = _mm_add_epi32 (d, div_sse2 (y, DIV_400_MAGIC, 0));
+	_mm_storeu_si128 ((__m128i *) jd, _mm_sub_epi32 (d, _mm_set1_epi32 (32045)));
+
+	return TRUE;
+}
+
+/**
+ @brief unsigned x / d by magic reciprocal, eight lanes
+*/
+__attribute__ ((target ("avx2")))
+static inline __m256i
+div_avx2 (__m256i x, unsigned int magic, int shift)
+{
+	__m256i m = _mm256_set1_epi32 ((int) magic);
+	__m256i even = _mm256_srli_epi64 (_mm256_mul_epu32 (x, m), 32);
+	__m256i odd = _mm256_mul_epu32 (_mm256_srli_epi64 (x, 32), m);
+	__m256i hi = _mm256_blend_epi32 (even, odd, 0xaa);
+
+	return _mm256_srli_epi32 (hi, shift);
+}
+
+/**
+ @brief true if any lane of x is outside lo..hi
+*/
+__attribute__ ((target ("avx2")))
+static inline int
+out_of_range_avx2 (__m256i x, int lo, int hi)
+{
+	__m256i bad = _mm256_or_si256 (_mm256_cmpgt_epi32 (_mm256_set1_epi32 (lo), x),
+								   _mm256_cmpgt_epi32 (x, _mm256_set1_epi32 (hi)));
+
+	return _mm256_movemask_epi8 (bad);
+}
+
+/**
+ @brief Fliegel - Van Flandern, julian day to gregorian, eight dates
+ @return FALSE if the dates were out of range and nothing was written
+*/
+__attribute__ ((target ("avx2")))
+static int
+jd_to_gdate_avx2 (int const *jd, int *d, int *m, int *y)
+{
+	__m256i l, n, i, j, t;
+
+	l = _mm256_loadu_si256 ((__m256i const *) jd);
+	if (out_of_range_avx2 (l, SIMD_JD_MIN, SIMD_JD_MAX)) return FALSE;
+
+	l = _mm256_add_epi32 (l, _mm256_set1_epi32 (68569));
+	n = div_avx2 (_mm256_slli_epi32 (l, 2), DIV_146097_MAGIC, DIV_146097_SHIFT);
+	t = _mm256_add_epi32 (_mm256_mullo_epi32 (n, _mm256_set1_epi32 (146097)), _mm256_set1_epi32 (3));
+	l = _mm256_sub_epi32 (l, _mm256_srli_epi32 (t, 2));
+	t = _mm256_mullo_epi32 (_mm256_add_epi32 (l, _mm256_set1_epi32 (1)), _mm256_set1_epi32 (4000));
+	i = div_avx2 (t, DIV_1461001_MAGIC, DIV_1461001_SHIFT);
+	t = _mm256_srli_epi32 (_mm256_mullo_epi32 (i, _mm256_set1_epi32 (1461)), 2);
+	l = _mm256_add_epi32 (_mm256_sub_epi32 (l, t), _mm256_set1_epi32 (31));
+	j = div_avx2 (_mm256_mullo_epi32 (l, _mm256_set1_epi32 (80)), DIV_2447_MAGIC, 0);
+	t = div_avx2 (_mm256_mullo_epi32 (j, _mm256_set1_epi32 (2447)), DIV_80_MAGIC, 0);
+	_mm256_storeu_si256 ((__m256i *) d, _mm256_sub_epi32 (l, t));
+	l = div_avx2 (j, DIV_11_MAGIC, 0);
+	t = _mm256_sub_epi32 (_mm256_add_epi32 (j, _mm256_set1_epi32 (2)),
+						  _mm256_mullo_epi32 (l, _mm256_set1_epi32 (12)));
+	_mm256_storeu_si256 ((__m256i *) m, t);
+	t = _mm256_mullo_epi32 (_mm256_sub_epi32 (n, _mm256_set1_epi32 (49)), _mm256_set1_epi32 (100));
+	_mm256_storeu_si256 ((__m256i *) y, _mm256_add_epi32 (_mm256_add_epi32 (t, i), l));
+
+	return TRUE;
+}
+
+/**
+ @brief wikipedia's gregorian to julian day, eight dates
+ @return FALSE if the dates were out of range and nothing was written
+*/
+__attribute__ ((target ("avx2")))
+static int
+gdate_to_jd_avx2 (int const *day, int const *month, int const *year, int *jd)
+{
+	__m256i d, m, y, a, t;
+
+	d = _mm256_loadu_si256 ((__m256i const *) day);
+	m = _mm256_loadu_si256 ((__m256i const *) month);
+	y = _mm256_loadu_si256 ((__m256i const *) year);
+	if (out_of_range_avx2 (m, 1, 12) || out_of_range_avx2 (y, SIMD_YEAR_MIN, SIMD_YEAR_MAX))
+		return FALSE;
+
+	/* a = (14 - month) / 12, which is 1 for jan and feb, 0 otherwise */
+	a = _mm256_srli_epi32 (_mm256_cmpgt_epi32 (_mm256_set1_epi32 (3), m), 31);
+	y = _mm256_sub_epi32 (_mm256_add_epi32 (y, _mm256_set1_epi32 (4800)), a);
+	t = _mm256_mullo_epi32 (a, _mm256_set1_epi32 (12));
+	m = _mm256_sub_epi32 (_mm256_add_epi32 (m, t), _mm256_set1_epi32 (3));
+
+	t = _mm256_add_epi32 (_mm256_mullo_epi32 (m, _mm256_set1_epi32 (153)), _mm256_set1_epi32 (2));
+	d = _mm256_add_epi32 (d, div_avx2 (t, DIV_5_MAGIC, 0));
+	d = _mm256_add_epi32 (d, _mm256_mullo_epi32 (y, _mm256_set1_epi32 (365)));
+	d = _mm256_add_epi32 (d, _mm256_srli_epi32 (y, 2));
+	d = _mm256_sub_epi32 (d, div_avx2 (y, DIV_100_MAGIC, 0));
+	d = _mm256_add_epi32 (d, div_avx2 (y, DIV_400_MAGIC, 0));
+	_mm256_storeu_si256 ((__m256i *) jd, _mm256_sub_epi32 (d, _mm256_set1_epi32 (32045)));
+
+	return TRUE;
+}
+
+#endif /* HDATE_X86_SIMD */
+
+/**
+ @brief scalar fallback for a run of dates
+*/
+static void
+jd_to_gdate_scalar (int const *jd, int *day, int *month, int *year, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		hdate_jd_to_gdate (jd[i], &day[i], &month[i], &year[i]);
+}
+
+/**
+ @brief scalar fallback for a run of dates
+*/
+static void
+gdate_to_jd_scalar (int const *day, int const *month, int const *year, int *jd, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		jd[i] = hdate_gdate_to_jd (day[i], month[i], year[i]);
+}
+
+/**
+ @brief Converting an array of Julian days to Gregorian dates
+
+ Gives the same results as calling hdate_jd_to_gdate for each entry.
+
+ @param jd array of Julian days
+ @param day return Day of month 1..31
+ @param month return Month 1..12
+ @param year return Year in 4 digits e.g. 2001
+ @param count number of entries in each array
+ @return the number of dates converted
+ */
+int
+hdate_jd_to_gdate_array (int const *jd, int *day, int *month, int *year, int count)
+{
+	int i = 0;
+
+	if (!jd || !day || !month || !year || count <= 0) return 0;
+
+#ifdef HDATE_X86_SIMD
+	if (__builtin_cpu_supports ("avx2"))
+	{
+		for (; i + 8 <= count; i += 8)
+			if (!jd_to_gdate_avx2 (jd + i, day + i, month + i, year + i))
+				jd_to_gdate_scalar (jd + i, day + i, month + i, year + i, 8);
+	}
+	if (__builtin_cpu_supports ("sse2"))
+	{
+		for (; i + 4 <= count; i += 4)
+			if (!jd_to_gdate_sse2 (jd + i, day + i, month + i, year + i))
+				jd_to_gdate_scalar (jd + i, day + i, month + i, year + i, 4);
+	}
+#endif
+	jd_to_gdate_scalar (jd + i, day + i, month + i, year + i, count - i);
+
+	return count;
+}
+
+/**
+ @brief Compute an array of Julian days from Gregorian dates
+
+ Gives the same results as calling hdate_gdate_to_jd for each entry.
+
+ @param day Day of month 1..31
+ @param month Month 1..12
+ @param year Year in 4 digits e.g. 2001
+ @param jd return the julian day numbers
+ @param count number of entries in each array
+ @return the number of dates converted
+ */
+int
+hdate_gdate_to_jd_array (int const *day, int const *month, int const *year, int *jd, int count)
+{
+	int i = 0;
+
+	if (!day || !month || !year || !jd || count <= 0) return 0;
+
+#ifdef HDATE_X86_SIMD
+	if (__builtin_cpu_supports ("avx2"))
+	{
+		for (; i + 8 <= count; i += 8)
+			if (!gdate_to_jd_avx2 (day + i, month + i, year + i, jd + i))
+				gdate_to_jd_scalar (day + i, month + i, year + i, jd + i, 8);
+	}
+	if (__builtin_cpu_supports ("sse2"))
+	{
+		for (; i + 4 <= count; i += 4)
+			if (!gdate_to_jd_sse2 (day + i, month + i, year + i, jd + i))
+				gdate_to_jd_scalar (day + i, month + i, year + i, jd + i, 4);
+	}
+#endif
+	gdate_to_jd_scalar (day + i, month + i, year + i, jd + i, count - i);
+
+	return count;
+}
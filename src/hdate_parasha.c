@@ -19,6 +19,247 @@
 #include "hdate.h"
 #include "support.h"
 
+/** Number of Shabbat weeks a Hebrew year can have */
+#define HDATE_PARASHA_WEEKS 55
+
+/** Shabbat readings of each year type, as hdate_get_parasha gives them,
+ ** indexed by [diaspora][year type - 1][hd_weeks - 1]. 0 for a Shabbat
+ ** with a holiday reading, and after the last Shabbat of the year.
+ ** Generated by running hdate_get_parasha over a year of each type. **/
+static const int parasha_readings[2][14][HDATE_PARASHA_WEEKS] =
+{
+	{
+		{ /* 1 be erez israel */
+			52, 53,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 55, 24, 25,  0, 26, 56, 57, 31, 58,
+			34, 35, 36, 37, 38, 39, 40, 41, 60, 44, 45,
+			46, 47, 48, 49, 50, 61,  0,  0,  0,  0,  0
+		},
+		{ /* 2 */
+			 0, 53,  0, 54,  1,  2,  3,  4,  5,  6,  7,
+			 8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+			19, 20, 21, 55, 24, 25,  0, 26, 56, 57, 31,
+			58, 34, 35, 36, 37, 38, 39, 40, 41, 60, 44,
+			45, 46, 47, 48, 49, 50, 51,  0,  0,  0,  0
+		},
+		{ /* 3 */
+			52, 53,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 55, 24, 25,  0, 26, 56, 57, 31, 58,
+			34, 35, 36, 37, 38, 39, 40, 41, 60, 44, 45,
+			46, 47, 48, 49, 50, 61,  0,  0,  0,  0,  0
+		},
+		{ /* 4 */
+			53,  0,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 55, 24, 25,  0, 26, 56, 57, 31, 32,
+			33, 34, 35, 36, 37, 38, 39, 40, 41, 60, 44,
+			45, 46, 47, 48, 49, 50, 51,  0,  0,  0,  0
+		},
+		{ /* 5 */
+			52, 53,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 55, 24, 25,  0, 26, 56, 57, 31, 58,
+			34, 35, 36, 37, 38, 39, 40, 41, 60, 44, 45,
+			46, 47, 48, 49, 50, 61,  0,  0,  0,  0,  0
+		},
+		{ /* 6 */
+			53,  0,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 22, 23, 24, 25,  0, 26, 56, 57, 31,
+			58, 34, 35, 36, 37, 38, 39, 40, 41, 60, 44,
+			45, 46, 47, 48, 49, 50, 51,  0,  0,  0,  0
+		},
+		{ /* 7 */
+			 0, 53,  0, 54,  1,  2,  3,  4,  5,  6,  7,
+			 8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+			19, 20, 21, 55, 24, 25,  0, 26, 56, 57, 31,
+			58, 34, 35, 36, 37, 38, 39, 40, 41, 60, 44,
+			45, 46, 47, 48, 49, 50, 61,  0,  0,  0,  0
+		},
+		{ /* 8 */
+			52, 53,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 22, 23, 24, 25, 26, 27, 28,  0, 29,
+			30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+			41, 60, 44, 45, 46, 47, 48, 49, 50, 61,  0
+		},
+		{ /* 9 */
+			53,  0,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 22, 23, 24, 25, 26, 27, 28, 29,  0,
+			30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+			41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51
+		},
+		{ /* 10 */
+			 0, 53,  0, 54,  1,  2,  3,  4,  5,  6,  7,
+			 8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+			19, 20, 21, 22, 23, 24, 25, 26, 27, 28,  0,
+			29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39,
+			40, 41, 60, 44, 45, 46, 47, 48, 49, 50, 61
+		},
+		{ /* 11 */
+			52, 53,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 22, 23, 24, 25, 26, 27, 28,  0, 29,
+			30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+			41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51
+		},
+		{ /* 12 */
+			52, 53,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 22, 23, 24, 25, 26, 27, 28,  0, 29,
+			30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+			41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51
+		},
+		{ /* 13 */
+			53,  0,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 22, 23, 24, 25, 26, 27, 28, 29,  0,
+			30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+			41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 61
+		},
+		{ /* 14 */
+			 0, 53,  0, 54,  1,  2,  3,  4,  5,  6,  7,
+			 8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+			19, 20, 21, 22, 23, 24, 25, 26, 27, 28,  0,
+			29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39,
+			40, 41, 60, 44, 45, 46, 47, 48, 49, 50, 61
+		}
+	},
+	{
+		{ /* 1 in diaspora */
+			52, 53,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 55, 24, 25,  0, 26, 56, 57, 31, 58,
+			34, 35, 36, 37, 38, 39, 40, 41, 60, 44, 45,
+			46, 47, 48, 49, 50, 61,  0,  0,  0,  0,  0
+		},
+		{ /* 2 */
+			 0, 53,  0, 54,  1,  2,  3,  4,  5,  6,  7,
+			 8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+			19, 20, 21, 55, 24, 25,  0, 26, 56, 57, 31,
+			58, 34, 35, 36, 37, 38, 39, 40, 41, 60, 44,
+			45, 46, 47, 48, 49, 50, 51,  0,  0,  0,  0
+		},
+		{ /* 3 */
+			52, 53,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 55, 24, 25,  0, 26, 56, 57, 31, 58,
+			34,  0, 35, 36, 37, 38, 59, 41, 60, 44, 45,
+			46, 47, 48, 49, 50, 61,  0,  0,  0,  0,  0
+		},
+		{ /* 4 */
+			53,  0,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 55, 24, 25,  0,  0, 26, 56, 57, 31,
+			58, 34, 35, 36, 37, 38, 39, 40, 41, 60, 44,
+			45, 46, 47, 48, 49, 50, 51,  0,  0,  0,  0
+		},
+		{ /* 5 */
+			52, 53,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 55, 24, 25,  0, 26, 56, 57, 31, 58,
+			34,  0, 35, 36, 37, 38, 59, 41, 60, 44, 45,
+			46, 47, 48, 49, 50, 61,  0,  0,  0,  0,  0
+		},
+		{ /* 6 */
+			53,  0,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 22, 23, 24, 25,  0, 26, 56, 57, 31,
+			58, 34, 35, 36, 37, 38, 39, 40, 41, 60, 44,
+			45, 46, 47, 48, 49, 50, 51,  0,  0,  0,  0
+		},
+		{ /* 7 */
+			 0, 53,  0, 54,  1,  2,  3,  4,  5,  6,  7,
+			 8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+			19, 20, 21, 55, 24, 25,  0, 26, 56, 57, 31,
+			58, 34, 35, 36, 37, 38, 39, 40, 41, 60, 44,
+			45, 46, 47, 48, 49, 50, 61,  0,  0,  0,  0
+		},
+		{ /* 8 */
+			52, 53,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 22, 23, 24, 25, 26, 27, 28,  0, 29,
+			30, 31, 32, 33, 34,  0, 35, 36, 37, 38, 59,
+			41, 60, 44, 45, 46, 47, 48, 49, 50, 61,  0
+		},
+		{ /* 9 */
+			53,  0,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 22, 23, 24, 25, 26, 27, 28, 29,  0,
+			30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+			41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51
+		},
+		{ /* 10 */
+			 0, 53,  0, 54,  1,  2,  3,  4,  5,  6,  7,
+			 8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+			19, 20, 21, 22, 23, 24, 25, 26, 27, 28,  0,
+			29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39,
+			40, 41, 60, 44, 45, 46, 47, 48, 49, 50, 61
+		},
+		{ /* 11 */
+			52, 53,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 22, 23, 24, 25, 26, 27, 28,  0,  0,
+			29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39,
+			40, 41, 60, 44, 45, 46, 47, 48, 49, 50, 51
+		},
+		{ /* 12 */
+			52, 53,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 22, 23, 24, 25, 26, 27, 28,  0,  0,
+			29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39,
+			40, 41, 60, 44, 45, 46, 47, 48, 49, 50, 51
+		},
+		{ /* 13 */
+			53,  0,  0,  1,  2,  3,  4,  5,  6,  7,  8,
+			 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+			20, 21, 22, 23, 24, 25, 26, 27, 28, 29,  0,
+			30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+			41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 61
+		},
+		{ /* 14 */
+			 0, 53,  0, 54,  1,  2,  3,  4,  5,  6,  7,
+			 8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+			19, 20, 21, 22, 23, 24, 25, 26, 27, 28,  0,
+			29, 30, 31, 32, 33, 34,  0, 35, 36, 37, 38,
+			59, 41, 60, 44, 45, 46, 47, 48, 49, 50, 61
+		}
+	}
+};
+
+/**
+ @brief Shabbat reading from the year table
+
+ @param jd julian day number of a Shabbat
+ @param diaspora if True give diaspora readings
+ @param jd_tishrey1 julian day of 1 Tishrey of the year of jd
+ @param size_of_year length of the year of jd
+ @return the reading number, or 0
+*/
+static int
+shabbat_reading (int jd, int diaspora, int jd_tishrey1, int size_of_year)
+{
+	hdate_struct h;
+	int new_year_dw, year_type;
+
+	new_year_dw = (jd_tishrey1 + 1) % 7 + 1;
+	year_type = hdate_get_year_type (size_of_year, new_year_dw);
+
+	/* a year not in the table, before 3744: no valid type, or a new
+	   year on a day the table has no column for */
+	if (year_type == 0 ||
+		(new_year_dw != 2 && new_year_dw != 3 && new_year_dw != 5 && new_year_dw != 7))
+	{
+		return hdate_get_parasha (hdate_set_jd (&h, jd), diaspora);
+	}
+
+	return parasha_readings[diaspora ? 1 : 0][year_type - 1]
+		[(jd - jd_tishrey1 + new_year_dw - 1) / 7];
+}
+
 /**
  @brief Return number of hebrew parasha.
  
@@ -275,3 +516,201 @@ hdate_get_parasha (hdate_struct const * h, int diaspora)
 
 	return reading;
 }
+
+/**
+ @brief Return number of hebrew parasha of the week of a julian day.
+
+ @param jd the julian day number.
+ @param diaspora if True give diaspora readings
+ @return the number of parasha read on the Shabbat ending the week of
+	jd, or 0 if that Shabbat has a holiday reading.
+*/
+int
+hdate_get_parasha_for_week (int jd, int diaspora)
+{
+	int jd_tishrey1, size_of_year;
+	hdate_struct h;
+
+	/* the Shabbat on or after jd */
+	jd = jd + 6 - (jd + 1) % 7;
+
+	hdate_set_jd_fields (&h, jd, HDATE_FIELD_HDATE);
+	hdate_get_year_info (h.hd_year, &jd_tishrey1, &size_of_year);
+
+	return shabbat_reading (jd, diaspora, jd_tishrey1, size_of_year);
+}
+
+/**
+ @brief Find the days a parasha is read in a Hebrew year.
+
+ @param hebrew_year the Hebrew year
+ @param parasha the parasha number, as hdate_get_parasha returns it
+ @param diaspora if True give diaspora readings
+ @param jd return the julian days of the reading, may be NULL
+ @param size number of entries jd has room for
+ @return the number of days the parasha is read in the year, which may
+	be more than size (Vezot Habracha is read on Simhat Tora, two days
+	in diaspora, and the other readings at most once)
+*/
+int
+hdate_find_parasha (int hebrew_year, int parasha, int diaspora, int *jd, int size)
+{
+	hdate_parasha_iter it;
+	int jd_tishrey1, size_of_year, new_year_dw, year_type;
+	int week, day, reading;
+	int found = 0;
+
+	if (parasha < 1 || parasha > 61) return 0;
+
+	hdate_get_year_info (hebrew_year, &jd_tishrey1, &size_of_year);
+	new_year_dw = (jd_tishrey1 + 1) % 7 + 1;
+	year_type = hdate_get_year_type (size_of_year, new_year_dw);
+	diaspora = diaspora ? 1 : 0;
+
+	/* a year not in the table, before 3744: scan its Shabbatot */
+	if (year_type == 0 ||
+		(new_year_dw != 2 && new_year_dw != 3 && new_year_dw != 5 && new_year_dw != 7))
+	{
+		hdate_parasha_iter_hebrew_year (&it, hebrew_year, diaspora);
+		while (hdate_parasha_iter_next (&it, &day, &reading))
+		{
+			if (reading != parasha) continue;
+			if (jd && found < size) jd[found] = day;
+			found++;
+		}
+		return found;
+	}
+
+	/* Simhat tora, on any week day */
+	if (parasha == 54)
+	{
+		if (jd && size > 0) jd[0] = jd_tishrey1 + 21;
+		if (jd && size > 1 && diaspora) jd[1] = jd_tishrey1 + 22;
+		return 1 + diaspora;
+	}
+
+	for (week = 0; week < HDATE_PARASHA_WEEKS; week++)
+	{
+		if (parasha_readings[diaspora][year_type - 1][week] != parasha) continue;
+		if (jd && found < size) jd[found] = jd_tishrey1 + 7 * week + 7 - new_year_dw;
+		found++;
+	}
+
+	return found;
+}
+
+/**
+ @brief set a parasha iterator to the Hebrew year holding a julian day
+*/
+static void
+parasha_iter_load_year (hdate_parasha_iter *it, int hebrew_year)
+{
+	it->hd_year = hebrew_year;
+	hdate_get_year_info (hebrew_year, &it->jd_tishrey1, &it->size_of_year);
+}
+
+/**
+ @brief Start iterating over the parasha readings between two julian days.
+
+ @param it the iterator to set.
+ @param jd_start first julian day of the range
+ @param jd_end last julian day of the range
+ @param diaspora if True give diaspora readings
+*/
+void
+hdate_parasha_iter_init (hdate_parasha_iter *it, int jd_start, int jd_end, int diaspora)
+{
+	hdate_struct h;
+
+	it->jd = jd_start;
+	it->jd_end = jd_end;
+	it->diaspora = diaspora ? 1 : 0;
+
+	hdate_set_jd_fields (&h, jd_start, HDATE_FIELD_HDATE);
+	parasha_iter_load_year (it, h.hd_year);
+}
+
+/**
+ @brief Start iterating over the parasha readings of a Hebrew year.
+
+ @param it the iterator to set.
+ @param hebrew_year the Hebrew year
+ @param diaspora if True give diaspora readings
+*/
+void
+hdate_parasha_iter_hebrew_year (hdate_parasha_iter *it, int hebrew_year, int diaspora)
+{
+	parasha_iter_load_year (it, hebrew_year);
+	it->jd = it->jd_tishrey1;
+	it->jd_end = it->jd_tishrey1 + it->size_of_year - 1;
+	it->diaspora = diaspora ? 1 : 0;
+}
+
+/**
+ @brief Start iterating over the parasha readings of a Gregorian year.
+
+ @param it the iterator to set.
+ @param year the Gregorian year
+ @param diaspora if True give diaspora readings
+*/
+void
+hdate_parasha_iter_gregorian_year (hdate_parasha_iter *it, int year, int diaspora)
+{
+	hdate_parasha_iter_init (it, hdate_gdate_to_jd (1, 1, year),
+		hdate_gdate_to_jd (31, 12, year), diaspora);
+}
+
+/**
+ @brief Get the next parasha reading of an iterator.
+
+ Gives every day for which hdate_get_parasha is not 0: each Shabbat
+ with a weekly reading, and the Simhat Tora readings of Vezot Habracha.
+
+ @param it the iterator.
+ @param jd return the julian day of the reading
+ @param parasha return the number of the parasha
+ @return TRUE if a reading was returned, FALSE at the end of the range
+*/
+int
+hdate_parasha_iter_next (hdate_parasha_iter *it, int *jd, int *parasha)
+{
+	int day, simhat_tora, reading;
+
+	while (it->jd <= it->jd_end)
+	{
+		if (it->jd >= it->jd_tishrey1 + it->size_of_year)
+		{
+			parasha_iter_load_year (it, it->hd_year + 1);
+			continue;
+		}
+
+		/* next Shabbat, or Simhat Tora (22 Tishrey, and 23 in diaspora) */
+		day = it->jd + 6 - (it->jd + 1) % 7;
+		simhat_tora = it->jd_tishrey1 + 21;
+		if (it->jd > simhat_tora && it->diaspora) simhat_tora++;
+		if (it->jd <= simhat_tora && simhat_tora < day) day = simhat_tora;
+
+		if (day >= it->jd_tishrey1 + it->size_of_year)
+		{
+			it->jd = it->jd_tishrey1 + it->size_of_year;
+			continue;
+		}
+		if (day > it->jd_end) break;
+
+		it->jd = day + 1;
+		if (day == simhat_tora)
+			reading = 54;
+		else
+			reading = shabbat_reading (day, it->diaspora, it->jd_tishrey1, it->size_of_year);
+
+		if (reading)
+		{
+			*jd = day;
+			*parasha = reading;
+			return TRUE;
+		}
+	}
+
+	it->jd = it->jd_end + 1;
+	return FALSE;
+}
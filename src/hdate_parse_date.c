@@ -56,6 +56,9 @@ typedef struct {
 	int prefer_parm;
 	int base_year_h;
 	int base_year_g;
+	hdate_format_context const *names;	/// NULL for hdate_parse_month_text_string
+	hdate_struct today;
+	int today_set;
 	} parse_date_struct;
 	
 static char * day_text		 = N_("day");
@@ -116,7 +119,7 @@ int hdate_get_size_of_gregorian_month( const unsigned int month, const unsigned
 	if ((month < 1) || (month > 12) || (year < HDATE_GREG_YR_LOWER_BOUND) || (year > HDATE_GREG_YR_UPPER_BOUND)) return -1;
 	switch (month)
 	{
-	case 1: case 3: case 5: case 7: case 10: case 12: return 31; break;
+	case 1: case 3: case 5: case 7: case 8: case 10: case 12: return 31; break;
 	case 4: case 6: case 9: case 11: return 30; break;
 	case 2:
 		if (year%4) return 28;
@@ -132,7 +135,7 @@ int hdate_get_size_of_gregorian_month( const unsigned int month, const unsigned
 /****************************************************
 * initial_parse
 ***************************************************/
-int initial_parse( const char* parm_str, int* parm_val, int* parm_id, parse_date_struct* p )
+static int initial_parse( const char* parm_str, int* parm_val, int* parm_id, parse_date_struct* p )
 {
 	const char* digits = "0123456789";
 	int parm_span, parm_len;
@@ -144,29 +147,30 @@ int initial_parse( const char* parm_str, int* parm_val, int* parm_id, parse_date
 		*parm_val = atoi(parm_str);
 		if (   (*parm_val > HDATE_HEB_YR_UPPER_BOUND) ||
 			 ( (*parm_val < YR_LOWER_4_BOUND) && (*parm_val > YR_UPPER_2_BOUND) ) )
-			{print_parm_error(year_text); return FALSE;}
+			return HDATE_PARSE_BAD_YEAR;
 		else
 		{
-			if (*parm_val <= GDAY_UPPER_BOUND) return TRUE;
+			if (*parm_val <= GDAY_UPPER_BOUND) return HDATE_PARSE_OK;
 			*parm_id = MUST_BE_YEAR;
 			*p->ret_year = *parm_val;
 		}
 	}
 	else
 	{
-		*parm_val = hdate_parse_month_text_string(parm_str);
-		if (!*parm_val) {print_parm_error(month_text); return FALSE;}
+		if (p->names) *parm_val = hdate_parse_month_text_ctx(p->names, parm_str);
+		else *parm_val = hdate_parse_month_text_string(parm_str);
+		if (!*parm_val) return HDATE_PARSE_BAD_MONTH;
 		*parm_id = MUST_BE_MONTH;
 		*p->ret_month = *parm_val;
 	}
-	return TRUE;
+	return HDATE_PARSE_OK;
 }
 
 
 /****************************************************
 * set_gh_year_month
 ***************************************************/
-void set_gh_year_month( int year, int month, parse_date_struct* p )
+static void set_gh_year_month( int year, int month, parse_date_struct* p )
 {
 	// what if month > 12 ? Is that a situation that reaches here?
 	if (month > 100)
@@ -183,7 +187,7 @@ void set_gh_year_month( int year, int month, parse_date_struct* p )
 /****************************************************
 * set_hmonth
 ***************************************************/
-void set_hmonth( int month, parse_date_struct* p )
+static void set_hmonth( int month, parse_date_struct* p )
 {
 	if (month > GMONTH_UPPER_BOUND)
 	{
@@ -202,17 +206,17 @@ void set_hmonth( int month, parse_date_struct* p )
 *   given three parameters and only could determine
 *   that one was MUST_BE_YEAR (ie 32-99 or > 1000)
 ***************************************************/
-int second_parse( int a, int b, parse_date_struct* p)
+static int second_parse( int a, int b, parse_date_struct* p)
 {
 	/// The prejudice here is mm dd, but you can overrule that
 	/// by just passing the parameters in reverse.
 	if (*p->ret_year >= HDATE_HEB_YR_LOWER_BOUND)
 	{
 		if ((a > HDAY_UPPER_BOUND) || (b > HDAY_UPPER_BOUND))
-						{print_parm_error(day_text); return FALSE;};
+						return HDATE_PARSE_BAD_DAY;
 		if (b > HMONTH_UPPER_BOUND)
 		{
-			if (a > HMONTH_UPPER_BOUND)	{print_parm_error(month_text); return FALSE;}
+			if (a > HMONTH_UPPER_BOUND)	return HDATE_PARSE_BAD_MONTH;
 			*p->ret_month = a + 100;
 			*p->ret_day = b;
 		}
@@ -230,7 +234,7 @@ int second_parse( int a, int b, parse_date_struct* p)
 		//				{print_parm_error(day_text); return FALSE;};
 		if (a > GMONTH_UPPER_BOUND)
 		{
-			if (b > GMONTH_UPPER_BOUND)	{print_parm_error(month_text); return FALSE;}
+			if (b > GMONTH_UPPER_BOUND)	return HDATE_PARSE_BAD_MONTH;
 			*p->ret_month = b;
 			*p->ret_day = a;
 		}
@@ -244,7 +248,7 @@ int second_parse( int a, int b, parse_date_struct* p)
 	{
 		if (a > HMONTH_UPPER_BOUND)
 		{
-			if (b > HMONTH_UPPER_BOUND)	{print_parm_error(month_text); return FALSE;}
+			if (b > HMONTH_UPPER_BOUND)	return HDATE_PARSE_BAD_MONTH;
 			if ( (b > GMONTH_UPPER_BOUND) || (p->prefer_hebrew) )
 			{
 				*p->ret_month = b + 100;
@@ -274,13 +278,13 @@ int second_parse( int a, int b, parse_date_struct* p)
 			}
 		}
 	}
-return TRUE;
+return HDATE_PARSE_OK;
 }
 
 /****************************************************
 * check_two_of_three_gt
 ***************************************************/
-int check_two_of_three_gt( int a, int b, int c, int compare_val)
+static int check_two_of_three_gt( int a, int b, int c, int compare_val)
 {
 	if ( ( (a > compare_val) && (b > compare_val) ) ||
 		 ( (b > compare_val) && (c > compare_val) ) ||
@@ -292,7 +296,7 @@ int check_two_of_three_gt( int a, int b, int c, int compare_val)
 /****************************************************
 * hebrew_three_parm_parse
 ***************************************************/
-int hebrew_three_parm_parse( parse_date_struct* p )
+static int hebrew_three_parm_parse( parse_date_struct* p )
 {	
 	/// my personal prejudice to prefer hebrew form dd mm yy
 	if (p->b_val > HMONTH_UPPER_BOUND)
@@ -312,7 +316,7 @@ int hebrew_three_parm_parse( parse_date_struct* p )
 				*p->ret_day = p->b_val;
 			}
 			set_hmonth( p->c_val, p );
-			return TRUE;
+			return HDATE_PARSE_OK;
 		}
 		if (p->b_val > HDAY_UPPER_BOUND)
 		{
@@ -331,12 +335,12 @@ int hebrew_three_parm_parse( parse_date_struct* p )
 				*p->ret_day = p->a_val;
 				set_hmonth( p->c_val, p );
 			}
-			return TRUE;
+			return HDATE_PARSE_OK;
 		}
 		*p->ret_day = p->b_val;
 		*p->ret_year = p->c_val + p->base_year_h;
 		set_hmonth( p->a_val, p );
-		return TRUE;
+		return HDATE_PARSE_OK;
 	}
 	/// at this point, we know that b_val could be anything
 	if (p->a_val > HMONTH_UPPER_BOUND)
@@ -355,7 +359,7 @@ int hebrew_three_parm_parse( parse_date_struct* p )
 				*p->ret_day = p->a_val;
 			}
 			set_hmonth( p->b_val, p );
-			return TRUE;
+			return HDATE_PARSE_OK;
 		}
 		if (p->a_val > HDAY_UPPER_BOUND)
 		{
@@ -364,26 +368,25 @@ int hebrew_three_parm_parse( parse_date_struct* p )
 			/// {
 			///	*ret_day = c_val;
 			/// *ret_month = b_val + 100;
-			///	return TRUE;
+			///	return HDATE_PARSE_OK;
 			///}
 			*p->ret_day = p->c_val;
 			set_hmonth( p->b_val, p );
-			return TRUE;
+			return HDATE_PARSE_OK;
 		}		
 	}
 	*p->ret_year = p->c_val + p->base_year_h;
 	*p->ret_day = p->a_val;
 	set_hmonth( p->b_val, p );
-	return TRUE;
+	return HDATE_PARSE_OK;
 }
 
 /****************************************************
 * gregorian_three_parm_parse
 ***************************************************/
-int gregorian_three_parm_parse()
+static int gregorian_three_parm_parse( void )
 {
-	printf("ERROR: reached function gregorian_three_parm_parse in local_functions, but it hasn't been coded yet\n");
-	return TRUE;
+	return HDATE_PARSE_UNSUPPORTED;
 }
 
 
@@ -392,6 +395,22 @@ int gregorian_three_parm_parse()
 
 
 
+/****************************************************
+* parse_today
+*   today's date, looked up once per parse
+***************************************************/
+static hdate_struct* parse_today( parse_date_struct* p )
+{
+	if (!p->today_set)
+	{
+		hdate_set_today (&p->today);
+		p->today_set = TRUE;
+	}
+	return &p->today;
+}
+
+
+
 /************************************************************
 * parse_date
 * 
@@ -399,8 +418,8 @@ int gregorian_three_parm_parse()
 *	Allow yyyy mm OR mm yyyy - check strlen
 *	Allow yyyy MMM OR MMM yyyy even with a 2-digit year
 * 
-* currently returns TRUE always, but if it encounters an
-* obvious error, it reports the error and calls exit()
+* returns HDATE_PARSE_OK, or an HDATE_PARSE_* error code; it
+* prints nothing (see hdate_parse_date for that)
 * 
 * The logic here is fuzzy and imprecise, and does not cover
 * all cases (at least yet). For example, day parameters are
@@ -423,323 +442,601 @@ int gregorian_three_parm_parse()
 	// char* locale_time_settings_string = setlocale(LC_TIME, "");
 	// or peek in /usr/share/i18n/locales
 	// or something simpler?
-int hdate_parse_date( const char* parm_a, const char* parm_b, const char* parm_c,
-					 int* ret_year, int* ret_month, int* ret_day, const int parm_cnt,
-					 const int prefer_hebrew, const int prefer_parm,
-					 const int base_year_h, const int base_year_g )
+static int parse_date_parms( const char* parm_a, const char* parm_b, const char* parm_c,
+							 const int parm_cnt, parse_date_struct* p )
 {
 	hdate_struct h;
-	parse_date_struct p;
+	int code;
 
-	p.a_id = UNKNOWN_STATE;
-	p.b_id = UNKNOWN_STATE;
-	p.c_id = UNKNOWN_STATE;
-	p.a_val = BAD_DATE_VALUE;
-	p.b_val = BAD_DATE_VALUE;
-	p.c_val = BAD_DATE_VALUE;
-	p.ret_year = ret_year;
-	p.ret_month = ret_month;
-	p.ret_day = ret_day;
-	p.prefer_hebrew = prefer_hebrew;
-	p.prefer_parm = prefer_parm;
-	p.base_year_g = base_year_g;
-	p.base_year_h = base_year_h;
-	
 	switch (parm_cnt)
 	{
-	case 3:	if (!initial_parse(parm_c, &p.c_val, &p.c_id, &p )) return FALSE;
+	case 3:	if ((code = initial_parse(parm_c, &p->c_val, &p->c_id, p )) != HDATE_PARSE_OK) return code;
 			/// and fall through ...
-	case 2:	if (!initial_parse(parm_b, &p.b_val, &p.b_id, &p )) return FALSE;
+	case 2:	if ((code = initial_parse(parm_b, &p->b_val, &p->b_id, p )) != HDATE_PARSE_OK) return code;
 			/// and fall through ...
-	case 1:	if (!initial_parse(parm_a, &p.a_val, &p.a_id, &p )) return FALSE;
+	case 1:	if ((code = initial_parse(parm_a, &p->a_val, &p->a_id, p )) != HDATE_PARSE_OK) return code;
 			break;
-	default: return FALSE;
+	default: return HDATE_PARSE_FIELD_COUNT;
 	}
 
 	/// The definite ids from the initial parse are alphabetic months
 	/// and four-digit years, and there can only be one of each
-	if ( (p.a_id + p.b_id + p.c_id) >= (MUST_BE_MONTH*2) )
+	if ( (p->a_id + p->b_id + p->c_id) >= (MUST_BE_MONTH*2) )
 	{
-		error(0,0,"%s: %s",error_text, N_("multiple month parameters detected"));
-		return FALSE;
+		return HDATE_PARSE_MULTIPLE_MONTHS;
 	}
-	if ( ((p.a_id + p.b_id + p.c_id)%10) > MUST_BE_YEAR  )
+	if ( ((p->a_id + p->b_id + p->c_id)%10) > MUST_BE_YEAR  )
 	{
-		error(0,0,"%s: %s",error_text, N_("multiple year parameters detected"));
-		return FALSE;
+		return HDATE_PARSE_MULTIPLE_YEARS;
 	}
 
 	if (parm_cnt == 1)
 	{
-		*p.ret_day = 0;
-		if (p.a_id == MUST_BE_MONTH)     /// month name was parsed 
+		*p->ret_day = 0;
+		if (p->a_id == MUST_BE_MONTH)     /// month name was parsed 
 		{
-			hdate_set_gdate (&h, 0, 0, 0);	/// set date for today
-			if (p.a_val > 100)
+			h = *parse_today (p);
+			if (p->a_val > 100)
 			{
-				*p.ret_year = h.hd_year;
-				if ( (p.a_val > 112) && (h.hd_size_of_year < 383 ) )
-					*p.ret_month = 106;
+				*p->ret_year = h.hd_year;
+				if ( (p->a_val > 112) && (h.hd_size_of_year < 383 ) )
+					*p->ret_month = 106;
 			}
-			else	*p.ret_year = h.gd_year;
+			else	*p->ret_year = h.gd_year;
 		}
-		else if (p.a_id != MUST_BE_YEAR) /// two-digit value < 32
+		else if (p->a_id != MUST_BE_YEAR) /// two-digit value < 32
 		{
-			if (p.prefer_parm == HDATE_PREFER_YM)
+			if (p->prefer_parm == HDATE_PREFER_YM)
 			{
-				if (!p.prefer_hebrew)
+				if (!p->prefer_hebrew)
 				{
-					if (p.a_val <= GMONTH_UPPER_BOUND)
+					if (p->a_val <= GMONTH_UPPER_BOUND)
 					{
-						*p.ret_month = p.a_val;
-						hdate_set_gdate (&h, 0, 0, 0);	/// set date for today
-						*p.ret_year = h.gd_year;
+						*p->ret_month = p->a_val;
+						h = *parse_today (p);
+						*p->ret_year = h.gd_year;
 					}
 					else
 					{
-						*p.ret_month = 0;
-						*p.ret_year = p.a_val + p.base_year_g;
+						*p->ret_month = 0;
+						*p->ret_year = p->a_val + p->base_year_g;
 					}
 				}
-				else /// (p.prefer_hebrew)
+				else /// (p->prefer_hebrew)
 				{
-					if (p.a_val <= HMONTH_UPPER_BOUND)
+					if (p->a_val <= HMONTH_UPPER_BOUND)
 					{
-						hdate_set_gdate (&h, 0, 0, 0);	/// set date for today
-						if ( (p.a_val > GMONTH_UPPER_BOUND) && (h.hd_size_of_year < 383 ) )
+						h = *parse_today (p);
+						if ( (p->a_val > GMONTH_UPPER_BOUND) && (h.hd_size_of_year < 383 ) )
 						{
-							*p.ret_month = 0;
-							*p.ret_year = p.a_val + p.base_year_h;
+							*p->ret_month = 0;
+							*p->ret_year = p->a_val + p->base_year_h;
 						}
-						*p.ret_month = p.a_val + 100;
-						*p.ret_year = h.hd_year;;
+						*p->ret_month = p->a_val + 100;
+						*p->ret_year = h.hd_year;;
 					}
 				}
 			}
-			else /// (p.prefer_parm == HDATE_PREFER_MD)
+			else /// (p->prefer_parm == HDATE_PREFER_MD)
 			{
-				if (p.prefer_hebrew)
+				if (p->prefer_hebrew)
 				{
-					hdate_set_gdate (&h, 0, 0, 0);	/// set date for today
-					if (p.a_val <= hdate_get_size_of_hebrew_month(h.hd_mon, h.hd_year_type))
+					h = *parse_today (p);
+					if (p->a_val <= hdate_get_size_of_hebrew_month(h.hd_mon, h.hd_year_type))
 					{
-						*p.ret_day = p.a_val;
-						*p.ret_month = h.hd_mon + 100;
-						*p.ret_year = h.hd_year;
+						*p->ret_day = p->a_val;
+						*p->ret_month = h.hd_mon + 100;
+						*p->ret_year = h.hd_year;
 					}
 					else  /// treat as two digit Hebrew year
 					{
-						*p.ret_day = 0;
-						*p.ret_month = 0;
-						*p.ret_year = p.a_val + base_year_h;
+						*p->ret_day = 0;
+						*p->ret_month = 0;
+						*p->ret_year = p->a_val + p->base_year_h;
 					}
 				}
-				else /// (!p.prefer_hebrew)
+				else /// (!p->prefer_hebrew)
 				{
-					hdate_set_gdate (&h, 0, 0, 0);	/// set date for today
-					if ( p.a_val <= hdate_get_size_of_gregorian_month( h.gd_mon, h.gd_year) )
+					h = *parse_today (p);
+					if ( p->a_val <= hdate_get_size_of_gregorian_month( h.gd_mon, h.gd_year) )
 					{
-						*p.ret_day = p.a_val;
-						*p.ret_month = h.gd_mon;
-						*p.ret_year = h.gd_year;
+						*p->ret_day = p->a_val;
+						*p->ret_month = h.gd_mon;
+						*p->ret_year = h.gd_year;
 					}
 					else /// treat as two digit gregorian year
 					{
-						*p.ret_day = 0;
-						*p.ret_month = 0;
-						*p.ret_year = p.a_val + base_year_g;
+						*p->ret_day = 0;
+						*p->ret_month = 0;
+						*p->ret_year = p->a_val + p->base_year_g;
 					}
 				}
 			}
 		}
-		return TRUE;
+		return HDATE_PARSE_OK;
 	}
 
 	if (parm_cnt == 2)
 	{
-		switch (p.a_id + p.b_id)
+		switch (p->a_id + p->b_id)
 		{
-	default: error(0,0,"%s: %s",error_text, N_("unexpected error in parse_date\n"));
-			return FALSE;
+	default: return HDATE_PARSE_UNEXPECTED;
 			break;
 	case 11:	/// MUST_BE_YEAR && MUST_BE_MONTH
-			if ( ( (*p.ret_year >= HDATE_HEB_YR_LOWER_BOUND) && (*p.ret_month < 101) ) ||
-			     ( (*p.ret_year <= HDATE_GREG_YR_UPPER_BOUND) && (*p.ret_month > 100) ) )
+			if ( ( (*p->ret_year >= HDATE_HEB_YR_LOWER_BOUND) && (*p->ret_month < 101) ) ||
+			     ( (*p->ret_year <= HDATE_GREG_YR_UPPER_BOUND) && (*p->ret_month > 100) ) )
 			{
-				print_parm_mismatch_error();
-				return FALSE;
+				return HDATE_PARSE_MISMATCH;
 			}
-			*p.ret_day = 0;
-			if (*p.ret_year <= YR_UPPER_2_BOUND) /// 32-99
-				set_gh_year_month( *p.ret_year, *p.ret_month, &p );
+			*p->ret_day = 0;
+			if (*p->ret_year <= YR_UPPER_2_BOUND) /// 32-99
+				set_gh_year_month( *p->ret_year, *p->ret_month, p );
 			// TODO - test that validate_date faults day 31 and some day 30 in Hebrew month
 			break;
 	case 10:	/// MUST_BE_MONTH
-			if (p.a_id == MUST_BE_MONTH) *p.ret_year = p.b_val;
-			else  *p.ret_year = p.a_val;
-			if (p.prefer_parm == HDATE_PREFER_YM)
+			if (p->a_id == MUST_BE_MONTH) *p->ret_year = p->b_val;
+			else  *p->ret_year = p->a_val;
+			if (p->prefer_parm == HDATE_PREFER_YM)
 			{
-				*p.ret_day = 0;
-				set_gh_year_month( *p.ret_year, *p.ret_month, &p );
+				*p->ret_day = 0;
+				set_gh_year_month( *p->ret_year, *p->ret_month, p );
 			}
 			else /// prefer two parm as dd mm
 			{
-				/// *p.ret_year is temporarily
+				/// *p->ret_year is temporarily
 				/// holding the expected day value
-				if (*p.ret_month > 100)
+				if (*p->ret_month > 100)
 				{
-					if (*p.ret_year > HDAY_UPPER_BOUND)
+					if (*p->ret_year > HDAY_UPPER_BOUND)
 					{
-						*p.ret_day = 0;
-						set_gh_year_month( *p.ret_year, *p.ret_month, &p );
+						*p->ret_day = 0;
+						set_gh_year_month( *p->ret_year, *p->ret_month, p );
 					}
 					else
 					{
-						*p.ret_day = *p.ret_year;
-						hdate_set_gdate (&h, 0, 0, 0);	/// set date for today
-						*p.ret_year = h.hd_year;
+						*p->ret_day = *p->ret_year;
+						h = *parse_today (p);
+						*p->ret_year = h.hd_year;
 					}
 				}
 				else
 				{
-					*p.ret_day = *p.ret_year;
-					hdate_set_gdate (&h, 0, 0, 0);	/// set date for today
-					*p.ret_year = h.gd_year;
+					*p->ret_day = *p->ret_year;
+					h = *parse_today (p);
+					*p->ret_year = h.gd_year;
 				}	
 			}
 			break;
 	case  1:	/// MUST_BE_YEAR
 			/// since we have only two parms, and one must be a year
 			/// we insist that the other be a month
-			*p.ret_day = 0;
-			if (p.a_id == MUST_BE_YEAR)
-				 *p.ret_month = p.b_val;
-			else *p.ret_month = p.a_val;
-			if (*p.ret_month > HMONTH_UPPER_BOUND)
+			*p->ret_day = 0;
+			if (p->a_id == MUST_BE_YEAR)
+				 *p->ret_month = p->b_val;
+			else *p->ret_month = p->a_val;
+			if (*p->ret_month > HMONTH_UPPER_BOUND)
 			{
-				print_parm_error(month_text);
-				return FALSE;
+				return HDATE_PARSE_BAD_MONTH;
 			}
-			if (*p.ret_year >= HDATE_HEB_YR_LOWER_BOUND)
-				set_hmonth( *p.ret_month, &p );
-			else if ( (*p.ret_year >= YR_LOWER_4_BOUND) &&
-					  (*p.ret_month > GMONTH_UPPER_BOUND) )
+			if (*p->ret_year >= HDATE_HEB_YR_LOWER_BOUND)
+				set_hmonth( *p->ret_month, p );
+			else if ( (*p->ret_year >= YR_LOWER_4_BOUND) &&
+					  (*p->ret_month > GMONTH_UPPER_BOUND) )
 			{
-				print_parm_error(month_text);
-				return FALSE;
+				return HDATE_PARSE_BAD_MONTH;
 			}
-			else if (*p.ret_year <= YR_UPPER_2_BOUND) 
+			else if (*p->ret_year <= YR_UPPER_2_BOUND) 
 			{
-				if ( (p.prefer_hebrew) || 
-					 (*p.ret_month > GMONTH_UPPER_BOUND) )
+				if ( (p->prefer_hebrew) || 
+					 (*p->ret_month > GMONTH_UPPER_BOUND) )
 				{
-					*p.ret_year = *p.ret_year + p.base_year_h;
-					set_hmonth( *p.ret_month, &p );
+					*p->ret_year = *p->ret_year + p->base_year_h;
+					set_hmonth( *p->ret_month, p );
 				}
-				else *p.ret_year = *p.ret_year + p.base_year_g;
+				else *p->ret_year = *p->ret_year + p->base_year_g;
 			}
-			return TRUE;
+			return HDATE_PARSE_OK;
 			break;
 	case  0: /// both parms are in UNKNOWN_STATE
 			 /// ie. numeric, 0 < n < 32
-			if ((p.a_val > HMONTH_UPPER_BOUND) && (p.b_val > HMONTH_UPPER_BOUND)) 
-				{print_parm_error(month_text); return FALSE;}
-			if ((p.prefer_hebrew) ||
-				((p.a_val > GMONTH_UPPER_BOUND) && (p.b_val > GMONTH_UPPER_BOUND)))
+			if ((p->a_val > HMONTH_UPPER_BOUND) && (p->b_val > HMONTH_UPPER_BOUND)) 
+				return HDATE_PARSE_BAD_MONTH;
+			if ((p->prefer_hebrew) ||
+				((p->a_val > GMONTH_UPPER_BOUND) && (p->b_val > GMONTH_UPPER_BOUND)))
 			{
-				*p.ret_year = p.a_val + base_year_h;
-				if (p.a_val > HMONTH_UPPER_BOUND)
-					*p.ret_month = p.b_val;
-				else *p.ret_month = p.a_val; /// preference of mm yy
-				set_hmonth( *p.ret_month, &p );
+				*p->ret_year = p->a_val + p->base_year_h;
+				if (p->a_val > HMONTH_UPPER_BOUND)
+					*p->ret_month = p->b_val;
+				else *p->ret_month = p->a_val; /// preference of mm yy
+				set_hmonth( *p->ret_month, p );
 			}
 			else /// prefer gregorian
 			{
-				*p.ret_year = p.a_val + p.base_year_g;
-				if (p.b_val > GMONTH_UPPER_BOUND)
-					 *p.ret_month = p.a_val;
-				else *p.ret_month = p.b_val;
+				*p->ret_year = p->a_val + p->base_year_g;
+				if (p->b_val > GMONTH_UPPER_BOUND)
+					 *p->ret_month = p->a_val;
+				else *p->ret_month = p->b_val;
 			}
 		}
-		return TRUE;
+		return HDATE_PARSE_OK;
 	}
 
 	/// three parameters
-	switch (p.a_id + p.b_id + p.c_id)
+	switch (p->a_id + p->b_id + p->c_id)
 	{
-	default: error(0,0,"%s: %s",error_text, N_("unexpected error in parse_date\n"));
-			return FALSE;
+	default: return HDATE_PARSE_UNEXPECTED;
 			break;
 	case 11:	/// MUST_BE_YEAR && MUST_BE_MONTH
-			if ( ( (*p.ret_year >= HDATE_HEB_YR_LOWER_BOUND) && (*p.ret_month < 101) ) ||
-			     ( (*p.ret_year <= HDATE_GREG_YR_UPPER_BOUND) && (*p.ret_month > 100) ) )
+			if ( ( (*p->ret_year >= HDATE_HEB_YR_LOWER_BOUND) && (*p->ret_month < 101) ) ||
+			     ( (*p->ret_year <= HDATE_GREG_YR_UPPER_BOUND) && (*p->ret_month > 100) ) )
 			{
-				print_parm_mismatch_error();
-				return FALSE;
+				return HDATE_PARSE_MISMATCH;
 			}
-			if (*p.ret_year <= YR_UPPER_2_BOUND) /// 32-99
-				set_gh_year_month( *p.ret_year, *p.ret_month, &p );
-			if (p.a_id == UNKNOWN_STATE) *p.ret_day = p.a_val;
-			else if (p.b_id == UNKNOWN_STATE) *p.ret_day = p.b_val;
-			else *p.ret_day = p.c_val;
+			if (*p->ret_year <= YR_UPPER_2_BOUND) /// 32-99
+				set_gh_year_month( *p->ret_year, *p->ret_month, p );
+			if (p->a_id == UNKNOWN_STATE) *p->ret_day = p->a_val;
+			else if (p->b_id == UNKNOWN_STATE) *p->ret_day = p->b_val;
+			else *p->ret_day = p->c_val;
 			// TODO - test that validate_date faults day 31 and some day 30 in Hebrew month
 			break;
 	case 10:	/// MUST_BE_MONTH
-			if (p.a_id == MUST_BE_MONTH)
+			if (p->a_id == MUST_BE_MONTH)
 			{
 				/// personal prejudice to prefer mmmm dd yy
-				*p.ret_day = p.b_val; // TODO - test that validate_date faults day 31 and some day 30 in Hebrew month
-				set_gh_year_month( p.c_val, p.a_val, &p );
+				*p->ret_day = p->b_val; // TODO - test that validate_date faults day 31 and some day 30 in Hebrew month
+				set_gh_year_month( p->c_val, p->a_val, p );
 			}
-			else if (p.b_id == MUST_BE_MONTH)
+			else if (p->b_id == MUST_BE_MONTH)
 			{
 				/// prefer dd mmmm yy because its more natural in Hebrew though
 				/// had it been three numeric fields, I would favor yy mm dd
-				*p.ret_day = p.a_val; // TODO - test that validate_date faults day 31 and some day 30 in Hebrew month
-				set_gh_year_month( p.c_val, p.b_val, &p );
+				*p->ret_day = p->a_val; // TODO - test that validate_date faults day 31 and some day 30 in Hebrew month
+				set_gh_year_month( p->c_val, p->b_val, p );
 			}
-			else ///(p.c_id == MUST_BE_MONTH)
+			else ///(p->c_id == MUST_BE_MONTH)
 			{
 				/// tough call - my intuition is yy dd mmmm
-				*p.ret_day = p.b_val; // TODO - test that validate_date faults day 31 and some day 30 in Hebrew month
-				set_gh_year_month( p.a_val, p.c_val, &p );
+				*p->ret_day = p->b_val; // TODO - test that validate_date faults day 31 and some day 30 in Hebrew month
+				set_gh_year_month( p->a_val, p->c_val, p );
 			}
 			break;
 	case  1:	/// MUST_BE_YEAR
-			if      (p.a_id == MUST_BE_YEAR) return second_parse(p.b_val, p.c_val, &p );
-			else if (p.b_id == MUST_BE_YEAR) return second_parse(p.a_val, p.c_val, &p );
-			else return second_parse(p.a_val, p.b_val, &p );
+			if      (p->a_id == MUST_BE_YEAR) return second_parse(p->b_val, p->c_val, p );
+			else if (p->b_id == MUST_BE_YEAR) return second_parse(p->a_val, p->c_val, p );
+			else return second_parse(p->a_val, p->b_val, p );
 			break;
 	case  0: /// all three parms are in UNKNOWN_STATE
 			 /// ie. numeric, 0 < n < 32
-			if ((p.a_val > HMONTH_UPPER_BOUND) &&
-				(p.b_val > HMONTH_UPPER_BOUND) &&
-				(p.c_val > HMONTH_UPPER_BOUND) )
+			if ((p->a_val > HMONTH_UPPER_BOUND) &&
+				(p->b_val > HMONTH_UPPER_BOUND) &&
+				(p->c_val > HMONTH_UPPER_BOUND) )
 			{
-				print_parm_error(month_text);
-				return FALSE;
+				return HDATE_PARSE_BAD_MONTH;
 			}
-			if ( (p.a_val > GMONTH_UPPER_BOUND) &&
-				 (p.b_val > GMONTH_UPPER_BOUND) &&
-				 (p.c_val > GMONTH_UPPER_BOUND) )
+			if ( (p->a_val > GMONTH_UPPER_BOUND) &&
+				 (p->b_val > GMONTH_UPPER_BOUND) &&
+				 (p->c_val > GMONTH_UPPER_BOUND) )
 			{
 				/// MUST be hebrew
-				if ( check_two_of_three_gt( p.a_val, p.b_val, p.c_val, HDAY_UPPER_BOUND ) )
+				if ( check_two_of_three_gt( p->a_val, p->b_val, p->c_val, HDAY_UPPER_BOUND ) )
 				{
-					print_parm_mismatch_error();
-					return FALSE;
+					return HDATE_PARSE_MISMATCH;
 				}
-				return hebrew_three_parm_parse( &p );
+				return hebrew_three_parm_parse( p );
 			}
-			if ( check_two_of_three_gt( p.a_val, p.b_val, p.c_val, HDAY_UPPER_BOUND ) )
+			if ( check_two_of_three_gt( p->a_val, p->b_val, p->c_val, HDAY_UPPER_BOUND ) )
 			{
 				return gregorian_three_parm_parse();
 			}
-			if ( (p.prefer_hebrew) &&
-				 ( ! check_two_of_three_gt( p.a_val, p.b_val, p.c_val, HDAY_UPPER_BOUND ) ) )
-				return hebrew_three_parm_parse( &p );
+			if ( (p->prefer_hebrew) &&
+				 ( ! check_two_of_three_gt( p->a_val, p->b_val, p->c_val, HDAY_UPPER_BOUND ) ) )
+				return hebrew_three_parm_parse( p );
 			else return gregorian_three_parm_parse();
 			break;
-	} /// end switch (p.a_id + p.b_id + p.c_id)
-	return TRUE;
+	} /// end switch (p->a_id + p->b_id + p->c_id)
+	return HDATE_PARSE_OK;
+}
+
+
+
+/****************************************************
+* parse_date_init
+***************************************************/
+static void parse_date_init( parse_date_struct* p,
+					 int* ret_year, int* ret_month, int* ret_day,
+					 const int prefer_hebrew, const int prefer_parm,
+					 const int base_year_h, const int base_year_g )
+{
+	p->a_id = UNKNOWN_STATE;
+	p->b_id = UNKNOWN_STATE;
+	p->c_id = UNKNOWN_STATE;
+	p->a_val = BAD_DATE_VALUE;
+	p->b_val = BAD_DATE_VALUE;
+	p->c_val = BAD_DATE_VALUE;
+	p->ret_year = ret_year;
+	p->ret_month = ret_month;
+	p->ret_day = ret_day;
+	p->prefer_hebrew = prefer_hebrew;
+	p->prefer_parm = prefer_parm;
+	p->base_year_g = base_year_g;
+	p->base_year_h = base_year_h;
+	p->names = NULL;
+	p->today_set = FALSE;
+}
+
+
+
+/************************************************************
+* hdate_parse_date
+*
+* parse_date_parms, reporting errors on stderr
+*
+* returns TRUE on success, FALSE on error
+************************************************************/
+int hdate_parse_date( const char* parm_a, const char* parm_b, const char* parm_c,
+					 int* ret_year, int* ret_month, int* ret_day, const int parm_cnt,
+					 const int prefer_hebrew, const int prefer_parm,
+					 const int base_year_h, const int base_year_g )
+{
+	parse_date_struct p;
+
+	parse_date_init( &p, ret_year, ret_month, ret_day,
+					 prefer_hebrew, prefer_parm, base_year_h, base_year_g );
+
+	switch (parse_date_parms( parm_a, parm_b, parm_c, parm_cnt, &p ))
+	{
+	case HDATE_PARSE_OK:
+			return TRUE;
+	case HDATE_PARSE_UNSUPPORTED:
+			printf("ERROR: reached function gregorian_three_parm_parse in local_functions, but it hasn't been coded yet\n");
+			return TRUE;
+	case HDATE_PARSE_BAD_YEAR:
+			print_parm_error(year_text);
+			break;
+	case HDATE_PARSE_BAD_MONTH:
+			print_parm_error(month_text);
+			break;
+	case HDATE_PARSE_BAD_DAY:
+			print_parm_error(day_text);
+			break;
+	case HDATE_PARSE_MISMATCH:
+			print_parm_mismatch_error();
+			break;
+	case HDATE_PARSE_MULTIPLE_MONTHS:
+			error(0,0,"%s: %s",error_text, N_("multiple month parameters detected"));
+			break;
+	case HDATE_PARSE_MULTIPLE_YEARS:
+			error(0,0,"%s: %s",error_text, N_("multiple year parameters detected"));
+			break;
+	case HDATE_PARSE_UNEXPECTED:
+			error(0,0,"%s: %s",error_text, N_("unexpected error in parse_date\n"));
+			break;
+	}
+	return FALSE;
+}
+
+
+
+/****************************************************
+* parse_date_jd
+*   the julian day of a parsed year, month and day;
+*   a missing day (or month and day) gives the first
+*   day of the month (or year), and HDATE_PARSE_INCOMPLETE
+***************************************************/
+static int parse_date_jd( const int year, const int month, const int day, int* jd )
+{
+	hdate_struct h;
+	int hmonth;
+
+	*jd = 0;
+	if ( (month == 0) && (day != 0) ) return HDATE_PARSE_BAD_MONTH;
+	if ( (month > 100) || ( (month == 0) && (year >= HDATE_HEB_YR_LOWER_BOUND) ) )
+	{
+		if ( (year < HDATE_HEB_YR_LOWER_BOUND) || (year > HDATE_HEB_YR_UPPER_BOUND) )
+			return HDATE_PARSE_BAD_YEAR;
+		hmonth = (month == 0) ? 1 : month - 100;
+		if ( (hmonth < 1) || (hmonth > HMONTH_UPPER_BOUND) ) return HDATE_PARSE_BAD_MONTH;
+		if ( (day < 0) || (day > HDAY_UPPER_BOUND) ) return HDATE_PARSE_BAD_DAY;
+
+		/// let the round trip decide whether there is such a day;
+		/// Adar (6) in a leap year is taken as Adar I (13)
+		*jd = hdate_hdate_to_jd( day ? day : 1, hmonth, year, NULL, NULL );
+		hdate_set_jd_fields( &h, *jd, HDATE_FIELD_HDATE );
+		if ( (h.hd_year != year) || (h.hd_day != (day ? day : 1)) ||
+			 ( (h.hd_mon != hmonth) && !( (hmonth == 6) && (h.hd_mon == 13) ) ) )
+		{
+			*jd = 0;
+			return HDATE_PARSE_INVALID_DATE;
+		}
+	}
+	else
+	{
+		if ( (year < HDATE_GREG_YR_LOWER_BOUND) || (year > HDATE_GREG_YR_UPPER_BOUND) )
+			return HDATE_PARSE_BAD_YEAR;
+		if ( (month < 0) || (month > GMONTH_UPPER_BOUND) ) return HDATE_PARSE_BAD_MONTH;
+		if ( (day < 0) || (day > GDAY_UPPER_BOUND) ) return HDATE_PARSE_BAD_DAY;
+		if ( (month != 0) && (day > hdate_get_size_of_gregorian_month( month, year )) )
+			return HDATE_PARSE_INVALID_DATE;
+		*jd = hdate_gdate_to_jd( day ? day : 1, month ? month : 1, year );
+	}
+	if (day == 0) return HDATE_PARSE_INCOMPLETE;
+	return HDATE_PARSE_OK;
+}
+
+
+
+/****************************************************
+* hdate_parse_options_init
+***************************************************/
+void hdate_parse_options_init( hdate_parse_options* options )
+{
+	options->field_separator = 0;
+	options->column = 0;
+	options->prefer_hebrew = TRUE;
+	options->prefer_2_parm_ym = HDATE_PREFER_YM;
+	options->base_year_h = HDATE_DEFAULT_BASE_YEAR_H;
+	options->base_year_g = HDATE_DEFAULT_BASE_YEAR_G;
+	hdate_set_today( &options->today );
+	hdate_format_context_init( &options->names, HDATE_ISRAEL_FLAG, HDATE_STRING_LONG );
+}
+
+
+
+#define DATE_PART_MAX	3
+#define DATE_PART_SIZE	64
+
+/****************************************************
+* is_date_separator
+*   what may come between the day, month and year
+***************************************************/
+static int is_date_separator( const char c )
+{
+	return (c == ' ') || (c == '\t') || (c == '/') || (c == '-') ||
+		   (c == '.') || (c == ',');
+}
+
+/****************************************************
+* parse_date_field
+*   split one date field into at most three parts and
+*   parse them; a run of non-numeric words, such as
+*   "Adar II" or "Rosh Chodesh", stays one part
+***************************************************/
+static int parse_date_field( const char* field, const char* field_end,
+							 parse_date_struct* p )
+{
+	char parts[DATE_PART_MAX][DATE_PART_SIZE];
+	const char* part_start;
+	const char* part_end;
+	const char* next;
+	int part_cnt = 0;
+	int numeric;
+
+	while (field < field_end)
+	{
+		while ( (field < field_end) && is_date_separator(*field) ) field++;
+		if (field == field_end) break;
+
+		part_start = field;
+		numeric = (*field >= '0') && (*field <= '9');
+		for (;;)
+		{
+			while ( (field < field_end) && !is_date_separator(*field) ) field++;
+			part_end = field;
+			if (numeric) break;
+			/// carry on over the separators to a following word
+			for (next = field; (next < field_end) && is_date_separator(*next); next++)
+				;
+			if ( (next == field_end) || ( (*next >= '0') && (*next <= '9') ) ) break;
+			field = next;
+		}
+
+		if (part_cnt == DATE_PART_MAX) return HDATE_PARSE_FIELD_COUNT;
+		if (part_end - part_start >= DATE_PART_SIZE)
+			return numeric ? HDATE_PARSE_BAD_YEAR : HDATE_PARSE_BAD_MONTH;
+		memcpy( parts[part_cnt], part_start, part_end - part_start );
+		parts[part_cnt][part_end - part_start] = '\0';
+		part_cnt++;
+	}
+
+	return parse_date_parms( parts[0], parts[1], parts[2], part_cnt, p );
+}
+
+/****************************************************
+* csv_field
+*   find the field at field, which may be in double
+*   quotes; returns the start of the next field, or
+*   NULL if this was the last; an unterminated quote
+*   gives a NULL field_start
+***************************************************/
+static const char* csv_field( const char* field, const char* line_end, const char separator,
+							  const char** field_start, const char** field_end )
+{
+	const char* quote;
+	const char* next;
+
+	if ( (field < line_end) && (*field == '"') )
+	{
+		for (quote = field + 1; ; quote += 2)
+		{
+			quote = memchr( quote, '"', line_end - quote );
+			if (quote == NULL) { *field_start = NULL; return NULL; }
+			/// "" is a quote within the field
+			if ( (quote + 1 == line_end) || (quote[1] != '"') ) break;
+		}
+		*field_start = field + 1;
+		*field_end = quote;
+		next = memchr( quote, separator, line_end - quote );
+	}
+	else
+	{
+		next = memchr( field, separator, line_end - field );
+		*field_start = field;
+		*field_end = next ? next : line_end;
+	}
+	return next ? next + 1 : NULL;
+}
+
+/****************************************************
+* hdate_parse_date_records
+***************************************************/
+int hdate_parse_date_records( const hdate_parse_options* options,
+							  const char* text, const size_t length, const int at_end,
+							  int* jd, int* error_code, const int size, size_t* consumed )
+{
+	parse_date_struct p;
+	const char* record = text;
+	const char* text_end = text + length;
+	const char* record_end;
+	const char* field;
+	const char* field_end;
+	const char* line_end;
+	const char* next;
+	int year, month, day;
+	int column;
+	int count = 0;
+	int code;
+
+	if ( (options == NULL) || (text == NULL) || (size < 0) ) return -1;
+	if ( (size > 0) && ((jd == NULL) || (error_code == NULL)) ) return -1;
+
+	while ( (count < size) && (record < text_end) )
+	{
+		record_end = memchr( record, '\n', text_end - record );
+		if ( (record_end == NULL) && !at_end ) break;
+		if (record_end == NULL) record_end = text_end;
+
+		/// the date field
+		field = record;
+		field_end = record_end;
+		if ( (field_end > field) && (*(field_end - 1) == '\r') ) field_end--;
+		if (options->field_separator)
+		{
+			line_end = field_end;
+			next = record;
+			for (column = 0; column <= options->column && next != NULL; column++)
+				next = csv_field( next, line_end, options->field_separator, &field, &field_end );
+			if (column <= options->column) field = NULL;
+		}
+
+		year = month = day = 0;
+		parse_date_init( &p, &year, &month, &day,
+						 options->prefer_hebrew, options->prefer_2_parm_ym,
+						 options->base_year_h, options->base_year_g );
+		p.names = &options->names;
+		p.today = options->today;
+		p.today_set = TRUE;
+
+		if (field == NULL) code = HDATE_PARSE_FIELD_COUNT;
+		else code = parse_date_field( field, field_end, &p );
+
+		jd[count] = 0;
+		if (code == HDATE_PARSE_OK) code = parse_date_jd( year, month, day, &jd[count] );
+		error_code[count] = code;
+		count++;
+
+		record = (record_end < text_end) ? record_end + 1 : text_end;
+	}
+
+	if (consumed) *consumed = record - text;
+	return count;
 }
@@ -25,6 +25,7 @@
 #include <fnmatch.h>  /// For fnmatch
 #include <langinfo.h> /// for nl_langinfo()
 #include <locale.h>   /// for set_locale()
+#include <pthread.h>  /// for pthread_once()
 #include "hdate.h"
 #include "support.h"
 
@@ -81,6 +82,45 @@ static char *gregorian_months[2][12] = {
 };
 
 
+#define H_CHAR_WIDTH 2
+static char *digits[3][10] = {
+	{" ", "א", "ב", "ג", "ד", "ה", "ו", "ז", "ח", "ט"},
+	{"ט", "י", "כ", "ל", "מ", "נ", "ס", "ע", "פ", "צ"},
+	{" ", "ק", "ר", "ש", "ת"}
+};
+
+/// This next is for counting days, weeks, or months
+static char *count_days[23] = {
+	"שני", "אחד", "שניים", "שלשה", "ארבעה",	"חמשה",
+	"ששה", "שבעה", "שמונה",	"תשעה",	"עשרה", "עשר",
+	"עשרים", "שלשים", "ארבעים",
+	};
+
+static char *vav = "ו";
+
+
+/**
+ @brief append a string to a caller buffer, snprintf style
+
+ Copies as much of text as fits, keeps the buffer null terminated, and
+ advances *position by the full length of text.
+*/
+static void
+buffer_append (char *buffer, size_t const buffer_len, size_t *position, const char *text)
+{
+	size_t text_len = strlen (text);
+	size_t room;
+
+	if (*position + 1 < buffer_len)
+	{
+		room = buffer_len - 1 - *position;
+		if (text_len < room) room = text_len;
+		memcpy (buffer + *position, text, room);
+		buffer[*position + room] = '\0';
+	}
+	*position += text_len;
+}
+
 
 
 /**
@@ -131,84 +171,17 @@ hdate_is_hebrew_locale()
 
 char * hdate_get_format_date (hdate_struct const *h, int const diaspora, int const short_format)
 {
-	int hebrew_format	= HDATE_STRING_LOCAL;
-	int omer_day 		= 0;
-	int holiday			= 0;
-	char *bet_h         = "";	// Hebrew prefix for Hebrew month
-
-	char *hebrew_buffer1, *hebrew_buffer2;
-	size_t hebrew_buffer1_len = -1;
-	size_t hebrew_buffer2_len = -1;
+	char *hebrew_buffer;
+	int hebrew_buffer_len;
 
-	char *hday_int_str, *hyear_int_str, *omer_str;
-
-	if (hdate_is_hebrew_locale())
-	{
-		bet_h="ב";
-		hebrew_format = HDATE_STRING_HEBREW;
-	}
-
-	hday_int_str = hdate_string(HDATE_STRING_INT, h->hd_day, HDATE_STRING_LONG,hebrew_format);
-	if (hday_int_str == NULL) return NULL;
-	hyear_int_str = hdate_string(HDATE_STRING_INT, h->hd_year, HDATE_STRING_LONG,hebrew_format);
-	if (hyear_int_str == NULL)
-	{
-		free(hday_int_str);
-		return NULL;
-	}
-
-	/************************************************************
-	* short format
-	************************************************************/
-	if (short_format)
-	{
-		hebrew_buffer1_len = asprintf (&hebrew_buffer1, "%s %s %s\n",
-				hday_int_str,
-				hdate_string( HDATE_STRING_HMONTH , h->hd_mon, HDATE_STRING_LONG, hebrew_format),
-				hyear_int_str);
-	}
-
-
-	/************************************************************
-	* long (normal) format
-	************************************************************/
-	else
-	{
-		hebrew_buffer1_len = asprintf (&hebrew_buffer1, "%s %s%s %s",
-				hday_int_str,
-				bet_h,
-				hdate_string( HDATE_STRING_HMONTH , h->hd_mon, HDATE_STRING_LONG, hebrew_format),
-				hyear_int_str);
-
-		/// if a day in the omer print it
-		if (hebrew_buffer1_len != -1) omer_day = hdate_get_omer_day(h);
-		if (omer_day != 0)
-		{
-			omer_str = hdate_string(HDATE_STRING_OMER, omer_day, HDATE_STRING_LONG, hebrew_format);
-			hebrew_buffer2_len = asprintf (&hebrew_buffer2, "%s, %s", hebrew_buffer1, omer_str);
-			if (omer_str != NULL) free(omer_str);
-			free(hebrew_buffer1);
-			if (hebrew_buffer2_len != -1) hebrew_buffer1 = hebrew_buffer2;
-			hebrew_buffer1_len = hebrew_buffer2_len;
-		}
-		
-		/// if holiday print it
-		if (hebrew_buffer1_len != -1) holiday = hdate_get_holyday (h, diaspora);
-		if (holiday != 0)
-		{
-			hebrew_buffer2_len = asprintf (&hebrew_buffer2, "%s, %s", hebrew_buffer1,
-		  			hdate_string( HDATE_STRING_HOLIDAY, holiday, HDATE_STRING_LONG, hebrew_format));
-			free(hebrew_buffer1);
-			if (hebrew_buffer2_len != -1) hebrew_buffer1 = hebrew_buffer2;
-			hebrew_buffer1_len = hebrew_buffer2_len;
-		}
+	hebrew_buffer_len = hdate_format_date_r (h, diaspora, short_format, NULL, 0);
+	if (hebrew_buffer_len < 0) return NULL;
 
-	}
+	hebrew_buffer = malloc (hebrew_buffer_len + 1);
+	if (hebrew_buffer == NULL) return NULL;
 
-	free(hday_int_str);
-	free(hyear_int_str);
-	if (hebrew_buffer1_len != -1) return hebrew_buffer1;
-	return NULL;
+	hdate_format_date_r (h, diaspora, short_format, hebrew_buffer, hebrew_buffer_len + 1);
+	return hebrew_buffer;
 }
 
 /**
@@ -290,13 +263,6 @@ char* hdate_string( int const type_of_string, int const index, int const input_s
 	/// for nl_langinfo calls for DOW an gregrorian months
 	char* langinfo_ptr;
 
-	#define H_CHAR_WIDTH 2
-	static char *digits[3][10] = {
-		{" ", "א", "ב", "ג", "ד", "ה", "ו", "ז", "ח", "ט"},
-		{"ט", "י", "כ", "ל", "מ", "נ", "ס", "ע", "פ", "צ"},
-		{" ", "ק", "ר", "ש", "ת"}
-	};
-
 	// FIXME - The english array should not be necessary because
 	//         we can/should rely on the system locale and
 	//         nl_langinfo()
@@ -511,15 +477,6 @@ char* hdate_string( int const type_of_string, int const index, int const input_s
 		 "ערב_סוכות"}	}
 		};
 
-	/// This next is for counting days, weeks, or months
-	static char *count_days[23] = {
-		"שני", "אחד", "שניים", "שלשה", "ארבעה",	"חמשה",
-		"ששה", "שבעה", "שמונה",	"תשעה",	"עשרה", "עשר",
-		"עשרים", "שלשים", "ארבעים",
-		};
-
-	static char *vav = "ו";
-
 #ifdef ENABLE_NLS
 	bindtextdomain (PACKAGE, PACKAGE_LOCALE_DIR);
 	bind_textdomain_codeset (PACKAGE, "UTF-8");
@@ -579,88 +536,14 @@ char* hdate_string( int const type_of_string, int const index, int const input_s
 				return _(holidays[hebrew_form][short_form][index]);
 				break;
 	case HDATE_STRING_OMER:
-				if (index > 0 && index < 50)
-				{
-					if (index < 11)
-					{
-						if (index == 2)  return_string_len = asprintf(&return_string, "%s_", count_days[0]);
-						else return_string_len = asprintf(&return_string, "%s_", count_days[index]);
-					}
-					else
-					{
-						if ((index%10) == 0)
-							return_string_len = asprintf(&return_string, "%s_", count_days[(index/10)+10]);
-						else if (index < 20)
-							return_string_len = asprintf(&return_string, "%s_%s_",
-													count_days[(index%10)], count_days[10]);
-						else return_string_len = asprintf(&return_string, "%s_%s%s_",
-														count_days[(index%10)], vav, count_days[(index/10)+10]);
-					}
-					if (return_string_len != -1) return return_string;
-				}
-				return NULL;
-				break;
 	case HDATE_STRING_INT:
-				if ((index > 0) && (index < 11000))
-				{
-					/// not hebrew form - return the number in decimal form
-					if (!hebrew_form)
-					{
-						return_string_len = asprintf (&return_string, "%d", index);
-						if (return_string_len == -1) return NULL;
-						return return_string;
-					}
-
-					/// HEBREW_NUMBER_BUFFER_SIZE 17	defined in hdate.h
-					return_string = malloc(HEBREW_NUMBER_BUFFER_SIZE);
-					if (return_string == NULL) return NULL;
-					
-					return_string[0] = '\0';
-
-					int n = index;
-
-					if (n >= 1000)
-					{
-						strncat (return_string, digits[0][n / 1000], H_CHAR_WIDTH);
-						n %= 1000;
-					}
-					while (n >= 400)
-					{
-						strncat (return_string, digits[2][4], H_CHAR_WIDTH);
-						n -= 400;
-					}
-					if (n >= 100)
-					{
-						strncat (return_string, digits[2][n / 100], H_CHAR_WIDTH);
-						n %= 100;
-					}
-					if (n >= 10)
-					{
-						if (n == 15 || n == 16)
-							n -= 9;
-						strncat (return_string, digits[1][n / 10], H_CHAR_WIDTH);
-						n %= 10;
-					}
-					if (n > 0)
-						strncat (return_string, digits[0][n], H_CHAR_WIDTH);
-						
-				 	/// possibly add the ' and " to hebrew numbers	
-					if (!short_form)
-					{
-						return_string_len = strlen (return_string);
-						if (return_string_len <= H_CHAR_WIDTH) strncat (return_string, "'", H_CHAR_WIDTH);
-						else
-						{
-							return_string[return_string_len + 1] = return_string[return_string_len];
-							return_string[return_string_len] = return_string[return_string_len - 1];
-							return_string[return_string_len - 1] = return_string[return_string_len - 2];
-							return_string[return_string_len - 2] = '\"';
-							return_string[return_string_len + 2] = '\0';
-						}
-					}
-					return return_string;
-				}
-				return NULL;
+				return_string_len = hdate_string_r (type_of_string, index, short_form, hebrew_form, NULL, 0);
+				if (return_string_len < 0) return NULL;
+				return_string = malloc (return_string_len + 1);
+				if (return_string == NULL) return NULL;
+				hdate_string_r (type_of_string, index, short_form, hebrew_form,
+								return_string, return_string_len + 1);
+				return return_string;
 				break;
 	} /// end of switch(type_of_string)
 
@@ -669,6 +552,686 @@ char* hdate_string( int const type_of_string, int const index, int const input_s
 
 
 
+/**
+ @brief build an integer or omer string into a buffer, see hdate_string_r
+*/
+static int
+build_string_r (int const type_of_string, int const index,
+				int const short_form, int const hebrew_form,
+				char *buffer, size_t const buffer_len)
+{
+	char number[HEBREW_NUMBER_BUFFER_SIZE];
+	size_t position = 0;
+	size_t number_len;
+	char *static_string;
+	int n;
+
+	if (buffer_len > 0) buffer[0] = '\0';
+
+	switch (type_of_string)
+	{
+	case HDATE_STRING_OMER:
+		if (index <= 0 || index >= 50) return -1;
+		if (index < 11)
+		{
+			if (index == 2) buffer_append (buffer, buffer_len, &position, count_days[0]);
+			else buffer_append (buffer, buffer_len, &position, count_days[index]);
+		}
+		else
+		{
+			if ((index%10) == 0)
+				buffer_append (buffer, buffer_len, &position, count_days[(index/10)+10]);
+			else if (index < 20)
+			{
+				buffer_append (buffer, buffer_len, &position, count_days[(index%10)]);
+				buffer_append (buffer, buffer_len, &position, "_");
+				buffer_append (buffer, buffer_len, &position, count_days[10]);
+			}
+			else
+			{
+				buffer_append (buffer, buffer_len, &position, count_days[(index%10)]);
+				buffer_append (buffer, buffer_len, &position, "_");
+				buffer_append (buffer, buffer_len, &position, vav);
+				buffer_append (buffer, buffer_len, &position, count_days[(index/10)+10]);
+			}
+		}
+		buffer_append (buffer, buffer_len, &position, "_");
+		return position;
+
+	case HDATE_STRING_INT:
+		if ((index <= 0) || (index >= 11000)) return -1;
+
+		/// not hebrew form - return the number in decimal form
+		if (!hebrew_form)
+			return snprintf (buffer, buffer_len, "%d", index);
+
+		number[0] = '\0';
+		number_len = 0;
+		n = index;
+
+		if (n >= 1000)
+		{
+			/// 10,000 and up: yud
+			buffer_append (number, sizeof (number), &number_len,
+						   (n < 10000) ? digits[0][n / 1000] : digits[1][1]);
+			n %= 1000;
+		}
+		while (n >= 400)
+		{
+			buffer_append (number, sizeof (number), &number_len, digits[2][4]);
+			n -= 400;
+		}
+		if (n >= 100)
+		{
+			buffer_append (number, sizeof (number), &number_len, digits[2][n / 100]);
+			n %= 100;
+		}
+		if (n >= 10)
+		{
+			if (n == 15 || n == 16)
+				n -= 9;
+			buffer_append (number, sizeof (number), &number_len, digits[1][n / 10]);
+			n %= 10;
+		}
+		if (n > 0)
+			buffer_append (number, sizeof (number), &number_len, digits[0][n]);
+
+		/// possibly add the ' and " to hebrew numbers
+		if (!short_form)
+		{
+			if (number_len <= H_CHAR_WIDTH)
+				buffer_append (number, sizeof (number), &number_len, "'");
+			else if (number_len + 1 < sizeof (number))
+			{
+				/// the " goes before the last letter
+				memmove (number + number_len - H_CHAR_WIDTH + 1,
+						 number + number_len - H_CHAR_WIDTH, H_CHAR_WIDTH + 1);
+				number[number_len - H_CHAR_WIDTH] = '\"';
+			}
+		}
+		buffer_append (buffer, buffer_len, &position, number);
+		return position;
+
+	default:
+		static_string = hdate_string (type_of_string, index, short_form, hebrew_form);
+		if (static_string == NULL) return -1;
+		buffer_append (buffer, buffer_len, &position, static_string);
+		return position;
+	}
+}
+
+/** Interned strings
+ **
+ ** The integers and omer days asked for most - days of the month and of
+ ** the omer (1 .. 49) and the years 5000 .. 6999 - are built once, the
+ ** first time one is asked for, into static tables, and handed out as
+ ** read-only pointers. pthread_once does the building, so a thread that
+ ** finds the tables being built sleeps until they are ready; building
+ ** takes a few microseconds. **/
+#define INTERNED_SMALL_MAX     49
+#define INTERNED_YEAR_MIN    5000
+#define INTERNED_YEAR_MAX    6999
+#define INTERNED_COUNT       (INTERNED_SMALL_MAX + INTERNED_YEAR_MAX - INTERNED_YEAR_MIN + 1)
+#define INTERNED_OMER_SIZE     32
+
+static pthread_once_t interned_once = PTHREAD_ONCE_INIT;
+static char interned_hebrew[2][INTERNED_COUNT][HEBREW_NUMBER_BUFFER_SIZE];
+static char interned_decimal[INTERNED_COUNT][8];
+static char interned_omer[INTERNED_SMALL_MAX][INTERNED_OMER_SIZE];
+
+/**
+ @brief position of a number in the interned tables, -1 if not there
+*/
+static int
+interned_index (int const n)
+{
+	if (n >= 1 && n <= INTERNED_SMALL_MAX) return n - 1;
+	if (n >= INTERNED_YEAR_MIN && n <= INTERNED_YEAR_MAX)
+		return INTERNED_SMALL_MAX + n - INTERNED_YEAR_MIN;
+	return -1;
+}
+
+/**
+ @brief build the interned tables; run by pthread_once
+*/
+static void
+interned_build_once (void)
+{
+	int i, n;
+
+	for (i = 0; i < INTERNED_COUNT; i++)
+	{
+		n = (i < INTERNED_SMALL_MAX) ? i + 1 : i - INTERNED_SMALL_MAX + INTERNED_YEAR_MIN;
+		build_string_r (HDATE_STRING_INT, n, HDATE_STRING_LONG, HDATE_STRING_HEBREW,
+						interned_hebrew[0][i], HEBREW_NUMBER_BUFFER_SIZE);
+		build_string_r (HDATE_STRING_INT, n, HDATE_STRING_SHORT, HDATE_STRING_HEBREW,
+						interned_hebrew[1][i], HEBREW_NUMBER_BUFFER_SIZE);
+		build_string_r (HDATE_STRING_INT, n, HDATE_STRING_LONG, HDATE_STRING_LOCAL,
+						interned_decimal[i], sizeof (interned_decimal[i]));
+	}
+	for (i = 0; i < INTERNED_SMALL_MAX; i++)
+		build_string_r (HDATE_STRING_OMER, i + 1, HDATE_STRING_LONG, HDATE_STRING_HEBREW,
+						interned_omer[i], INTERNED_OMER_SIZE);
+}
+
+/**
+ @brief build the interned tables, once
+*/
+static void
+interned_build ()
+{
+	pthread_once (&interned_once, interned_build_once);
+}
+
+/**
+ @brief   Return read-only string values for hdate information
+ @return  a pointer to a static string, that must not be freed or
+          changed; or a null pointer for an integer or omer day that
+          is not interned (see below), or upon failure. Integers
+          1 .. 49 and 5000 .. 6999 and all omer days are interned; for
+          other integers use hdate_string or hdate_string_r.
+ @param type_of_string 	as in hdate_string
+ @param index			as in hdate_string
+ @param short_form   0 = short format
+ @param hebrew_form  0 = not hebrew (native/embedded)
+*/
+const char *
+hdate_string_static (int const type_of_string, int const index,
+					 int const short_form, int const hebrew_form)
+{
+	int i;
+
+	switch (type_of_string)
+	{
+	case HDATE_STRING_INT:
+		i = interned_index (index);
+		if (i < 0) return NULL;
+		interned_build ();
+		if (!hebrew_form) return interned_decimal[i];
+		return interned_hebrew[short_form ? 1 : 0][i];
+
+	case HDATE_STRING_OMER:
+		if (index < 1 || index > INTERNED_SMALL_MAX) return NULL;
+		interned_build ();
+		return interned_omer[index - 1];
+
+	default:
+		return hdate_string (type_of_string, index, short_form, hebrew_form);
+	}
+}
+
+/**
+ @brief   Write string values for hdate information into a buffer
+ @return  the length of the string, not counting the terminating null,
+          even if it did not all fit into the buffer (as snprintf does);
+          -1 upon failure. Integers and omer days are copied from the
+          interned tables or built in place, without using the heap.
+ @param type_of_string 	as in hdate_string
+ @param index			as in hdate_string
+ @param short_form   0 = short format
+ @param hebrew_form  0 = not hebrew (native/embedded)
+ @param buffer       the buffer to write into, may be NULL if buffer_len is 0
+ @param buffer_len   the size of buffer
+*/
+int
+hdate_string_r (int const type_of_string, int const index,
+				int const short_form, int const hebrew_form,
+				char *buffer, size_t const buffer_len)
+{
+	const char *static_string;
+	size_t position = 0;
+
+	if (buffer_len > 0) buffer[0] = '\0';
+
+	static_string = hdate_string_static (type_of_string, index, short_form, hebrew_form);
+	if (static_string == NULL)
+		return build_string_r (type_of_string, index, short_form, hebrew_form,
+							   buffer, buffer_len);
+
+	buffer_append (buffer, buffer_len, &position, static_string);
+	return position;
+}
+
+/**
+ @brief write the hebrew date into a buffer, see hdate_format_date_r
+
+ @param hebrew_format HDATE_STRING_HEBREW or HDATE_STRING_LOCAL
+ @param ctx if not NULL, take month and holyday names from it
+*/
+static int
+format_date (hdate_struct const *h, int const diaspora, int const short_format,
+			 int const hebrew_format, hdate_format_context const *ctx,
+			 char *buffer, size_t const buffer_len)
+{
+	int omer_day 		= 0;
+	int holiday			= 0;
+	char *bet_h         = "";	// Hebrew prefix for Hebrew month
+	char number[HEBREW_NUMBER_BUFFER_SIZE];
+	const char *month_str, *holiday_str;
+	size_t position = 0;
+
+	if (buffer_len > 0) buffer[0] = '\0';
+
+	if (hebrew_format == HDATE_STRING_HEBREW) bet_h="ב";
+
+	if (ctx)
+		month_str = (h->hd_mon >= 1 && h->hd_mon <= 14) ?
+			ctx->hebrew_months[0][h->hd_mon - 1] : NULL;
+	else
+		month_str = hdate_string( HDATE_STRING_HMONTH , h->hd_mon, HDATE_STRING_LONG, hebrew_format);
+	if (month_str == NULL) month_str = "(null)";
+
+	if (hdate_string_r (HDATE_STRING_INT, h->hd_day, HDATE_STRING_LONG, hebrew_format,
+						number, sizeof (number)) < 0) return -1;
+	buffer_append (buffer, buffer_len, &position, number);
+	buffer_append (buffer, buffer_len, &position, " ");
+	if (!short_format) buffer_append (buffer, buffer_len, &position, bet_h);
+	buffer_append (buffer, buffer_len, &position, month_str);
+	buffer_append (buffer, buffer_len, &position, " ");
+	if (hdate_string_r (HDATE_STRING_INT, h->hd_year, HDATE_STRING_LONG, hebrew_format,
+						number, sizeof (number)) < 0) return -1;
+	buffer_append (buffer, buffer_len, &position, number);
+
+	/************************************************************
+	* short format
+	************************************************************/
+	if (short_format)
+	{
+		buffer_append (buffer, buffer_len, &position, "\n");
+		return position;
+	}
+
+	/************************************************************
+	* long (normal) format
+	************************************************************/
+
+	/// if a day in the omer print it
+	omer_day = hdate_get_omer_day(h);
+	if (omer_day != 0)
+	{
+		buffer_append (buffer, buffer_len, &position, ", ");
+		buffer_append (buffer, buffer_len, &position,
+			hdate_string_static (HDATE_STRING_OMER, omer_day, HDATE_STRING_LONG, hebrew_format));
+	}
+
+	/// if holiday print it
+	holiday = hdate_get_holyday (h, diaspora);
+	if (holiday != 0)
+	{
+		if (ctx)
+			holiday_str = (holiday <= 39) ? ctx->holidays[0][holiday] : NULL;
+		else
+			holiday_str = hdate_string( HDATE_STRING_HOLIDAY, holiday, HDATE_STRING_LONG, hebrew_format);
+		buffer_append (buffer, buffer_len, &position, ", ");
+		buffer_append (buffer, buffer_len, &position, holiday_str ? holiday_str : "(null)");
+	}
+
+	return position;
+}
+
+
+
+/**
+ @brief Write the hebrew date into a buffer.
+
+ The same text as hdate_get_format_date, written snprintf style into a
+ caller supplied buffer, without using the heap.
+
+ @return the length of the formated date, not counting the terminating
+ null, even if it did not all fit into the buffer; -1 upon failure.
+
+ @param h The hdate_struct of the date to print.
+ @param diaspora if true give diaspora holydays
+ @param short_format A short flag (true - returns a short string, false returns a long string).
+ @param buffer the buffer to write into, may be NULL if buffer_len is 0
+ @param buffer_len the size of buffer
+*/
+int
+hdate_format_date_r (hdate_struct const *h, int const diaspora, int const short_format,
+					 char *buffer, size_t const buffer_len)
+{
+	return format_date (h, diaspora, short_format,
+		hdate_is_hebrew_locale() ? HDATE_STRING_HEBREW : HDATE_STRING_LOCAL,
+		NULL, buffer, buffer_len);
+}
+
+
+
+/// Alternative latin character spellings of Hebrew Months
+/// and alternative names of Hebrew months in latin characters
+static const char *alt_latin_spell_hebrew_months[14] = {
+	"@(?(@(Y|J)ere@(ch|kh|h|x|j)?( |_|-)Ha?(-))@(A|Ai|Ay|Ei)t?(h)a?(h)n@(i|ee)m|Ti[cs]hr@([ie]?(y)|a[iy]))",  
+	"@(b@(oo|ou|u)?(l)l|?(Mar?( |-|_))@(?(C|K)h|X|J)e[sc]hva?(h)n)",
+	"Kisl@(e|[ae][iy])v",
+	"T@(e|[ae][iy])v@(e|[ae][iy])t",
+	"[SC]h?([e'])vat",
+	"Ad?(d)a?(h)r",
+	"N@(i|ee)s?(s)a?(h)n",
+	"@(ziv|zeev|@(I|e|Ee)?(y|yy|j)?(')a?(h)r)",
+	"[SC]@(i|ee)v?(v)a?(h)n",
+	"Tam?(m)uz",
+	"?(Mena@(ch|kh|x|j)@(e|ei|ey|ai|ay|i)m?( |_|-))A?(h)v",
+	"El?(l)@(u|ou|oo)l?(l)",
+	"Ad?(d)a?(h)r?( |-|_)@(A|1|I|alef|aleph)",
+	"Ad?(d)a?(h)r?( |-|_)@(B|2|II|bet?(h))"
+	};
+
+/// Alternative Hebrew names for Hebrew Months
+static const char *alt_hebrew_spell_hebrew_months[14] = {
+	"?(ירח?( |-|־)ה)איתנים",
+	"@(?(מר?( |-|־))חשון|בול)",
+	"",
+	"",
+	"",
+	"",
+	"",
+	"זיו",
+	"",
+	"",
+	"?(מנחם?( |-|־))אב",
+	"",
+	"אדר?( |-|־)א?(')",
+	"אדר?( |-|־)ב?(')"
+	};
+
+/** The month name trie holds every spelling that parse_month_text would
+ ** otherwise test one by one after the locale's own names: the Hebrew
+ ** month names, every string the alternative spelling patterns above can
+ ** match, and the English month names. It is built once, on first use,
+ ** by expanding the patterns (only the @( | ), ?( | ) and [ ] forms of
+ ** fnmatch extended globs are used) into a trie of ASCII case folded
+ ** bytes, which is then shrunk by sharing identical subtries. A name
+ ** then takes a single walk over its bytes, with no allocation. Lookups
+ ** made while another thread is building the trie (or if it could not
+ ** be built) go through the old scan instead, so nobody waits for it.
+ **
+ ** Where two spellings collide the first one tried by the old scan
+ ** wins, so the result is the same as the scan's. **/
+#define MONTH_TRIE_SCRATCH   16384
+#define MONTH_TRIE_SIZE       1024
+#define MONTH_TRIE_HASH_SIZE  2048
+#define MONTH_TRIE_EMPTY         0
+#define MONTH_TRIE_BUSY          1
+#define MONTH_TRIE_READY         2
+#define MONTH_TRIE_FAILED        3
+
+typedef struct
+{
+	unsigned char label;
+	unsigned char code;
+	unsigned short child;
+	unsigned short sibling;
+} month_trie_node;
+
+typedef struct
+{
+	unsigned char label;
+	unsigned char code;
+	int child;
+	int sibling;
+} month_scratch_node;
+
+typedef struct
+{
+	month_scratch_node node[MONTH_TRIE_SCRATCH];
+	int count;
+	unsigned short hash[MONTH_TRIE_HASH_SIZE];
+} month_scratch;
+
+static int month_trie_state;
+static int month_trie_count;
+/// node 0 is unused, so that 0 can mean no child or sibling
+static month_trie_node month_trie[MONTH_TRIE_SIZE];
+static unsigned short month_trie_root;
+
+/**
+ @brief ASCII case folding, as FNM_CASEFOLD and strcasecmp do for the
+ names in the trie
+*/
+static unsigned char
+month_fold (char const c)
+{
+	return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : (unsigned char) c;
+}
+
+/**
+ @brief find or add a child of a scratch node, keeping siblings sorted
+ @return the child, or -1 if the scratch is full
+*/
+static int
+month_scratch_child (month_scratch *s, int const node, unsigned char const label)
+{
+	int *link = &s->node[node].child;
+
+	while (*link >= 0 && s->node[*link].label < label)
+		link = &s->node[*link].sibling;
+	if (*link >= 0 && s->node[*link].label == label)
+		return *link;
+
+	if (s->count >= MONTH_TRIE_SCRATCH) return -1;
+	s->node[s->count].label = label;
+	s->node[s->count].code = 0;
+	s->node[s->count].child = -1;
+	s->node[s->count].sibling = *link;
+	*link = s->count;
+	return s->count++;
+}
+
+/**
+ @brief skip to the end of the group holding pattern
+ @return a pointer just past the group's closing parenthesis
+*/
+static const char *
+month_group_end (const char *pattern)
+{
+	int depth = 0;
+
+	for (; *pattern; pattern++)
+	{
+		if (*pattern == '(') depth++;
+		else if (*pattern == ')' && depth-- == 0) return pattern + 1;
+	}
+	return pattern;
+}
+
+/**
+ @brief add every string a pattern matches below a scratch node
+
+ Only the forms used by the alternative spellings are understood; any
+ other use of @ or ? fails the build.
+
+ @param pattern the rest of the pattern; a '|' or ')' ends the current
+ alternative and goes on after its group
+ @param node the scratch node reached so far
+ @param code the month code of the pattern
+ @return 0, or -1 if the scratch is full
+*/
+static int
+month_scratch_add (month_scratch *s, const char *pattern, int node, unsigned char const code)
+{
+	const char *next;
+
+	for (;;)
+	{
+		switch (*pattern)
+		{
+		case '\0':
+			if (!s->node[node].code) s->node[node].code = code;
+			return 0;
+		case '|':
+		case ')':
+			pattern = month_group_end (pattern + (*pattern == '|'));
+			break;
+		case '@':
+		case '?':
+			if (pattern[1] != '(') return -1;
+			next = pattern + 2;
+			if (*pattern == '?' &&
+				month_scratch_add (s, month_group_end (next), node, code) < 0) return -1;
+			/// each alternative in turn
+			for (;;)
+			{
+				if (month_scratch_add (s, next, node, code) < 0) return -1;
+				while (*next && *next != '|' && *next != ')')
+					next = (*next == '(') ? month_group_end (next + 1) : next + 1;
+				if (*next != '|') return 0;
+				next++;
+			}
+		case '[':
+			next = strchr (pattern, ']');
+			if (next == NULL) return -1;
+			for (pattern++; pattern < next; pattern++)
+			{
+				int child = month_scratch_child (s, node, month_fold (*pattern));
+				if (child < 0 || month_scratch_add (s, next + 1, child, code) < 0) return -1;
+			}
+			return 0;
+		default:
+			node = month_scratch_child (s, node, month_fold (*pattern));
+			if (node < 0) return -1;
+			pattern++;
+		}
+	}
+}
+
+/**
+ @brief add a literal name below the scratch root
+ @return 0, or -1 if the scratch is full
+*/
+static int
+month_scratch_add_name (month_scratch *s, const char *name, unsigned char const code)
+{
+	int node = 0;
+
+	for (; *name; name++)
+	{
+		node = month_scratch_child (s, node, month_fold (*name));
+		if (node < 0) return -1;
+	}
+	if (!s->node[node].code) s->node[node].code = code;
+	return 0;
+}
+
+/**
+ @brief copy a scratch subtrie (with its later siblings) into the trie,
+ sharing nodes that are already there
+ @return the trie node, 0 for none, or -1 if the trie is full
+*/
+static int
+month_trie_share (month_scratch *s, int const node)
+{
+	int child, sibling;
+	unsigned int slot;
+
+	if (node < 0) return 0;
+	child = month_trie_share (s, s->node[node].child);
+	sibling = month_trie_share (s, s->node[node].sibling);
+	if (child < 0 || sibling < 0) return -1;
+
+	slot = ((s->node[node].label * 31u + s->node[node].code) * 31u + child) * 31u + sibling;
+	for (slot &= MONTH_TRIE_HASH_SIZE - 1; s->hash[slot]; slot = (slot + 1) & (MONTH_TRIE_HASH_SIZE - 1))
+	{
+		month_trie_node *t = &month_trie[s->hash[slot]];
+		if (t->label == s->node[node].label && t->code == s->node[node].code &&
+			t->child == child && t->sibling == sibling)
+			return s->hash[slot];
+	}
+
+	if (month_trie_count >= MONTH_TRIE_SIZE) return -1;
+	month_trie[month_trie_count].label = s->node[node].label;
+	month_trie[month_trie_count].code = s->node[node].code;
+	month_trie[month_trie_count].child = child;
+	month_trie[month_trie_count].sibling = sibling;
+	s->hash[slot] = month_trie_count;
+	return month_trie_count++;
+}
+
+/**
+ @brief build the month name trie, once
+ @return true if the trie is ready, false if it could not be built or
+ another thread is building it
+*/
+static int
+month_trie_build ()
+{
+	month_scratch *s;
+	int i, state, root = -1;
+
+	state = __atomic_load_n (&month_trie_state, __ATOMIC_ACQUIRE);
+	if (state == MONTH_TRIE_READY) return TRUE;
+	if (state != MONTH_TRIE_EMPTY) return FALSE;
+
+	/// while another thread builds the trie, use the scan rather than wait
+	if (!__sync_bool_compare_and_swap (&month_trie_state, MONTH_TRIE_EMPTY, MONTH_TRIE_BUSY))
+		return __atomic_load_n (&month_trie_state, __ATOMIC_ACQUIRE) == MONTH_TRIE_READY;
+
+	s = (month_scratch *) malloc (sizeof (month_scratch));
+	if (s)
+	{
+		memset (s->hash, 0, sizeof (s->hash));
+		s->node[0].label = 0;
+		s->node[0].code = 0;
+		s->node[0].child = -1;
+		s->node[0].sibling = -1;
+		s->count = 1;
+		month_trie_count = 1;
+
+		/// in the order parse_month_text used to try them
+		for (i = 0; i < 14; i++)
+			if (month_scratch_add_name (s, hebrew_months[0][0][i], i + 101) < 0 ||
+				month_scratch_add_name (s, hebrew_months[1][0][i], i + 101) < 0) break;
+		if (i == 14)
+			for (i = 0; i < 14; i++)
+				if (month_scratch_add (s, alt_latin_spell_hebrew_months[i], 0, i + 101) < 0) break;
+		if (i == 14)
+			for (i = 0; i < 14; i++)
+				if (month_scratch_add (s, alt_hebrew_spell_hebrew_months[i], 0, i + 101) < 0) break;
+		if (i == 14)
+			for (i = 0; i < 12; i++)
+				if (month_scratch_add_name (s, gregorian_months[0][i], i + 1) < 0 ||
+					month_scratch_add_name (s, gregorian_months[1][i], i + 1) < 0) break;
+		if (i == 12)
+			root = month_trie_share (s, 0);
+		free (s);
+	}
+
+	if (root <= 0)
+	{
+		__atomic_store_n (&month_trie_state, MONTH_TRIE_FAILED, __ATOMIC_RELEASE);
+		return FALSE;
+	}
+	month_trie_root = root;
+	__atomic_store_n (&month_trie_state, MONTH_TRIE_READY, __ATOMIC_RELEASE);
+	return TRUE;
+}
+
+/**
+ @brief look a name up in the month name trie
+ @return the month code, or 0 if the name is not there
+*/
+static int
+month_trie_lookup (const char *text)
+{
+	int node = month_trie_root;
+	int child;
+	unsigned char c;
+
+	for (; *text; text++)
+	{
+		c = month_fold (*text);
+		for (child = month_trie[node].child;
+			 child && month_trie[child].label < c;
+			 child = month_trie[child].sibling)
+			;
+		if (!child || month_trie[child].label != c) return 0;
+		node = child;
+	}
+	return month_trie[node].code;
+}
+
+static int
+parse_month_text (const char* month_text, const char *const *locale_months);
+
 /************************************************************
 * hdate_parse_month_text_string
 * 
@@ -684,19 +1247,41 @@ char* hdate_string( int const type_of_string, int const index, int const input_s
 // Better idea maybe: return 101 - 114 for Hebrew
 int hdate_parse_month_text_string( const char* month_text )
 {
+	const char *locale_months[24];
+	int i;
+
 	/** This next call is supposed to guarantee that, if a locale
 	 ** exists, that the time spec for it is set. This is to enable
 	 ** full internationalization using nl_langinfo() **/
 	setlocale(LC_TIME,"");
 
+	for (i=0; i<24; i++)
+		locale_months[i] = nl_langinfo(langinfo_months[i]);
+
+	return parse_month_text (month_text, locale_months);
+}
+
+/**
+ @brief month number of a month name, see hdate_parse_month_text_string
+
+ @param month_text the month name
+ @param locale_months the locale's month names, full then abbreviated
+*/
+static int
+parse_month_text (const char* month_text, const char *const *locale_months)
+{
 	int i;
 	
 	/// Check for a match against the list of month strings for the
 	/// user's locale (both full month names and abbreviations)
 	for (i=0; i<24; i++)
-		if ( strcasecmp( month_text, nl_langinfo(langinfo_months[i])) == 0 )
+		if ( strcasecmp( month_text, locale_months[i]) == 0 )
 			return (i%12)+1;
 
+	/// Everything else at once, if the trie is to hand
+	if (month_trie_build ())
+		return month_trie_lookup (month_text);
+
 	/// Maybe the user entered a Hebrew month
 	for (i=0; i<14; i++)
 		if (( strcasecmp( month_text, hebrew_months[0][0][i]) == 0 ) ||
@@ -706,47 +1291,10 @@ int hdate_parse_month_text_string( const char* month_text )
 			/// in practice identical to the 'long' versions
 			return (i%14)+101;
 
-	/// Alternative latin character spellings of Hebrew Months
-	/// and alternative names of Hebrew months in latin characters
-	static char *alt_latin_spell_hebrew_months[14] = {
-		"@(?(@(Y|J)ere@(ch|kh|h|x|j)?( |_|-)Ha?(-))@(A|Ai|Ay|Ei)t?(h)a?(h)n@(i|ee)m|Ti[cs]hr@([ie]?(y)|a[iy]))",  
-		"@(b@(oo|ou|u)?(l)l|?(Mar?( |-|_))@(?(C|K)h|X|J)e[sc]hva?(h)n)",
-		"Kisl@(e|[ae][iy])v",
-		"T@(e|[ae][iy])v@(e|[ae][iy])t",
-		"[SC]h?([e'])vat",
-		"Ad?(d)a?(h)r",
-		"N@(i|ee)s?(s)a?(h)n",
-		"@(ziv|zeev|@(I|e|Ee)?(y|yy|j)?(')a?(h)r)",
-		"[SC]@(i|ee)v?(v)a?(h)n",
-		"Tam?(m)uz",
-		"?(Mena@(ch|kh|x|j)@(e|ei|ey|ai|ay|i)m?( |_|-))A?(h)v",
-		"El?(l)@(u|ou|oo)l?(l)",
-		"Ad?(d)a?(h)r?( |-|_)@(A|1|I|alef|aleph)",
-		"Ad?(d)a?(h)r?( |-|_)@(B|2|II|bet?(h))"
-		};
-
 	for (i=0; i<14; i++)
 		if ( fnmatch( alt_latin_spell_hebrew_months[i], month_text, FNM_EXTMATCH|FNM_CASEFOLD)==0 )
 			return (i+101);
 
-	/// Alternative Hebrew names for Hebrew Months
-	static char *alt_hebrew_spell_hebrew_months[14] = {
-		"?(ירח?( |-|־)ה)איתנים",
-		"@(?(מר?( |-|־))חשון|בול)",
-		"",
-		"",
-		"",
-		"",
-		"",
-		"זיו",
-		"",
-		"",
-		"?(מנחם?( |-|־))אב",
-		"",
-		"אדר?( |-|־)א?(')",
-		"אדר?( |-|־)ב?(')"
-		};
-
 	for (i=0; i<14; i++)
 		if ( fnmatch( alt_hebrew_spell_hebrew_months[i], month_text, FNM_EXTMATCH|FNM_CASEFOLD)==0 )
 			return (i+101);
@@ -756,7 +1304,7 @@ int hdate_parse_month_text_string( const char* month_text )
 	/** nl_langinfo may return a pointer to a null string if it does
 	 ** not have the requested value. In such a case return the English
 	 ** (or possibly gettext ?) string **/
-	for (i=0; i<14; i++)
+	for (i=0; i<12; i++)
 		if (( strcasecmp( month_text, gregorian_months[0][i]) == 0 ) ||
 			( strcasecmp( month_text, gregorian_months[1][i]) == 0 ) )
 			return (i%12)+1;
@@ -764,3 +1312,137 @@ int hdate_parse_month_text_string( const char* month_text )
 	
 	return 0;
 }
+
+/**
+ @brief copy a string into a fixed size context field
+*/
+static void
+context_copy (char *field, const char *text)
+{
+	size_t position = 0;
+
+	buffer_append (field, HDATE_CONTEXT_NAME_SIZE, &position, text ? text : "");
+}
+
+/**
+ @brief Set a formatting context from the current locale.
+
+ Probes the locale (hebrew or latin, the LC_TIME month and week day
+ names) once, so that the hdate_*_ctx functions need not.
+ Call again if the locale changes.
+
+ @param ctx the context to set
+ @param diaspora if true give diaspora holydays
+ @param short_form HDATE_STRING_SHORT or HDATE_STRING_LONG
+*/
+void
+hdate_format_context_init (hdate_format_context *ctx, int const diaspora, int const short_form)
+{
+	int i, s;
+
+	ctx->diaspora = diaspora ? 1 : 0;
+	ctx->short_form = short_form ? HDATE_STRING_SHORT : HDATE_STRING_LONG;
+	ctx->hebrew_form = hdate_is_hebrew_locale() ? HDATE_STRING_HEBREW : HDATE_STRING_LOCAL;
+
+	/// the same names hdate_string would give, as of now
+	for (s = 0; s < 2; s++)
+	{
+		for (i = 0; i < 12; i++)
+			context_copy (ctx->months[s][i], hdate_string (HDATE_STRING_GMONTH, i + 1, s, ctx->hebrew_form));
+		for (i = 0; i < 7; i++)
+			context_copy (ctx->days[s][i], hdate_string (HDATE_STRING_DOW, i + 1, s, ctx->hebrew_form));
+
+		/// gettext strings stay put while the catalog does
+		for (i = 0; i < 14; i++)
+			ctx->hebrew_months[s][i] = hdate_string (HDATE_STRING_HMONTH, i + 1, s, ctx->hebrew_form);
+		for (i = 0; i < 62; i++)
+			ctx->parashaot[s][i] = hdate_string (HDATE_STRING_PARASHA, i, s, ctx->hebrew_form);
+		for (i = 0; i < 40; i++)
+			ctx->holidays[s][i] = hdate_string (HDATE_STRING_HOLIDAY, i, s, ctx->hebrew_form);
+	}
+
+	/// and those hdate_parse_month_text_string would look at
+	setlocale(LC_TIME,"");
+	for (i = 0; i < 24; i++)
+		context_copy (ctx->locale_months[i], nl_langinfo(langinfo_months[i]));
+}
+
+/**
+ @brief   Return read-only string values for hdate information, using a context
+ @return  as hdate_string_static, but week days and gregorian months
+          come from the context, and the short and hebrew forms are
+          those of the context.
+ @param ctx the formatting context
+ @param type_of_string 	as in hdate_string
+ @param index			as in hdate_string
+*/
+const char *
+hdate_string_ctx (hdate_format_context const *ctx, int const type_of_string, int const index)
+{
+	int short_form = (ctx->short_form == HDATE_STRING_SHORT) ? 1 : 0;
+
+	switch (type_of_string)
+	{
+	case HDATE_STRING_DOW:
+		if (index < 1 || index > 7) return NULL;
+		return ctx->days[short_form][index - 1];
+	case HDATE_STRING_GMONTH:
+		if (index < 1 || index > 12) return NULL;
+		return ctx->months[short_form][index - 1];
+	case HDATE_STRING_HMONTH:
+		if (index < 1 || index > 14) return NULL;
+		return ctx->hebrew_months[short_form][index - 1];
+	case HDATE_STRING_PARASHA:
+		if (index < 1 || index > 61) return NULL;
+		return ctx->parashaot[short_form][index];
+	case HDATE_STRING_HOLIDAY:
+		if (index < 0 || index > 39) return NULL;
+		return ctx->holidays[short_form][index];
+	default:
+		return hdate_string_static (type_of_string, index, short_form, ctx->hebrew_form);
+	}
+}
+
+/**
+ @brief Write the hebrew date into a buffer, using a context.
+
+ As hdate_format_date_r, with the diaspora flag, short format and
+ hebrew locale taken from the context.
+
+ @param ctx the formatting context
+ @param h The hdate_struct of the date to print.
+ @param buffer the buffer to write into, may be NULL if buffer_len is 0
+ @param buffer_len the size of buffer
+ @return the length of the formated date, not counting the terminating
+ null, even if it did not all fit into the buffer; -1 upon failure.
+*/
+int
+hdate_format_date_ctx (hdate_format_context const *ctx, hdate_struct const *h,
+					   char *buffer, size_t const buffer_len)
+{
+	return format_date (h, ctx->diaspora, ctx->short_form == HDATE_STRING_SHORT,
+						ctx->hebrew_form, ctx, buffer, buffer_len);
+}
+
+/**
+ @brief Parse a month name, using a context.
+
+ As hdate_parse_month_text_string, with the locale's month names taken
+ from the context instead of setting the locale.
+
+ @param ctx the formatting context
+ @param month_text the month name
+ @return month number 1 - 12 for gregorian, 101 - 114 for Hebrew,
+ 0 on failure
+*/
+int
+hdate_parse_month_text_ctx (hdate_format_context const *ctx, const char* month_text)
+{
+	const char *locale_months[24];
+	int i;
+
+	for (i=0; i<24; i++)
+		locale_months[i] = ctx->locale_months[i];
+
+	return parse_month_text (month_text, locale_months);
+}
@@ -25,11 +25,15 @@
 #include <time.h>
 #include <stdio.h>
 #include <math.h>
-#include <errno.h>
 
 #include "hdate.h"
 #include "support.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HDATE_X86_SIMD
+#include <immintrin.h>
+#endif
+
 /**
  @brief days from 1 january
 
@@ -56,76 +60,72 @@ hdate_get_day_of_year (const int day, const int month, const int year)
 }
 
 /**
- @brief utc sun times for altitude at a gregorian date - higher precision
+ @brief sun position terms of a day of the year
 
- Returns the sunset and sunrise times in minutes from 00:00 (utc time)
- if sun altitude in sunrise is deg degrees.
- This function only works for altitudes sun really is.
- If the sun never get to this altitude, the returned sunset and sunrise values 
- will be negative. This can happen in low altitude when latitude is 
- nearing the poles in winter times, the sun never goes very high in 
- the sky there.
-
- @param day this day of month
- @param month this month
- @param year this year
- @param longitude longitude to use in calculations
- @param latitude latitude to use in calculations
- @param deg degrees of sun's altitude (0 -  Zenith .. 90 - Horizon)
- @param sunrise return the utc sunrise in seconds
- @param sunset return the utc sunset in seconds
+ @param day_of_year the day from 1 january, 1 .. 366
+ @param eqtime return the diffference betwen sun noon and clock noon in seconds
+ @param decl return the sun declination in radians
 */
-void
-hdate_get_utc_sun_time_deg_seconds ( const int day, const int month, const int year,
-							 const double latitude, const double longitude, const double deg,
-							 int *sunrise, int *sunset)
+static void
+sun_day_terms (const int day_of_year, double *eqtime, double *decl)
 {
 	double gamma;		/* location of sun in yearly cycle in radians */
-	double eqtime;		/* diffference betwen sun noon and clock noon */
-	double decl;		/* sun declination */
-	double hour_angle;	/* solar hour angle */
-	double sunrise_angle = M_PI * deg / 180.0; /* sun angle at sunrise/set */
-	double latitude_radians = M_PI * latitude / 180.0; /* ratio is 2pi/360 */
-
-
-	int day_of_year;
-
-	/* get the day of year */
-	day_of_year = hdate_get_day_of_year (day, month, year);
 
 	/* get radians of sun orbit around earth =) */
 	gamma = 2.0 * M_PI * ((double)(day_of_year - 1) / 365.0);
 
 	/* get the diff betwen suns clock and wall clock in minutes */
-	eqtime = 229.18 * (0.000075 + 0.001868 * cos (gamma)
+	*eqtime = 229.18 * (0.000075 + 0.001868 * cos (gamma)
 		- 0.032077 * sin (gamma) - 0.014615 * cos (2.0 * gamma)
 		- 0.040849 * sin (2.0 * gamma));
 	// FIXME - figure out the math above and convert it to directly
 	// calculate seconds. For now, ...
-	eqtime = eqtime * 60;
+	*eqtime = *eqtime * 60;
 
 	/* calculate sun's declination at the equator in radians */
-	decl = 0.006918 - 0.399912 * cos (gamma) + 0.070257 * sin (gamma)
+	*decl = 0.006918 - 0.399912 * cos (gamma) + 0.070257 * sin (gamma)
 		- 0.006758 * cos (2.0 * gamma) + 0.000907 * sin (2.0 * gamma)
 		- 0.002697 * cos (3.0 * gamma) + 0.00148 * sin (3.0 * gamma);
+}
 
-	/* the sun real time diff from noon at sunset/rise in radians */
-	errno = 0;
-	hour_angle = acos (cos (sunrise_angle) / (cos (latitude_radians) * cos (decl))
-				- tan (latitude_radians) * tan (decl));
+/** sun position of the date, common to all locations */
+typedef struct
+{
+	double cos_angle;	/* cos of the sun altitude */
+	double cos_decl;	/* cos of the sun declination */
+	double tan_decl;	/* tan of the sun declination */
+	double eqtime;		/* sun noon - clock noon in seconds */
+} sun_date_terms;
 
-	/* check for too high altitudes and return negative values */
-	if (errno == EDOM)
+/**
+ @brief utc sun times in seconds from the cos of the sun's hour angle
+
+ @param x cos of the sun real time diff from noon at sunset/rise
+ @param longitude longitude to use in calculations
+ @param eqtime sun noon - clock noon in seconds
+ @param sunrise return the utc sunrise in seconds, -720 if none
+ @param sunset return the utc sunset in seconds, -720 if none
+ @return HDATE_SUN_NORMAL, HDATE_SUN_NEVER_RISES or HDATE_SUN_NEVER_SETS
+*/
+static int
+sun_times_of_hour_angle (const double x, const double longitude, const double eqtime,
+	int *sunrise, int *sunset)
+{
+	double hour_angle;
+
+	/* acos is only defined for -1 .. 1, out of it the sun never gets to
+	   this altitude, too high (NEVER_RISES) or too low (NEVER_SETS) */
+	if (!(x >= -1.0 && x <= 1.0))
 	{
 		*sunrise = -720;
 		*sunset = -720;
-		return;
+		return (x < -1.0) ? HDATE_SUN_NEVER_SETS : HDATE_SUN_NEVER_RISES;
 	}
 
 	// when we used minutes, ratio was 1440min/2pi
 	// hour_angle = 720.0 * hour_angle / M_PI;
 	// now, using seconds, ratio should be 86400sec/2pi
-	hour_angle = 43200.0 * hour_angle / M_PI;
+	hour_angle = 43200.0 * acos (x) / M_PI;
 
 	// get sunset/rise times in utc wall clock in minutes from 00:00 time
 	//*sunrise = (int)(720.0 - 4.0 * longitude - hour_angle - eqtime);
@@ -134,7 +134,90 @@ hdate_get_utc_sun_time_deg_seconds ( const int day, const int month, const int y
 	*sunrise = (int)(43200.0 - 240.0 * longitude - hour_angle - eqtime);
 	*sunset = (int)(43200.0 - 240.0 * longitude + hour_angle - eqtime);
 
-	return;
+	return HDATE_SUN_NORMAL;
+}
+
+/**
+ @brief utc sun times in seconds of one location
+ @return HDATE_SUN_NORMAL, HDATE_SUN_NEVER_RISES or HDATE_SUN_NEVER_SETS
+*/
+static int
+sun_times_scalar (const double latitude, const double longitude,
+	sun_date_terms const *t, int *sunrise, int *sunset)
+{
+	double latitude_radians = M_PI * latitude / 180.0;
+	double x;
+
+	/* cos of the sun real time diff from noon at sunset/rise */
+	x = t->cos_angle / (cos (latitude_radians) * t->cos_decl)
+		- tan (latitude_radians) * t->tan_decl;
+
+	return sun_times_of_hour_angle (x, longitude, t->eqtime, sunrise, sunset);
+}
+
+/**
+ @brief utc sun times for altitude at a gregorian date - reentrant
+
+ Returns the sunset and sunrise times in seconds from 00:00 (utc time)
+ if sun altitude in sunrise is deg degrees, and whether the sun gets
+ to that altitude at all. Unlike the functions before it, errno is
+ neither used nor changed.
+
+ @param day this day of month
+ @param month this month
+ @param year this year
+ @param longitude longitude to use in calculations
+ @param latitude latitude to use in calculations
+ @param deg degrees of sun's altitude (0 -  Zenith .. 90 - Horizon)
+ @param sunrise return the utc sunrise in seconds, -720 if none
+ @param sunset return the utc sunset in seconds, -720 if none
+ @return HDATE_SUN_NORMAL, or HDATE_SUN_NEVER_RISES if the sun stays
+	below the altitude all day, HDATE_SUN_NEVER_SETS if above it
+*/
+int
+hdate_get_utc_sun_time_deg_seconds_r ( const int day, const int month, const int year,
+							 const double latitude, const double longitude, const double deg,
+							 int *sunrise, int *sunset)
+{
+	sun_date_terms t;
+	double decl;		/* sun declination */
+
+	/* get the sun position of the day of year */
+	sun_day_terms (hdate_get_day_of_year (day, month, year), &t.eqtime, &decl);
+	t.cos_angle = cos (M_PI * deg / 180.0);
+	t.cos_decl = cos (decl);
+	t.tan_decl = tan (decl);
+
+	return sun_times_scalar (latitude, longitude, &t, sunrise, sunset);
+}
+
+/**
+ @brief utc sun times for altitude at a gregorian date - higher precision
+
+ Returns the sunset and sunrise times in minutes from 00:00 (utc time)
+ if sun altitude in sunrise is deg degrees.
+ This function only works for altitudes sun really is.
+ If the sun never get to this altitude, the returned sunset and sunrise values 
+ will be negative. This can happen in low altitude when latitude is 
+ nearing the poles in winter times, the sun never goes very high in 
+ the sky there.
+
+ @param day this day of month
+ @param month this month
+ @param year this year
+ @param longitude longitude to use in calculations
+ @param latitude latitude to use in calculations
+ @param deg degrees of sun's altitude (0 -  Zenith .. 90 - Horizon)
+ @param sunrise return the utc sunrise in seconds
+ @param sunset return the utc sunset in seconds
+*/
+void
+hdate_get_utc_sun_time_deg_seconds ( const int day, const int month, const int year,
+							 const double latitude, const double longitude, const double deg,
+							 int *sunrise, int *sunset)
+{
+	hdate_get_utc_sun_time_deg_seconds_r (day, month, year, latitude, longitude, deg,
+							 sunrise, sunset);
 }
 
 /**
@@ -230,3 +313,470 @@ hdate_get_utc_sun_time_full (const int day, const int month, const int year,
 	
 	return;
 }
+
+/**
+ @brief set a sun time context for a location
+
+ @param loc the context to set
+ @param latitude latitude to use in calculations
+ @param longitude longitude to use in calculations
+*/
+void
+hdate_sun_location_init (hdate_sun_location *loc,
+	const double latitude, const double longitude)
+{
+	/* the sun altitudes of hdate_get_utc_sun_time_full */
+	static const double degs[HDATE_SUN_ANGLES] = {90.833, 106.01, 101.0, 96.0, 98.5};
+	double latitude_radians = M_PI * latitude / 180.0;
+	int i;
+
+	loc->latitude = latitude;
+	loc->longitude = longitude;
+	loc->cos_latitude = cos (latitude_radians);
+	loc->tan_latitude = tan (latitude_radians);
+	for (i = 0; i < HDATE_SUN_ANGLES; i++)
+		loc->cos_angle[i] = cos (M_PI * degs[i] / 180.0);
+}
+
+/**
+ @brief utc sun times in minutes for one altitude, from the day terms
+ @return HDATE_SUN_NORMAL, HDATE_SUN_NEVER_RISES or HDATE_SUN_NEVER_SETS
+*/
+static int
+sun_location_angle (hdate_sun_location const *loc, const int angle,
+	const double cos_lat_decl, const double tan_lat_decl, const double eqtime,
+	int *sunrise, int *sunset)
+{
+	int status;
+
+	status = sun_times_of_hour_angle (loc->cos_angle[angle] / cos_lat_decl - tan_lat_decl,
+		loc->longitude, eqtime, sunrise, sunset);
+
+	/* rounded to minutes, as hdate_get_utc_sun_time_deg does */
+	*sunrise = (*sunrise + 30) / 60;
+	*sunset = (*sunset + 30) / 60;
+
+	return status;
+}
+
+/**
+ @brief utc sun times for a range of days at a location
+
+ Same results as hdate_get_utc_sun_time_full for each day, with the
+ location terms taken from the context and the sun position of each
+ day computed once for all the sun altitudes. Each output is an array
+ of count entries, and may be NULL; status has HDATE_SUN_ANGLES
+ entries a day.
+
+ @param loc the location context
+ @param jd julian day number of the first day
+ @param count number of days
+ @param sun_hour return the length of shaa zaminit in minutes
+ @param first_light return the utc alut ha-shachar in minutes
+ @param talit return the utc tphilin and talit in minutes
+ @param sunrise return the utc sunrise in minutes
+ @param midday return the utc midday in minutes
+ @param sunset return the utc sunset in minutes
+ @param first_stars return the utc tzeit hacochavim in minutes
+ @param three_stars return the utc shlosha cochavim in minutes
+ @param status return the HDATE_SUN_* status of each altitude of each day
+*/
+void
+hdate_sun_location_times (hdate_sun_location const *loc, int jd, int count,
+	int *sun_hour, int *first_light, int *talit, int *sunrise,
+	int *midday, int *sunset, int *first_stars, int *three_stars,
+	int *status)
+{
+	double eqtime, decl;
+	double cos_lat_decl, tan_lat_decl;
+	int day, month, year;
+	int day_of_year, days_in_year;
+	int rise, set, place_holder;
+	int angle_status[HDATE_SUN_ANGLES];
+	int i, k;
+
+	hdate_jd_to_gdate (jd, &day, &month, &year);
+	day_of_year = hdate_get_day_of_year (day, month, year);
+	days_in_year = hdate_get_day_of_year (31, 12, year);
+
+	for (i = 0; i < count; i++, day_of_year++)
+	{
+		if (day_of_year > days_in_year)
+		{
+			year++;
+			day_of_year = 1;
+			days_in_year = hdate_get_day_of_year (31, 12, year);
+		}
+
+		sun_day_terms (day_of_year, &eqtime, &decl);
+		cos_lat_decl = loc->cos_latitude * cos (decl);
+		tan_lat_decl = loc->tan_latitude * tan (decl);
+
+		/* sunset and rise time */
+		angle_status[0] = sun_location_angle (loc, 0, cos_lat_decl, tan_lat_decl, eqtime,
+			&rise, &set);
+		if (sunrise) sunrise[i] = rise;
+		if (sunset) sunset[i] = set;
+
+		/* shaa zmanit by gara, 1/12 of light time */
+		if (sun_hour) sun_hour[i] = (set - rise) / 12;
+		if (midday) midday[i] = (set + rise) / 2;
+
+		/* get times of the different sun angles */
+		if (first_light || status)
+			angle_status[1] = sun_location_angle (loc, 1, cos_lat_decl, tan_lat_decl, eqtime,
+				first_light ? &first_light[i] : &place_holder, &place_holder);
+		if (talit || status)
+			angle_status[2] = sun_location_angle (loc, 2, cos_lat_decl, tan_lat_decl, eqtime,
+				talit ? &talit[i] : &place_holder, &place_holder);
+		if (first_stars || status)
+			angle_status[3] = sun_location_angle (loc, 3, cos_lat_decl, tan_lat_decl, eqtime,
+				&place_holder, first_stars ? &first_stars[i] : &place_holder);
+		if (three_stars || status)
+			angle_status[4] = sun_location_angle (loc, 4, cos_lat_decl, tan_lat_decl, eqtime,
+				&place_holder, three_stars ? &three_stars[i] : &place_holder);
+
+		if (status)
+			for (k = 0; k < HDATE_SUN_ANGLES; k++)
+				status[i * HDATE_SUN_ANGLES + k] = angle_status[k];
+	}
+}
+
+/** Many locations, one date
+ **
+ ** hdate_get_utc_sun_time_deg_seconds_array computes the sun position of
+ ** the date once; what is left for each location is the cos / tan of
+ ** its latitude and the acos of the hour angle. On x86 these are done 2
+ ** (SSE2) or 4 (AVX2) locations at a time, with the fdlibm polynomials
+ ** for sin, cos and acos, the choice being made at run time; the kernels
+ ** carry their own target attributes, so i386 builds without -msse2
+ ** still compile and fall back to the scalar code. The polynomials agree
+ ** with libm to an ulp or two, so a time may differ from the scalar one
+ ** by a second when it falls on a whole second.
+ ** Latitudes beyond +-90 degrees or longitudes beyond +-360 are handed
+ ** to the scalar code. **/
+
+#ifdef HDATE_X86_SIMD
+
+/** fdlibm k_sin.c, k_cos.c and e_acos.c coefficients */
+#define SUN_PIO4     7.85398163397448278999e-01
+#define SUN_PIO2_HI  1.57079632679489655800e+00
+#define SUN_PIO2_LO  6.12323399573676603587e-17
+#define SUN_S1      -1.66666666666666324348e-01
+#define SUN_S2       8.33333333332248946124e-03
+#define SUN_S3      -1.98412698298579493134e-04
+#define SUN_S4       2.75573137070700676789e-06
+#define SUN_S5      -2.50507602534068634195e-08
+#define SUN_S6       1.58969099521155010221e-10
+#define SUN_C1       4.16666666666666019037e-02
+#define SUN_C2      -1.38888888888741095749e-03
+#define SUN_C3       2.48015872894767294178e-05
+#define SUN_C4      -2.75573143513906633035e-07
+#define SUN_C5       2.08757232129817482790e-09
+#define SUN_C6      -1.13596475577881948265e-11
+#define SUN_PS0      1.66666666666666657415e-01
+#define SUN_PS1     -3.25565818622400915405e-01
+#define SUN_PS2      2.01212532134862925881e-01
+#define SUN_PS3     -4.00555345006794114027e-02
+#define SUN_PS4      7.91534994289814532176e-04
+#define SUN_PS5      3.47933107596021167570e-05
+#define SUN_QS1     -2.40339491173441421878e+00
+#define SUN_QS2      2.02094576023350569471e+00
+#define SUN_QS3     -6.88283971605453293030e-01
+#define SUN_QS4      7.70381505559019352791e-02
+
+#define SSE2_SET(c) _mm_set1_pd (c)
+#define SSE2_BLEND(m, a, b) _mm_or_pd (_mm_and_pd (m, a), _mm_andnot_pd (m, b))
+
+/**
+ @brief low 32 bits of each 64 bit lane mask, two lanes
+*/
+__attribute__ ((target ("sse2")))
+static inline __m128i
+mask_epi32_sse2 (__m128d m)
+{
+	return _mm_shuffle_epi32 (_mm_castpd_si128 (m), _MM_SHUFFLE (3, 3, 2, 0));
+}
+
+/**
+ @brief utc sun times in seconds of two locations
+ @return FALSE if a location was out of range and nothing was written
+*/
+__attribute__ ((target ("sse2")))
+static int
+sun_times_sse2 (double const *latitude, double const *longitude,
+	sun_date_terms const *t, int *sunrise, int *sunset, int *status)
+{
+	__m128d lat, lon, phi, sign, a, big, r, z, p, q, s, c, x;
+	__m128d valid, never_sets, small, acs, w, ha, base;
+	__m128d sign_mask = _mm_castsi128_pd (_mm_set1_epi64x (0x8000000000000000LL));
+	__m128i ok, rise, set, st;
+
+	lat = _mm_loadu_pd (latitude);
+	lon = _mm_loadu_pd (longitude);
+	valid = _mm_and_pd (_mm_and_pd (_mm_cmpge_pd (lat, SSE2_SET (-90.0)), _mm_cmple_pd (lat, SSE2_SET (90.0))),
+						_mm_and_pd (_mm_cmpge_pd (lon, SSE2_SET (-360.0)), _mm_cmple_pd (lon, SSE2_SET (360.0))));
+	if (_mm_movemask_pd (valid) != 3) return FALSE;
+
+	/* sin and cos of the latitude, |phi| <= pi/2 */
+	phi = _mm_div_pd (_mm_mul_pd (SSE2_SET (M_PI), lat), SSE2_SET (180.0));
+	sign = _mm_and_pd (phi, sign_mask);
+	a = _mm_andnot_pd (sign_mask, phi);
+	big = _mm_cmpgt_pd (a, SSE2_SET (SUN_PIO4));
+	r = SSE2_BLEND (big, _mm_add_pd (_mm_sub_pd (SSE2_SET (SUN_PIO2_HI), a), SSE2_SET (SUN_PIO2_LO)), a);
+	z = _mm_mul_pd (r, r);
+	p = _mm_add_pd (SSE2_SET (SUN_S5), _mm_mul_pd (z, SSE2_SET (SUN_S6)));
+	p = _mm_add_pd (SSE2_SET (SUN_S4), _mm_mul_pd (z, p));
+	p = _mm_add_pd (SSE2_SET (SUN_S3), _mm_mul_pd (z, p));
+	p = _mm_add_pd (SSE2_SET (SUN_S2), _mm_mul_pd (z, p));
+	p = _mm_add_pd (SSE2_SET (SUN_S1), _mm_mul_pd (z, p));
+	s = _mm_add_pd (r, _mm_mul_pd (_mm_mul_pd (r, z), p));
+	p = _mm_add_pd (SSE2_SET (SUN_C5), _mm_mul_pd (z, SSE2_SET (SUN_C6)));
+	p = _mm_add_pd (SSE2_SET (SUN_C4), _mm_mul_pd (z, p));
+	p = _mm_add_pd (SSE2_SET (SUN_C3), _mm_mul_pd (z, p));
+	p = _mm_add_pd (SSE2_SET (SUN_C2), _mm_mul_pd (z, p));
+	p = _mm_add_pd (SSE2_SET (SUN_C1), _mm_mul_pd (z, p));
+	c = _mm_add_pd (_mm_sub_pd (SSE2_SET (1.0), _mm_mul_pd (SSE2_SET (0.5), z)), _mm_mul_pd (_mm_mul_pd (z, z), p));
+	a = _mm_xor_pd (SSE2_BLEND (big, c, s), sign);	/* sin */
+	c = SSE2_BLEND (big, s, c);						/* cos */
+
+	/* cos of the hour angle */
+	x = _mm_sub_pd (_mm_div_pd (SSE2_SET (t->cos_angle), _mm_mul_pd (c, SSE2_SET (t->cos_decl))),
+					_mm_mul_pd (_mm_div_pd (a, c), SSE2_SET (t->tan_decl)));
+	valid = _mm_and_pd (_mm_cmpge_pd (x, SSE2_SET (-1.0)), _mm_cmple_pd (x, SSE2_SET (1.0)));
+	never_sets = _mm_cmplt_pd (x, SSE2_SET (-1.0));
+	x = _mm_and_pd (valid, x);
+
+	/* acos */
+	a = _mm_andnot_pd (sign_mask, x);
+	small = _mm_cmplt_pd (a, SSE2_SET (0.5));
+	z = SSE2_BLEND (small, _mm_mul_pd (x, x), _mm_mul_pd (_mm_sub_pd (SSE2_SET (1.0), a), SSE2_SET (0.5)));
+	p = _mm_add_pd (SSE2_SET (SUN_PS4), _mm_mul_pd (z, SSE2_SET (SUN_PS5)));
+	p = _mm_add_pd (SSE2_SET (SUN_PS3), _mm_mul_pd (z, p));
+	p = _mm_add_pd (SSE2_SET (SUN_PS2), _mm_mul_pd (z, p));
+	p = _mm_add_pd (SSE2_SET (SUN_PS1), _mm_mul_pd (z, p));
+	p = _mm_add_pd (SSE2_SET (SUN_PS0), _mm_mul_pd (z, p));
+	p = _mm_mul_pd (z, p);
+	q = _mm_add_pd (SSE2_SET (SUN_QS3), _mm_mul_pd (z, SSE2_SET (SUN_QS4)));
+	q = _mm_add_pd (SSE2_SET (SUN_QS2), _mm_mul_pd (z, q));
+	q = _mm_add_pd (SSE2_SET (SUN_QS1), _mm_mul_pd (z, q));
+	q = _mm_add_pd (SSE2_SET (1.0), _mm_mul_pd (z, q));
+	r = _mm_div_pd (p, q);
+	acs = _mm_sub_pd (SSE2_SET (SUN_PIO2_HI),
+					  _mm_sub_pd (x, _mm_sub_pd (SSE2_SET (SUN_PIO2_LO), _mm_mul_pd (x, r))));
+	s = _mm_sqrt_pd (z);
+	w = _mm_add_pd (s, _mm_mul_pd (s, r));
+	w = SSE2_BLEND (_mm_cmplt_pd (x, _mm_setzero_pd ()),
+					_mm_sub_pd (SSE2_SET (M_PI), _mm_add_pd (w, w)), _mm_add_pd (w, w));
+	acs = SSE2_BLEND (small, acs, w);
+
+	/* utc times in seconds */
+	ha = _mm_div_pd (_mm_mul_pd (SSE2_SET (43200.0), acs), SSE2_SET (M_PI));
+	base = _mm_sub_pd (SSE2_SET (43200.0), _mm_mul_pd (SSE2_SET (240.0), lon));
+	rise = _mm_cvttpd_epi32 (_mm_sub_pd (_mm_sub_pd (base, ha), SSE2_SET (t->eqtime)));
+	set = _mm_cvttpd_epi32 (_mm_sub_pd (_mm_add_pd (base, ha), SSE2_SET (t->eqtime)));
+
+	ok = mask_epi32_sse2 (valid);
+	rise = _mm_or_si128 (_mm_and_si128 (ok, rise), _mm_andnot_si128 (ok, _mm_set1_epi32 (-720)));
+	set = _mm_or_si128 (_mm_and_si128 (ok, set), _mm_andnot_si128 (ok, _mm_set1_epi32 (-720)));
+	st = mask_epi32_sse2 (never_sets);
+	st = _mm_or_si128 (_mm_and_si128 (st, _mm_set1_epi32 (HDATE_SUN_NEVER_SETS)),
+					   _mm_andnot_si128 (st, _mm_set1_epi32 (HDATE_SUN_NEVER_RISES)));
+	st = _mm_andnot_si128 (ok, st);
+
+	_mm_storel_epi64 ((__m128i *) sunrise, rise);
+	_mm_storel_epi64 ((__m128i *) sunset, set);
+	if (status) _mm_storel_epi64 ((__m128i *) status, st);
+
+	return TRUE;
+}
+
+#define AVX2_SET(c) _mm256_set1_pd (c)
+
+/**
+ @brief low 32 bits of each 64 bit lane mask, four lanes
+*/
+__attribute__ ((target ("avx2")))
+static inline __m128i
+mask_epi32_avx2 (__m256d m)
+{
+	return _mm256_castsi256_si128 (_mm256_permutevar8x32_epi32 (_mm256_castpd_si256 (m),
+		_mm256_setr_epi32 (0, 2, 4, 6, 0, 2, 4, 6)));
+}
+
+/**
+ @brief utc sun times in seconds of four locations
+ @return FALSE if a location was out of range and nothing was written
+*/
+__attribute__ ((target ("avx2")))
+static int
+sun_times_avx2 (double const *latitude, double const *longitude,
+	sun_date_terms const *t, int *sunrise, int *sunset, int *status)
+{
+	__m256d lat, lon, phi, sign, a, big, r, z, p, q, s, c, x;
+	__m256d valid, never_sets, small, acs, w, ha, base;
+	__m256d sign_mask = AVX2_SET (-0.0);
+	__m128i ok, rise, set, st;
+
+	lat = _mm256_loadu_pd (latitude);
+	lon = _mm256_loadu_pd (longitude);
+	valid = _mm256_and_pd (_mm256_and_pd (_mm256_cmp_pd (lat, AVX2_SET (-90.0), _CMP_GE_OQ),
+										  _mm256_cmp_pd (lat, AVX2_SET (90.0), _CMP_LE_OQ)),
+						   _mm256_and_pd (_mm256_cmp_pd (lon, AVX2_SET (-360.0), _CMP_GE_OQ),
+										  _mm256_cmp_pd (lon, AVX2_SET (360.0), _CMP_LE_OQ)));
+	if (_mm256_movemask_pd (valid) != 15) return FALSE;
+
+	/* sin and cos of the latitude, |phi| <= pi/2 */
+	phi = _mm256_div_pd (_mm256_mul_pd (AVX2_SET (M_PI), lat), AVX2_SET (180.0));
+	sign = _mm256_and_pd (phi, sign_mask);
+	a = _mm256_andnot_pd (sign_mask, phi);
+	big = _mm256_cmp_pd (a, AVX2_SET (SUN_PIO4), _CMP_GT_OQ);
+	r = _mm256_blendv_pd (a, _mm256_add_pd (_mm256_sub_pd (AVX2_SET (SUN_PIO2_HI), a), AVX2_SET (SUN_PIO2_LO)), big);
+	z = _mm256_mul_pd (r, r);
+	p = _mm256_add_pd (AVX2_SET (SUN_S5), _mm256_mul_pd (z, AVX2_SET (SUN_S6)));
+	p = _mm256_add_pd (AVX2_SET (SUN_S4), _mm256_mul_pd (z, p));
+	p = _mm256_add_pd (AVX2_SET (SUN_S3), _mm256_mul_pd (z, p));
+	p = _mm256_add_pd (AVX2_SET (SUN_S2), _mm256_mul_pd (z, p));
+	p = _mm256_add_pd (AVX2_SET (SUN_S1), _mm256_mul_pd (z, p));
+	s = _mm256_add_pd (r, _mm256_mul_pd (_mm256_mul_pd (r, z), p));
+	p = _mm256_add_pd (AVX2_SET (SUN_C5), _mm256_mul_pd (z, AVX2_SET (SUN_C6)));
+	p = _mm256_add_pd (AVX2_SET (SUN_C4), _mm256_mul_pd (z, p));
+	p = _mm256_add_pd (AVX2_SET (SUN_C3), _mm256_mul_pd (z, p));
+	p = _mm256_add_pd (AVX2_SET (SUN_C2), _mm256_mul_pd (z, p));
+	p = _mm256_add_pd (AVX2_SET (SUN_C1), _mm256_mul_pd (z, p));
+	c = _mm256_add_pd (_mm256_sub_pd (AVX2_SET (1.0), _mm256_mul_pd (AVX2_SET (0.5), z)),
+					   _mm256_mul_pd (_mm256_mul_pd (z, z), p));
+	a = _mm256_xor_pd (_mm256_blendv_pd (s, c, big), sign);	/* sin */
+	c = _mm256_blendv_pd (c, s, big);						/* cos */
+
+	/* cos of the hour angle */
+	x = _mm256_sub_pd (_mm256_div_pd (AVX2_SET (t->cos_angle), _mm256_mul_pd (c, AVX2_SET (t->cos_decl))),
+					   _mm256_mul_pd (_mm256_div_pd (a, c), AVX2_SET (t->tan_decl)));
+	valid = _mm256_and_pd (_mm256_cmp_pd (x, AVX2_SET (-1.0), _CMP_GE_OQ),
+						   _mm256_cmp_pd (x, AVX2_SET (1.0), _CMP_LE_OQ));
+	never_sets = _mm256_cmp_pd (x, AVX2_SET (-1.0), _CMP_LT_OQ);
+	x = _mm256_and_pd (valid, x);
+
+	/* acos */
+	a = _mm256_andnot_pd (sign_mask, x);
+	small = _mm256_cmp_pd (a, AVX2_SET (0.5), _CMP_LT_OQ);
+	z = _mm256_blendv_pd (_mm256_mul_pd (_mm256_sub_pd (AVX2_SET (1.0), a), AVX2_SET (0.5)),
+						  _mm256_mul_pd (x, x), small);
+	p = _mm256_add_pd (AVX2_SET (SUN_PS4), _mm256_mul_pd (z, AVX2_SET (SUN_PS5)));
+	p = _mm256_add_pd (AVX2_SET (SUN_PS3), _mm256_mul_pd (z, p));
+	p = _mm256_add_pd (AVX2_SET (SUN_PS2), _mm256_mul_pd (z, p));
+	p = _mm256_add_pd (AVX2_SET (SUN_PS1), _mm256_mul_pd (z, p));
+	p = _mm256_add_pd (AVX2_SET (SUN_PS0), _mm256_mul_pd (z, p));
+	p = _mm256_mul_pd (z, p);
+	q = _mm256_add_pd (AVX2_SET (SUN_QS3), _mm256_mul_pd (z, AVX2_SET (SUN_QS4)));
+	q = _mm256_add_pd (AVX2_SET (SUN_QS2), _mm256_mul_pd (z, q));
+	q = _mm256_add_pd (AVX2_SET (SUN_QS1), _mm256_mul_pd (z, q));
+	q = _mm256_add_pd (AVX2_SET (1.0), _mm256_mul_pd (z, q));
+	r = _mm256_div_pd (p, q);
+	acs = _mm256_sub_pd (AVX2_SET (SUN_PIO2_HI),
+						 _mm256_sub_pd (x, _mm256_sub_pd (AVX2_SET (SUN_PIO2_LO), _mm256_mul_pd (x, r))));
+	s = _mm256_sqrt_pd (z);
+	w = _mm256_add_pd (s, _mm256_mul_pd (s, r));
+	w = _mm256_blendv_pd (_mm256_add_pd (w, w), _mm256_sub_pd (AVX2_SET (M_PI), _mm256_add_pd (w, w)),
+						  _mm256_cmp_pd (x, _mm256_setzero_pd (), _CMP_LT_OQ));
+	acs = _mm256_blendv_pd (w, acs, small);
+
+	/* utc times in seconds */
+	ha = _mm256_div_pd (_mm256_mul_pd (AVX2_SET (43200.0), acs), AVX2_SET (M_PI));
+	base = _mm256_sub_pd (AVX2_SET (43200.0), _mm256_mul_pd (AVX2_SET (240.0), lon));
+	rise = _mm256_cvttpd_epi32 (_mm256_sub_pd (_mm256_sub_pd (base, ha), AVX2_SET (t->eqtime)));
+	set = _mm256_cvttpd_epi32 (_mm256_sub_pd (_mm256_add_pd (base, ha), AVX2_SET (t->eqtime)));
+
+	ok = mask_epi32_avx2 (valid);
+	rise = _mm_blendv_epi8 (_mm_set1_epi32 (-720), rise, ok);
+	set = _mm_blendv_epi8 (_mm_set1_epi32 (-720), set, ok);
+	st = _mm_blendv_epi8 (_mm_set1_epi32 (HDATE_SUN_NEVER_RISES), _mm_set1_epi32 (HDATE_SUN_NEVER_SETS),
+						  mask_epi32_avx2 (never_sets));
+	st = _mm_andnot_si128 (ok, st);
+
+	_mm_storeu_si128 ((__m128i *) sunrise, rise);
+	_mm_storeu_si128 ((__m128i *) sunset, set);
+	if (status) _mm_storeu_si128 ((__m128i *) status, st);
+
+	return TRUE;
+}
+
+#endif /* HDATE_X86_SIMD */
+
+/**
+ @brief scalar fallback for a run of locations
+*/
+static void
+sun_times_scalar_run (double const *latitude, double const *longitude,
+	sun_date_terms const *t, int *sunrise, int *sunset, int *status, int count)
+{
+	int i, st;
+
+	for (i = 0; i < count; i++)
+	{
+		st = sun_times_scalar (latitude[i], longitude[i], t, &sunrise[i], &sunset[i]);
+		if (status) status[i] = st;
+	}
+}
+
+/**
+ @brief utc sun times for altitude at a gregorian date, many locations
+
+ Same as hdate_get_utc_sun_time_deg_seconds for each location, but the
+ sun position of the date is computed once, and the locations are done
+ several at a time where the machine allows. A time may differ from the
+ one of hdate_get_utc_sun_time_deg_seconds by a second.
+
+ @param day this day of month
+ @param month this month
+ @param year this year
+ @param latitude array of latitudes to use in calculations
+ @param longitude array of longitudes to use in calculations
+ @param count number of entries in each array
+ @param deg degrees of sun's altitude (0 -  Zenith .. 90 - Horizon)
+ @param sunrise return the utc sunrise in seconds
+ @param sunset return the utc sunset in seconds
+ @param status return HDATE_SUN_NORMAL, or HDATE_SUN_NEVER_RISES /
+	HDATE_SUN_NEVER_SETS if the sun never gets to this altitude, and
+	sunrise and sunset are -720; may be NULL
+ @return the number of locations computed
+*/
+int
+hdate_get_utc_sun_time_deg_seconds_array (const int day, const int month, const int year,
+	double const *latitude, double const *longitude, int count, const double deg,
+	int *sunrise, int *sunset, int *status)
+{
+	sun_date_terms t;
+	double decl;
+	int i = 0;
+
+	if (!latitude || !longitude || !sunrise || !sunset || count <= 0) return 0;
+
+	sun_day_terms (hdate_get_day_of_year (day, month, year), &t.eqtime, &decl);
+	t.cos_angle = cos (M_PI * deg / 180.0);
+	t.cos_decl = cos (decl);
+	t.tan_decl = tan (decl);
+
+#ifdef HDATE_X86_SIMD
+	if (__builtin_cpu_supports ("avx2"))
+	{
+		for (; i + 4 <= count; i += 4)
+			if (!sun_times_avx2 (latitude + i, longitude + i, &t, sunrise + i, sunset + i,
+								 status ? status + i : NULL))
+				sun_times_scalar_run (latitude + i, longitude + i, &t, sunrise + i, sunset + i,
+									  status ? status + i : NULL, 4);
+	}
+	if (__builtin_cpu_supports ("sse2"))
+	{
+		for (; i + 2 <= count; i += 2)
+			if (!sun_times_sse2 (latitude + i, longitude + i, &t, sunrise + i, sunset + i,
+								 status ? status + i : NULL))
+				sun_times_scalar_run (latitude + i, longitude + i, &t, sunrise + i, sunset + i,
+									  status ? status + i : NULL, 2);
+	}
+#endif
+	sun_times_scalar_run (latitude + i, longitude + i, &t, sunrise + i, sunset + i,
+						  status ? status + i : NULL, count - i);
+
+	return count;
+}
@@ -29,11 +29,54 @@
 
 #include <hdate.h>
 
+#ifndef SWIG
+#if __cplusplus >= 201103L
+#include <type_traits>
+#endif
+#if __cplusplus >= 201402L
+#include <cstddef>
+#include <iterator>
+#include <hdatepp_core.h>
+#endif
+#if __cplusplus >= 202002L
+#include <chrono>
+#endif
+#endif
+
 /**
  @brief the libhdate namespace.
  */
 namespace hdate 
 {
+	
+#if !defined SWIG && __cplusplus >= 202002L
+	/** @brief the julian day of 1 January 1970, day 0 of std::chrono::sys_days */
+	constexpr int jd_of_sys_epoch = 2440588;
+	
+	/**
+	 @brief the julian day of a std::chrono date
+
+	 @param d the date
+	 @return the julian day number
+	 */
+	constexpr int
+	sys_days_to_jd (std::chrono::sys_days d)
+	{
+		return (int) d.time_since_epoch ().count () + jd_of_sys_epoch;
+	}
+	
+	/**
+	 @brief the std::chrono date of a julian day
+
+	 @param jd the julian day number
+	 @return the date
+	 */
+	constexpr std::chrono::sys_days
+	jd_to_sys_days (int jd)
+	{
+		return std::chrono::sys_days (std::chrono::days (jd - jd_of_sys_epoch));
+	}
+#endif
 		
 	/**
 	 @brief Hdate class.
@@ -49,28 +92,84 @@ namespace hdate
 		
 		/**
 		 @brief Hdate constructor.
+
+		 The date fields are left zeroed, and no clock or heap is touched;
+		 call one of the set_ methods (e.g. set_today) before reading them.
 		 */
-		Hdate()
+#if defined SWIG || __cplusplus >= 201103L
+		constexpr
+#endif
+		Hdate ()
+			: diaspora (HDATE_ISRAEL_FLAG),
+			  /* default localeconv is Tel-Aviv winter time */
+			  latitude (32.0), longitude (-34.0), tz (2),
+			  h ()
 		{
-			/* default is this day */
-			h = new_hdate();
-			
-			/* default is in israel */
-			diaspora = HDATE_ISRAEL_FLAG;
-			
-			/* default localeconv is Tel-Aviv winter time */
-			latitude = 32.0;
-			longitude = -34.0;
-			tz = 2;
 		}
 		
 		/**
-		 @brief Hdate destructor.
+		 @brief Hdate constructor from a Julian day number.
+
+		 With C++14 this is constexpr, computed by hdatepp_core.h.
+		
+		 @param jd the julian day number.
 		 */
-		~Hdate()
+#if !defined SWIG && __cplusplus >= 201402L
+		constexpr explicit
+		Hdate (int jd)
+			: diaspora (HDATE_ISRAEL_FLAG),
+			  latitude (32.0), longitude (-34.0), tz (2),
+			  h (core::jd_to_hdate_struct (jd))
+		{
+		}
+#else
+		explicit
+		Hdate (int jd)
+			: diaspora (HDATE_ISRAEL_FLAG),
+			  latitude (32.0), longitude (-34.0), tz (2),
+			  h ()
 		{
-			delete_hdate(h);
+			hdate_set_jd (&h, jd);
 		}
+#endif
+		
+#if !defined SWIG && __cplusplus >= 202002L
+		/**
+		 @brief Hdate constructor from a std::chrono date.
+
+		 @param d the date
+		 */
+		constexpr explicit
+		Hdate (std::chrono::sys_days d)
+			: Hdate (sys_days_to_jd (d))
+		{
+		}
+		
+		/**
+		 @brief Hdate constructor from a std::chrono civil date.
+
+		 @param ymd the Gregorian date
+		 */
+		constexpr explicit
+		Hdate (std::chrono::year_month_day ymd)
+			: Hdate (std::chrono::sys_days (ymd))
+		{
+		}
+#endif
+		
+		/**
+		 @brief Hdate copy and move.
+
+		 The date is held by value, so copies are plain member copies and
+		 the class stays trivially copyable. Before C++11 the implicit
+		 copy constructor and assignment do the same.
+		 */
+#if defined SWIG || __cplusplus >= 201103L
+		Hdate (const Hdate &) = default;
+		Hdate (Hdate &&) = default;
+		Hdate & operator= (const Hdate &) = default;
+		Hdate & operator= (Hdate &&) = default;
+#endif
 		
 		////////////////////////////////////////
 		////////////////////////////////////////
@@ -85,7 +184,7 @@ namespace hdate
 		void
 		set_gdate (int d, int m, int y)
 		{
-			hdate_set_gdate (h, d, m, y);
+			hdate_set_gdate (&h, d, m, y);
 		}
 		
 		/**
@@ -98,7 +197,7 @@ namespace hdate
 		void
 		set_hdate (int d, int m, int y)
 		{
-			hdate_set_hdate (h, d, m, y);
+			hdate_set_hdate (&h, d, m, y);
 		}
 		
 		/**
@@ -109,8 +208,84 @@ namespace hdate
 		void
 		set_jd (int jd)
 		{
-			hdate_set_jd (h, jd);
+			hdate_set_jd (&h, jd);
+		}
+		
+#if !defined SWIG && __cplusplus >= 201402L
+		/**
+		 @brief move the date by a number of days
+
+		 Steps the fields arithmetically within the Hebrew year, and
+		 does the full conversion only when crossing 1 Tishrey. The date
+		 must have been set first.
+
+		 @param n the number of days to move, negative for the past
+		 */
+		constexpr Hdate &
+		advance (int n)
+		{
+			core::advance (h, n);
+			return *this;
 		}
+#endif
+		
+		/**
+		 @brief compute date structure from a moment in time
+		
+		 @param t the moment, in seconds since the epoch
+		 @param tz_offset the local offset from UTC in seconds, east positive
+		 */
+		void
+		set_time (time_t t, long tz_offset)
+		{
+			hdate_set_time (&h, t, tz_offset);
+		}
+		
+		/**
+		 @brief compute date structure for the current local date
+		 */
+		void
+		set_today ()
+		{
+			hdate_set_today (&h);
+		}
+		
+#if !defined SWIG && __cplusplus >= 202002L
+		/**
+		 @brief compute date structure from a std::chrono date
+
+		 @param d the date
+		 */
+		constexpr void
+		set_sys_days (std::chrono::sys_days d)
+		{
+			h = core::jd_to_hdate_struct (sys_days_to_jd (d));
+		}
+		
+		/**
+		 @brief the date as a std::chrono date
+
+		 @return the date, from the julian day alone
+		 */
+		constexpr std::chrono::sys_days
+		get_sys_days () const
+		{
+			return jd_to_sys_days (h.hd_jd);
+		}
+		
+		/**
+		 @brief the Gregorian date as a std::chrono civil date
+
+		 @return the Gregorian date, from the fields already computed
+		 */
+		constexpr std::chrono::year_month_day
+		get_year_month_day () const
+		{
+			return std::chrono::year_month_day (std::chrono::year (h.gd_year),
+				std::chrono::month ((unsigned) h.gd_mon),
+				std::chrono::day ((unsigned) h.gd_day));
+		}
+#endif
 		
 		////////////////////////////////////////
 		////////////////////////////////////////
@@ -132,9 +307,9 @@ namespace hdate
 
 		*/
 		char *
-		get_format_date (int s)
+		get_format_date (int s) const
 		{
-			return hdate_get_format_date (h, diaspora, s);
+			return hdate_get_format_date (&h, diaspora, s);
 		}
 		
 		/**
@@ -147,10 +322,10 @@ namespace hdate
 				  [deprecation date 2011-12-28]
 		*/
 		char *
-		get_day_of_week_string (int short_form)
+		get_day_of_week_string (int short_form) const
 		{
-			//return hdate_get_day_string (h->hd_dw, s);
-			return hdate_string(HDATE_STRING_DOW, h->hd_dw, short_form, HDATE_STRING_LOCAL);
+			//return hdate_get_day_string (h.hd_dw, s);
+			return hdate_string(HDATE_STRING_DOW, h.hd_dw, short_form, HDATE_STRING_LOCAL);
 		}
 		
 		/**
@@ -163,10 +338,10 @@ namespace hdate
 				  [deprecation date 2011-12-28]
 		*/
 		char *
-		get_month_string (int short_form)
+		get_month_string (int short_form) const
 		{
-			//return hdate_get_month_string (h->gd_mon, s);
-			return hdate_string( HDATE_STRING_GMONTH, h->gd_mon, short_form, HDATE_STRING_LOCAL);	
+			//return hdate_get_month_string (h.gd_mon, s);
+			return hdate_string( HDATE_STRING_GMONTH, h.gd_mon, short_form, HDATE_STRING_LOCAL);	
 		}
 		
 		/**
@@ -179,10 +354,10 @@ namespace hdate
 				  [deprecation date 2011-12-28]
 		*/
 		char *
-		get_hebrew_month_string (int short_form)
+		get_hebrew_month_string (int short_form) const
 		{
-			//return hdate_get_hebrew_month_string (h->hd_mon, s);
-			return hdate_string( HDATE_STRING_HMONTH, h->hd_mon, short_form, HDATE_STRING_LOCAL);	
+			//return hdate_get_hebrew_month_string (h.hd_mon, s);
+			return hdate_string( HDATE_STRING_HMONTH, h.hd_mon, short_form, HDATE_STRING_LOCAL);	
 		}
 		
 		/**
@@ -195,11 +370,11 @@ namespace hdate
 				  [deprecation date 2011-12-28]
 		*/
 		char *
-		get_holyday_string (int s)
+		get_holyday_string (int s) const
 		{
 			int holiday;
 			
-			holiday = hdate_get_holyday (h, diaspora);
+			holiday = hdate_get_holyday (&h, diaspora);
 			//return hdate_get_holyday_string (holyday, s);
 			return hdate_string(HDATE_STRING_HOLIDAY, holiday, HDATE_STRING_LONG, HDATE_STRING_LOCAL);	
 
@@ -211,9 +386,9 @@ namespace hdate
 		 @return return The day in the omer, starting from 1 (or 0 if not in sfirat ha omer)
 		*/
 		int
-		get_omer_day ()
+		get_omer_day () const
 		{
-			return hdate_get_omer_day (h);
+			return hdate_get_omer_day (&h);
 		}
 		
 		/**
@@ -222,11 +397,11 @@ namespace hdate
 		 @return the holiday type 
 		*/
 		int
-		get_holyday_type ()
+		get_holyday_type () const
 		{
 			int holyday;
 			
-			holyday = hdate_get_holyday (h, diaspora);
+			holyday = hdate_get_holyday (&h, diaspora);
 			return hdate_get_holyday_type (holyday);
 		}
 		
@@ -241,11 +416,11 @@ namespace hdate
 				  [deprecation date 2011-12-28]
 		*/
 		char *
-		get_parasha_string (int s)
+		get_parasha_string (int s) const
 		{
 			int parasha;
 			
-			parasha = hdate_get_parasha (h, diaspora);
+			parasha = hdate_get_parasha (&h, diaspora);
 			//return hdate_get_parasha_string (parasha, s);
 			return hdate_string(HDATE_STRING_PARASHA, parasha, HDATE_STRING_LONG, HDATE_STRING_LOCAL);	
 
@@ -265,10 +440,10 @@ namespace hdate
 				  [deprecation date 2011-12-28]
 		*/
 		char *
-		get_hebrew_year_string ()
+		get_hebrew_year_string () const
 		{
-			//return hdate_get_int_string (h->hd_year);
-			return hdate_string(HDATE_STRING_INT, h->hd_year, HDATE_STRING_LONG, HDATE_STRING_LOCAL);	
+			//return hdate_get_int_string (h.hd_year);
+			return hdate_string(HDATE_STRING_INT, h.hd_year, HDATE_STRING_LONG, HDATE_STRING_LOCAL);	
 
 		}
 		
@@ -287,10 +462,10 @@ namespace hdate
 
 		*/
 		char *
-		get_hebrew_day_string ()
+		get_hebrew_day_string () const
 		{
-			// return hdate_get_int_string (h->hd_day);
-			return hdate_string(HDATE_STRING_INT, h->hd_day, HDATE_STRING_LONG, HDATE_STRING_LOCAL);	
+			// return hdate_get_int_string (h.hd_day);
+			return hdate_string(HDATE_STRING_INT, h.hd_day, HDATE_STRING_LONG, HDATE_STRING_LOCAL);	
 		}
 
 		/**
@@ -311,7 +486,8 @@ namespace hdate
 		 @param short_form   0 = short format
 		 @param hebrew_form  0 = not hebrew (native/embedded)
 		*/
-		char* get_string()
+		char *
+		get_string (int type_of_string, int index, int short_form, int hebrew_form) const
 		{
 			return hdate_string( type_of_string, index, short_form, hebrew_form);		
 		}
@@ -324,9 +500,9 @@ namespace hdate
 		@return the hebrew parasha number
 		*/
 		int
-		get_parasha ()
+		get_parasha () const
 		{
-			return hdate_get_parasha (h, diaspora);
+			return hdate_get_parasha (&h, diaspora);
 		}
 		
 		/**
@@ -334,9 +510,9 @@ namespace hdate
 		 @return the hebrew holiday number
 		*/
 		int
-		get_holyday ()
+		get_holyday () const
 		{
-			return hdate_get_holyday (h, diaspora);
+			return hdate_get_holyday (&h, diaspora);
 		}
 		
 		/**
@@ -345,9 +521,9 @@ namespace hdate
 		 @return the Gregorian day of the month
 		*/
 		int
-		get_gday ()
+		get_gday () const
 		{
-			return hdate_get_gday (h);
+			return hdate_get_gday (&h);
 		}
 		
 		/**
@@ -356,9 +532,9 @@ namespace hdate
 		 @return the Gregorian month
 		*/
 		int
-		get_gmonth ()
+		get_gmonth () const
 		{
-			return hdate_get_gmonth (h);
+			return hdate_get_gmonth (&h);
 		}
 		
 		/**
@@ -367,9 +543,9 @@ namespace hdate
 		 @return the Gregorian year
 		*/
 		int
-		get_gyear ()
+		get_gyear () const
 		{
-			return hdate_get_gyear (h);
+			return hdate_get_gyear (&h);
 		}
 		
 		/**
@@ -378,9 +554,9 @@ namespace hdate
 		 @return the Hebrew day of the month
 		*/
 		int
-		get_hday ()
+		get_hday () const
 		{
-			return hdate_get_hday (h);
+			return hdate_get_hday (&h);
 		}
 		
 		/**
@@ -389,9 +565,9 @@ namespace hdate
 		 @return the Hebrew month
 		*/
 		int
-		get_hmonth ()
+		get_hmonth () const
 		{
-			return hdate_get_hmonth (h);
+			return hdate_get_hmonth (&h);
 		}
 		
 		/**
@@ -400,9 +576,9 @@ namespace hdate
 		 @return the Hebrew year
 		*/
 		int
-		get_hyear ()
+		get_hyear () const
 		{
-			return hdate_get_hyear (h);
+			return hdate_get_hyear (&h);
 		}
 		
 		/**
@@ -411,9 +587,9 @@ namespace hdate
 		 @return the day of the week
 		*/
 		int
-		get_day_of_the_week ()
+		get_day_of_the_week () const
 		{
-			return hdate_get_day_of_the_week (h);
+			return hdate_get_day_of_the_week (&h);
 		}
 		
 		/**
@@ -422,9 +598,9 @@ namespace hdate
 		 @return the size of the Hebrew year in days
 		*/
 		int
-		get_size_of_year ()
+		get_size_of_year () const
 		{
-			return hdate_get_size_of_year (h);
+			return hdate_get_size_of_year (&h);
 		}
 		
 		/**
@@ -433,9 +609,9 @@ namespace hdate
 		 @return the day of the week of hebrew new years
 		*/
 		int
-		get_new_year_day_of_the_week ()
+		get_new_year_day_of_the_week () const
 		{
-			return hdate_get_new_year_day_of_the_week (h);
+			return hdate_get_new_year_day_of_the_week (&h);
 		}
 		
 		/**
@@ -443,10 +619,13 @@ namespace hdate
 		
 		 @return the Julian day number
 		*/
+#if defined SWIG || __cplusplus >= 201103L
+		constexpr
+#endif
 		int
-		get_julian ()
+		get_julian () const
 		{
-			return hdate_get_julian (h);
+			return h.hd_jd;
 		}
 		
 		/**
@@ -455,9 +634,9 @@ namespace hdate
 		 @return the the number of days sice Tishrey I
 		*/
 		int
-		get_days ()
+		get_days () const
 		{
-			return hdate_get_days (h);
+			return hdate_get_days (&h);
 		}
 		
 		/**
@@ -466,9 +645,9 @@ namespace hdate
 		 @return the the number of weeks sice Tishrey I
 		*/
 		int
-		get_weeks ()
+		get_weeks () const
 		{
-			return hdate_get_weeks (h);
+			return hdate_get_weeks (&h);
 		}
 		
 		////////////////////////////////////////
@@ -497,12 +676,12 @@ namespace hdate
 		 @return sunrise in minutes after midnight (00:00)
 		 */
 		int
-		get_sunrise ()
+		get_sunrise () const
 		{
 			int sunrise;
 			int sunset;
 			
-			hdate_get_utc_sun_time (h->gd_day, h->gd_mon, h->gd_year, 
+			hdate_get_utc_sun_time (h.gd_day, h.gd_mon, h.gd_year, 
 				latitude, longitude, 
 				&sunrise, &sunset);
 			
@@ -515,12 +694,12 @@ namespace hdate
 		 @return sunset in minutes after midnight (00:00)
 		 */
 		int
-		get_sunset ()
+		get_sunset () const
 		{
 			int sunrise;
 			int sunset;
 			
-			hdate_get_utc_sun_time (h->gd_day, h->gd_mon, h->gd_year, 
+			hdate_get_utc_sun_time (h.gd_day, h.gd_mon, h.gd_year, 
 				latitude, longitude, 
 				&sunrise, &sunset);
 			
@@ -533,12 +712,12 @@ namespace hdate
 		 @return first light in minutes after midnight (00:00)
 		 */
 		int
-		get_first_light ()
+		get_first_light () const
 		{
 			int sunrise;
 			int sunset;
 			
-			hdate_get_utc_sun_time_deg (h->gd_day, h->gd_mon, h->gd_year, 
+			hdate_get_utc_sun_time_deg (h.gd_day, h.gd_mon, h.gd_year, 
 				latitude, longitude, 106.01,
 				&sunrise, &sunset);
 			
@@ -551,12 +730,12 @@ namespace hdate
 		 @return talit time in minutes after midnight (00:00)
 		 */
 		int
-		get_talit ()
+		get_talit () const
 		{
 			int sunrise;
 			int sunset;
 			
-			hdate_get_utc_sun_time_deg (h->gd_day, h->gd_mon, h->gd_year, 
+			hdate_get_utc_sun_time_deg (h.gd_day, h.gd_mon, h.gd_year, 
 				latitude, longitude, 101.0,
 				&sunrise, &sunset);
 			
@@ -569,12 +748,12 @@ namespace hdate
 		 @return first stars in minutes after midnight (00:00)
 		 */
 		int
-		get_first_stars ()
+		get_first_stars () const
 		{
 			int sunrise;
 			int sunset;
 			
-			hdate_get_utc_sun_time_deg (h->gd_day, h->gd_mon, h->gd_year, 
+			hdate_get_utc_sun_time_deg (h.gd_day, h.gd_mon, h.gd_year, 
 				latitude, longitude, 96.0,
 				&sunrise, &sunset);
 			
@@ -587,12 +766,12 @@ namespace hdate
 		 @return three stars in minutes after midnight (00:00)
 		 */
 		int
-		get_three_stars ()
+		get_three_stars () const
 		{
 			int sunrise;
 			int sunset;
 			
-			hdate_get_utc_sun_time_deg (h->gd_day, h->gd_mon, h->gd_year, 
+			hdate_get_utc_sun_time_deg (h.gd_day, h.gd_mon, h.gd_year, 
 				latitude, longitude, 98.5,
 				&sunrise, &sunset);
 			
@@ -605,12 +784,12 @@ namespace hdate
 		 @return sun light hour in minutes
 		 */
 		int
-		get_sun_hour ()
+		get_sun_hour () const
 		{
 			int sunrise;
 			int sunset;
 			
-			hdate_get_utc_sun_time (h->gd_day, h->gd_mon, h->gd_year, 
+			hdate_get_utc_sun_time (h.gd_day, h.gd_mon, h.gd_year, 
 				latitude, longitude,
 				&sunrise, &sunset);
 			
@@ -623,18 +802,124 @@ namespace hdate
 		 @return midday hour in minutes
 		 */
 		int
-		get_midday ()
+		get_midday () const
 		{
 			int sunrise;
 			int sunset;
 			
-			hdate_get_utc_sun_time (h->gd_day, h->gd_mon, h->gd_year, 
+			hdate_get_utc_sun_time (h.gd_day, h.gd_mon, h.gd_year, 
 				latitude, longitude,
 				&sunrise, &sunset);
 			
 			return (sunset + sunrise) / 2;
 		}
 		
+#if !defined SWIG && __cplusplus >= 202002L
+		/**
+		 @brief sunrise time
+
+		 @return sunrise, as a utc moment; sys_seconds::min () if the sun
+		 does not rise that day
+		 */
+		std::chrono::sys_seconds
+		get_sunrise_time () const
+		{
+			return sun_time (90.833, true);
+		}
+		
+		/**
+		 @brief sunset time
+
+		 @return sunset, as a utc moment; sys_seconds::min () if the sun
+		 does not set that day
+		 */
+		std::chrono::sys_seconds
+		get_sunset_time () const
+		{
+			return sun_time (90.833, false);
+		}
+		
+		/**
+		 @brief first light time
+
+		 @return first light, as a utc moment; sys_seconds::min () if none
+		 */
+		std::chrono::sys_seconds
+		get_first_light_time () const
+		{
+			return sun_time (106.01, true);
+		}
+		
+		/**
+		 @brief talit time
+
+		 @return talit time, as a utc moment; sys_seconds::min () if none
+		 */
+		std::chrono::sys_seconds
+		get_talit_time () const
+		{
+			return sun_time (101.0, true);
+		}
+		
+		/**
+		 @brief first stars time
+
+		 @return first stars, as a utc moment; sys_seconds::min () if none
+		 */
+		std::chrono::sys_seconds
+		get_first_stars_time () const
+		{
+			return sun_time (96.0, false);
+		}
+		
+		/**
+		 @brief three stars time
+
+		 @return three stars, as a utc moment; sys_seconds::min () if none
+		 */
+		std::chrono::sys_seconds
+		get_three_stars_time () const
+		{
+			return sun_time (98.5, false);
+		}
+		
+		/**
+		 @brief midday time
+
+		 @return midday, half way from sunrise to sunset, as a utc moment;
+		 sys_seconds::min () if the sun does not rise and set that day
+		 */
+		std::chrono::sys_seconds
+		get_midday_time () const
+		{
+			std::chrono::sys_seconds sunrise = get_sunrise_time ();
+			std::chrono::sys_seconds sunset = get_sunset_time ();
+			
+			if (sunrise == std::chrono::sys_seconds::min ()
+			    || sunset == std::chrono::sys_seconds::min ())
+				return std::chrono::sys_seconds::min ();
+			return sunrise + (sunset - sunrise) / 2;
+		}
+		
+		/**
+		 @brief sun light hour
+
+		 @return a twelfth of the time from sunrise to sunset, or zero if
+		 the sun does not rise and set that day
+		 */
+		std::chrono::seconds
+		get_sun_hour_duration () const
+		{
+			std::chrono::sys_seconds sunrise = get_sunrise_time ();
+			std::chrono::sys_seconds sunset = get_sunset_time ();
+			
+			if (sunrise == std::chrono::sys_seconds::min ()
+			    || sunset == std::chrono::sys_seconds::min ())
+				return std::chrono::seconds (0);
+			return (sunset - sunrise) / 12;
+		}
+#endif
+		
 		////////////////////////////////////////
 		////////////////////////////////////////
 		
@@ -644,7 +929,7 @@ namespace hdate
 		 @return a static string with name of translator, or NULL if none
 		*/
 		char *
-		get_translator_string ()
+		get_translator_string () const
 		{
 			return hdate_get_translator_string ();
 		}
@@ -669,17 +954,286 @@ namespace hdate
 		
 	private:
 		
+#if !defined SWIG && __cplusplus >= 202002L
+		/**
+		 @brief utc moment the sun crosses an altitude on this date
+
+		 @param deg degrees of sun's altitude (0 -  Zenith .. 90 - Horizon)
+		 @param rising true for the morning crossing, false for the evening
+		 @return the moment, or sys_seconds::min () if there is none
+		 */
+		std::chrono::sys_seconds
+		sun_time (double deg, bool rising) const
+		{
+			int sunrise;
+			int sunset;
+			
+			if (hdate_get_utc_sun_time_deg_seconds_r (h.gd_day, h.gd_mon, h.gd_year,
+					latitude, longitude, deg, &sunrise, &sunset) != HDATE_SUN_NORMAL)
+				return std::chrono::sys_seconds::min ();
+			
+			return get_sys_days () + std::chrono::seconds (rising ? sunrise : sunset);
+		}
+#endif
+		
 		int diaspora;
 		double latitude;
 		double longitude;
 		int tz;
-		hdate_struct *h;
-		int type_of_string;
-		int index;
-		int short_form;
-		int hebrew_form;
+		hdate_struct h;
 	
 	};
+
+#if !defined SWIG && __cplusplus >= 201103L
+	static_assert (std::is_trivially_copyable<Hdate>::value,
+		"hdate::Hdate must stay a plain value");
+#endif
+
+#if !defined SWIG && __cplusplus >= 201402L
+	/**
+	 @brief DayRange class.
+
+	 A run of consecutive days, [first, first + count), whose random
+	 access iterators yield fully set Hdate values. Stepping an iterator
+	 moves its date with Hdate::advance, so walking the range costs a
+	 full conversion only at its start and at each 1 Tishrey. Every date
+	 keeps the diaspora and location settings of the first one.
+	 */
+	class DayRange
+	{
+		
+	public:
+		/**
+		 @brief DayRange iterator.
+
+		 Dereferencing gives the date by value; the iterator holds it.
+		 */
+		class iterator
+		{
+			
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef Hdate value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const Hdate * pointer;
+			typedef Hdate reference;
+			
+			constexpr iterator () = default;
+			
+			constexpr explicit
+			iterator (const Hdate &date)
+				: date (date)
+			{
+			}
+			
+			constexpr Hdate
+			operator* () const
+			{
+				return date;
+			}
+			
+			constexpr const Hdate *
+			operator-> () const
+			{
+				return &date;
+			}
+			
+			constexpr Hdate
+			operator[] (difference_type n) const
+			{
+				return *(*this + n);
+			}
+			
+			constexpr iterator &
+			operator++ ()
+			{
+				date.advance (1);
+				return *this;
+			}
+			
+			constexpr iterator
+			operator++ (int)
+			{
+				iterator old = *this;
+				date.advance (1);
+				return old;
+			}
+			
+			constexpr iterator &
+			operator-- ()
+			{
+				date.advance (-1);
+				return *this;
+			}
+			
+			constexpr iterator
+			operator-- (int)
+			{
+				iterator old = *this;
+				date.advance (-1);
+				return old;
+			}
+			
+			constexpr iterator &
+			operator+= (difference_type n)
+			{
+				date.advance ((int) n);
+				return *this;
+			}
+			
+			constexpr iterator &
+			operator-= (difference_type n)
+			{
+				date.advance ((int) -n);
+				return *this;
+			}
+			
+			friend constexpr iterator
+			operator+ (iterator it, difference_type n)
+			{
+				return it += n;
+			}
+			
+			friend constexpr iterator
+			operator+ (difference_type n, iterator it)
+			{
+				return it += n;
+			}
+			
+			friend constexpr iterator
+			operator- (iterator it, difference_type n)
+			{
+				return it -= n;
+			}
+			
+			friend constexpr difference_type
+			operator- (const iterator &a, const iterator &b)
+			{
+				return a.jd () - b.jd ();
+			}
+			
+			friend constexpr bool
+			operator== (const iterator &a, const iterator &b)
+			{
+				return a.jd () == b.jd ();
+			}
+			
+			friend constexpr bool
+			operator!= (const iterator &a, const iterator &b)
+			{
+				return a.jd () != b.jd ();
+			}
+			
+			friend constexpr bool
+			operator< (const iterator &a, const iterator &b)
+			{
+				return a.jd () < b.jd ();
+			}
+			
+			friend constexpr bool
+			operator> (const iterator &a, const iterator &b)
+			{
+				return a.jd () > b.jd ();
+			}
+			
+			friend constexpr bool
+			operator<= (const iterator &a, const iterator &b)
+			{
+				return a.jd () <= b.jd ();
+			}
+			
+			friend constexpr bool
+			operator>= (const iterator &a, const iterator &b)
+			{
+				return a.jd () >= b.jd ();
+			}
+			
+		private:
+			
+			constexpr int
+			jd () const
+			{
+				return date.get_julian ();
+			}
+			
+			Hdate date;
+		};
+		
+		typedef iterator const_iterator;
+		typedef std::reverse_iterator<iterator> reverse_iterator;
+		
+		/**
+		 @brief DayRange constructor.
+
+		 @param first_jd the julian day of the first date
+		 @param end_jd the julian day after the last date
+		 */
+		constexpr
+		DayRange (int first_jd, int end_jd)
+			: first (first_jd), count (end_jd > first_jd ? end_jd - first_jd : 0)
+		{
+		}
+		
+		/**
+		 @brief DayRange constructor, keeping a date's settings.
+
+		 @param first the first date, already set
+		 @param count the number of days in the range
+		 */
+		constexpr
+		DayRange (const Hdate &first, int count)
+			: first (first), count (count > 0 ? count : 0)
+		{
+		}
+		
+		constexpr iterator
+		begin () const
+		{
+			return iterator (first);
+		}
+		
+		constexpr iterator
+		end () const
+		{
+			return begin () + count;
+		}
+		
+		reverse_iterator
+		rbegin () const
+		{
+			return reverse_iterator (end ());
+		}
+		
+		reverse_iterator
+		rend () const
+		{
+			return reverse_iterator (begin ());
+		}
+		
+		constexpr int
+		size () const
+		{
+			return count;
+		}
+		
+		constexpr bool
+		empty () const
+		{
+			return count == 0;
+		}
+		
+		constexpr Hdate
+		operator[] (int n) const
+		{
+			return begin ()[n];
+		}
+		
+	private:
+		
+		Hdate first;
+		int count;
+	};
+#endif
 }
  // name space
 
@@ -0,0 +1,487 @@
+/*  libhdate - Hebrew calendar library
+ *
+ *  Copyright (C) 1984-2003 Amos Shapir, 2004-2007  Yaacov Zamir <kzamir@walla.co.il>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file hdatepp_core.h
+    @brief libhdate C++ constexpr calendar core.
+
+    The integer arithmetic of hdate_julian.c, header only and constexpr
+    (C++14), so that dates can be folded at compile time, or inlined into
+    a caller's loop with no call into the library. Results are the same
+    as those of the C functions of the same name, within
+    HDATE_JUL_DY_LOWER_BOUND..HDATE_JUL_DY_UPPER_BOUND.
+*/
+
+#ifndef __HDATE_PP_CORE_H__
+#define __HDATE_PP_CORE_H__
+
+#include <hdate.h>
+
+#if __cplusplus < 201402L
+#error "hdatepp_core.h needs C++14 or later"
+#endif
+
+namespace hdate
+{
+	/**
+	 @brief the constexpr calendar core.
+	 */
+	namespace core
+	{
+		/** @brief a Gregorian date, as hdate_jd_to_gdate returns it */
+		struct gdate
+		{
+			int day;	///< day of month 1..31
+			int month;	///< month 1..12
+			int year;	///< year e.g. 2001
+		};
+
+		/** @brief a Hebrew date, as hdate_jd_to_hdate returns it */
+		struct hdate
+		{
+			int day;	///< day of month 1..30
+			int month;	///< month 1..14 (13 - Adar 1, 14 - Adar 2)
+			int year;	///< year e.g. 5784
+			int jd_tishrey1;	///< julian day of 1 Tishrey this year
+			int jd_tishrey1_next_year;	///< julian day of 1 Tishrey next year
+		};
+
+		/** @brief the julian day of 1 Tishrey 3744, less one */
+		constexpr int jd_of_3744 = 1715118;
+
+		/**
+		 @brief Days since bet (?) Tishrey 3744
+
+		 The molad arithmetic of hdate_days_from_3744.
+
+		 @param hebrew_year The Hebrew year
+		 @return Number of days since 3,1,3744
+		 */
+		constexpr int
+		days_from_3744 (int hebrew_year)
+		{
+			constexpr int hour = 1080;
+			constexpr int day = 24 * hour;
+			constexpr int week = 7 * day;
+			constexpr int month = day + 12 * hour + 793;	/* Tikun for regular month */
+
+			/* Start point for calculation is Molad new year 3744 (16BC) */
+			int years_from_3744 = hebrew_year - 3744;
+			int molad_3744 = (1 + 6) * hour + 779;	/* Molad 3744 + 6 hours in parts */
+
+			/* Time in months */
+			int leap_months = (years_from_3744 * 7 + 1) / 19;
+			int leap_left = (years_from_3744 * 7 + 1) % 19;
+			int months = years_from_3744 * 12 + leap_months;
+
+			/* Time in parts and days */
+			int parts = months * month + molad_3744;
+			int days = months * 28 + parts / day - 2;
+
+			/* Time left for round date in corections */
+			int parts_left_in_week = parts % week;
+			int parts_left_in_day = parts % day;
+			int week_day = parts_left_in_week / day;
+
+			/* Special cases of Molad Zaken */
+			if ((leap_left < 12 && week_day == 3
+			     && parts_left_in_day >= (9 + 6) * hour + 204) ||
+			    (leap_left < 7 && week_day == 2
+			     && parts_left_in_day >= (15 + 6) * hour + 589))
+			{
+				days++, week_day++;
+			}
+
+			/* ADU */
+			if (week_day == 1 || week_day == 4 || week_day == 6)
+			{
+				days++;
+			}
+
+			return days;
+		}
+
+		/**
+		 @brief Size of Hebrew year in days
+
+		 @param hebrew_year The Hebrew year
+		 @return Size of Hebrew year
+		 */
+		constexpr int
+		size_of_hebrew_year (int hebrew_year)
+		{
+			return days_from_3744 (hebrew_year + 1) - days_from_3744 (hebrew_year);
+		}
+
+		/**
+		 @brief Return Hebrew year type based on size and first week day of year.
+
+		 @param size_of_year Length of year in days
+		 @param new_year_dw First week day of year
+		 @return A number for year type (1..14)
+		 */
+		constexpr int
+		year_type (int size_of_year, int new_year_dw)
+		{
+			/* Only 14 combinations of size and week day are posible */
+			const int year_types[24] =
+				{1, 0, 0, 2, 0, 3, 4, 0, 5, 0, 6, 7,
+				8, 0, 9, 10, 0, 11, 0, 0, 12, 0, 13, 14};
+
+			/* convert size and first day to 1..24 number */
+			int offset = (new_year_dw + 1) / 2;
+			offset = offset + 4 * ((size_of_year % 10 - 3) + (size_of_year / 10 - 35));
+
+			return year_types[offset - 1];
+		}
+
+		/**
+		 @brief Compute Julian day from Gregorian day, month and year
+
+		 @param day Day of month 1..31
+		 @param month Month 1..12
+		 @param year Year in 4 digits e.g. 2001
+		 @return The julian day number
+		 */
+		constexpr int
+		gdate_to_jd (int day, int month, int year)
+		{
+			int a = (14 - month) / 12;
+			int y = year + 4800 - a;
+			int m = month + 12 * a - 3;
+
+			return day + (153 * m + 2) / 5 + 365 * y + y / 4 - y / 100 + y / 400 - 32045;
+		}
+
+		/**
+		 @brief Converting from the Julian day to the Gregorian day
+
+		 @param jd Julian day
+		 @return the Gregorian date
+		 */
+		constexpr gdate
+		jd_to_gdate (int jd)
+		{
+			gdate g = {0, 0, 0};
+			int l = jd + 68569;
+			int n = (4 * l) / 146097;
+			l = l - (146097 * n + 3) / 4;
+			int i = (4000 * (l + 1)) / 1461001;
+			l = l - (1461 * i) / 4 + 31;
+			int j = (80 * l) / 2447;
+			g.day = l - (2447 * j) / 80;
+			l = j / 11;
+			g.month = j + 2 - (12 * l);
+			g.year = 100 * (n - 49) + i + l;
+
+			return g;
+		}
+
+		/**
+		 @brief Compute Julian day from Hebrew day, month and year
+
+		 @param day Day of month 1..30
+		 @param month Month 1..14 (13 - Adar 1, 14 - Adar 2)
+		 @param year Hebrew year in 4 digits e.g. 5753
+		 @return The julian day number
+		 */
+		constexpr int
+		hdate_to_jd (int day, int month, int year)
+		{
+			int days = days_from_3744 (year);
+			int length_of_year = days_from_3744 (year + 1) - days;
+
+			/* Adjust for leap year */
+			if (month == 13)
+			{
+				month = 6;
+			}
+			if (month == 14)
+			{
+				month = 6;
+				day += 30;
+			}
+
+			day = days + (59 * (month - 1) + 1) / 2 + day;
+
+			/* Special cases for this year */
+			if (length_of_year % 10 > 4 && month > 2)	/* long Heshvan */
+				day++;
+			if (length_of_year % 10 < 4 && month > 3)	/* short Kislev */
+				day--;
+			if (length_of_year > 365 && month > 6)	/* leap year */
+				day += 30;
+
+			return day + jd_of_3744;
+		}
+
+		/**
+		 @brief Hebrew day and month from the days passed since 1 Tishrey
+
+		 @param days days into this year, 1 Tishrey is 0
+		 @param size_of_year length of this year in days
+		 @param day Return Day of month 1..30
+		 @param month Return Month 1..14 (13 - Adar 1, 14 - Adar 2)
+		 */
+		constexpr void
+		days_to_hdate (int days, int size_of_year, int &day, int &month)
+		{
+			/* last 8 months allways have 236 days */
+			if (days >= (size_of_year - 236))
+			{
+				days = days - (size_of_year - 236);
+				month = days * 2 / 59;
+				day = days - (month * 59 + 1) / 2 + 1;
+
+				month = month + 4 + 1;
+
+				/* if leap */
+				if (size_of_year > 355 && month <= 6)
+					month = month + 8;
+			}
+			else /* in 4-5 first months */
+			{
+				if (size_of_year % 10 > 4 && days == 59) /* long Heshvan (day 30 of Heshvan) */
+				{
+					month = 1;
+					day = 30;
+				}
+				else if (size_of_year % 10 > 4 && days > 59) /* long Heshvan */
+				{
+					month = (days - 1) * 2 / 59;
+					day = days - (month * 59 + 1) / 2;
+				}
+				else if (size_of_year % 10 < 4 && days > 87) /* short kislev */
+				{
+					month = (days + 1) * 2 / 59;
+					day = days - (month * 59 + 1) / 2 + 2;
+				}
+				else /* regular months */
+				{
+					month = days * 2 / 59;
+					day = days - (month * 59 + 1) / 2 + 1;
+				}
+
+				month = month + 1;
+			}
+		}
+
+		/**
+		 @brief Converting from the Julian day to the Hebrew day
+
+		 @param jd Julian day
+		 @return the Hebrew date, and the julian days of this and next 1 Tishrey
+		 */
+		constexpr hdate
+		jd_to_hdate (int jd)
+		{
+			hdate h = {0, 0, 0, 0, 0};
+
+			/* Guess Hebrew year is Gregorian year + 3760 */
+			h.year = jd_to_gdate (jd).year + 3760;
+			h.jd_tishrey1 = days_from_3744 (h.year) + jd_of_3744 + 1;
+			h.jd_tishrey1_next_year = days_from_3744 (h.year + 1) + jd_of_3744 + 1;
+
+			/* Check if computed year was underestimated */
+			if (h.jd_tishrey1_next_year <= jd)
+			{
+				h.year++;
+				h.jd_tishrey1 = h.jd_tishrey1_next_year;
+				h.jd_tishrey1_next_year = days_from_3744 (h.year + 1) + jd_of_3744 + 1;
+			}
+
+			days_to_hdate (jd - h.jd_tishrey1, h.jd_tishrey1_next_year - h.jd_tishrey1,
+				h.day, h.month);
+
+			return h;
+		}
+
+		/**
+		 @brief compute date structure from julian day
+
+		 All fields, as hdate_set_jd fills them.
+
+		 @param jd the julian day number.
+		 @return the date structure
+		 */
+		constexpr hdate_struct
+		jd_to_hdate_struct (int jd)
+		{
+			hdate_struct s = {};
+			gdate g = jd_to_gdate (jd);
+			hdate h = jd_to_hdate (jd);
+
+			s.gd_day = g.day;
+			s.gd_mon = g.month;
+			s.gd_year = g.year;
+			s.hd_day = h.day;
+			s.hd_mon = h.month;
+			s.hd_year = h.year;
+			s.hd_dw = (jd + 1) % 7 + 1;
+			s.hd_size_of_year = h.jd_tishrey1_next_year - h.jd_tishrey1;
+			s.hd_new_year_dw = (h.jd_tishrey1 + 1) % 7 + 1;
+			s.hd_year_type = year_type (s.hd_size_of_year, s.hd_new_year_dw);
+			s.hd_jd = jd;
+			s.hd_days = jd - h.jd_tishrey1 + 1;
+			s.hd_weeks = ((s.hd_days - 1) + ((h.jd_tishrey1 + 1) % 7)) / 7 + 1;
+
+			return s;
+		}
+
+		/**
+		 @brief length of a Hebrew month in days
+
+		 @param month Month 1..14 (13 - Adar 1, 14 - Adar 2)
+		 @param size_of_year length of the year in days
+		 @return the number of days in the month
+		 */
+		constexpr int
+		hebrew_month_length (int month, int size_of_year)
+		{
+			if (month == 2)	/* long Heshvan */
+				return (size_of_year % 10 == 5) ? 30 : 29;
+			if (month == 3)	/* short Kislev */
+				return (size_of_year % 10 == 3) ? 29 : 30;
+			return (month % 2) ? 30 : 29;
+		}
+
+		/**
+		 @brief length of a Gregorian month in days
+
+		 @param month Month 1..12
+		 @param year Year in 4 digits e.g. 2001
+		 @return the number of days in the month
+		 */
+		constexpr int
+		gregorian_month_length (int month, int year)
+		{
+			if (month == 2)
+				return (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) ? 29 : 28;
+			return (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+		}
+
+		/**
+		 @brief move a date structure by a number of days
+
+		 Within the Hebrew year of the date, only the fields that change
+		 are recomputed: a single day's step rolls the day and month over,
+		 and a longer step decodes the days since 1 Tishrey, using the
+		 cached length of the year. Crossing 1 Tishrey does the full
+		 conversion of jd_to_hdate_struct.
+
+		 @param s a date structure with all fields set, as
+		 jd_to_hdate_struct or hdate_set_jd leave it
+		 @param n the number of days to move, negative for the past
+		 */
+		constexpr void
+		advance (hdate_struct &s, int n)
+		{
+			int jd = s.hd_jd + n;
+			int days = s.hd_days - 1 + n;	/* days into this year, 1 Tishrey is 0 */
+
+			if (days < 0 || days >= s.hd_size_of_year)
+			{
+				s = jd_to_hdate_struct (jd);
+				return;
+			}
+
+			if (n == 1)
+			{
+				if (s.hd_day < hebrew_month_length (s.hd_mon, s.hd_size_of_year))
+					s.hd_day++;
+				else
+				{
+					s.hd_day = 1;
+					if (s.hd_mon == 5)	/* Shvat, then Adar or Adar 1 */
+						s.hd_mon = (s.hd_size_of_year > 355) ? 13 : 6;
+					else if (s.hd_mon == 13)
+						s.hd_mon = 14;
+					else if (s.hd_mon == 14)
+						s.hd_mon = 7;
+					else
+						s.hd_mon++;
+				}
+
+				if (s.gd_day < gregorian_month_length (s.gd_mon, s.gd_year))
+					s.gd_day++;
+				else
+				{
+					s.gd_day = 1;
+					if (s.gd_mon < 12)
+						s.gd_mon++;
+					else
+					{
+						s.gd_mon = 1;
+						s.gd_year++;
+					}
+				}
+
+				s.hd_dw = (s.hd_dw < 7) ? s.hd_dw + 1 : 1;
+			}
+			else if (n == -1)
+			{
+				if (s.hd_day > 1)
+					s.hd_day--;
+				else
+				{
+					if (s.hd_mon == 7)	/* Nisan, after Adar or Adar 2 */
+						s.hd_mon = (s.hd_size_of_year > 355) ? 14 : 6;
+					else if (s.hd_mon == 14)
+						s.hd_mon = 13;
+					else if (s.hd_mon == 13)
+						s.hd_mon = 5;
+					else
+						s.hd_mon--;
+					s.hd_day = hebrew_month_length (s.hd_mon, s.hd_size_of_year);
+				}
+
+				if (s.gd_day > 1)
+					s.gd_day--;
+				else
+				{
+					if (s.gd_mon > 1)
+						s.gd_mon--;
+					else
+					{
+						s.gd_mon = 12;
+						s.gd_year--;
+					}
+					s.gd_day = gregorian_month_length (s.gd_mon, s.gd_year);
+				}
+
+				s.hd_dw = (s.hd_dw > 1) ? s.hd_dw - 1 : 7;
+			}
+			else
+			{
+				gdate g = jd_to_gdate (jd);
+
+				days_to_hdate (days, s.hd_size_of_year, s.hd_day, s.hd_mon);
+				s.gd_day = g.day;
+				s.gd_mon = g.month;
+				s.gd_year = g.year;
+				s.hd_dw = (jd + 1) % 7 + 1;
+			}
+
+			s.hd_jd = jd;
+			s.hd_days = days + 1;
+			s.hd_weeks = ((s.hd_days - 1) + (s.hd_new_year_dw - 1)) / 7 + 1;
+		}
+	}
+}
+ // name space
+
+#endif
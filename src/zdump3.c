@@ -25,38 +25,18 @@
 // next possibly not necessary
 #define _GNU_SOURCE     /// feature_test_macro - for memmem
 #define _POSIX_C_SOURCE 1
-#include <time.h>		/// for time, ctime
-#include <stdlib.h>		/// for getenv
-#include <unistd.h>		/// for getcwd, fstat
-#include <stdio.h>		/// for fopen, fileno
+#include <time.h>		/// for time_t
+#include <stdlib.h>		/// for getenv, malloc
 #include <sys/types.h>	/// for fstat
 #include <sys/stat.h>	/// for fstat
-#include <unistd.h>		/// for fstat
+#include <sys/mman.h>	/// for mmap
+#include <fcntl.h>		/// for open, openat
+#include <unistd.h>		/// for fstat, close
 #include <string.h> 	/// for memcpy
-
-#define ZD_SUCCESS  0
-#define ZD_FAILURE -1
-#define ZD_BAD_VALUES  5001 /** time_t start > time_t end */
-#define ZD_DIR_PATH    5002 /** path to zonetab directory not found */
-#define ZD_FOPEN       5003 /** file not found */
-#define ZD_FREAD       5004 /** unable to read file */
-#define ZD_MALLOC      5005 /** memory allocation error */
-#define ZD_TZIF_HEADER 5006 /** unable to parse tzif header */
-
-#define NUMERIC "-123456789"
-#define TIMERIC "-123456789:"
-#define NOTABBR "-123456789:,"
+#include <pthread.h>		/// for pthread_rwlock_t
+#include "zdump3.h"		/// for zdumpinfo, zdump_zone, ZD_*
 
  
-/// zdumpinfo - an element of the array to return
-#define MAX_TZ_ABBR_SIZE   10  /// safe
-typedef struct {
-	time_t	start;    	/// seconds from epoch
-	int		utc_offset;	/// in seconds
-	int		save_secs;	/// (0 if not dst)
-	char	abbr[MAX_TZ_ABBR_SIZE]; /// terminate with '\0'
-	} zdumpinfo;
-
 /// timezonefileheader - exists in one or two parts of a tzif file
 /// refer to 'man 5 tzfile' for structure of the TZif file
 #define HEADER_LEN 44
@@ -72,45 +52,13 @@ typedef struct {
 	} timezonefileheader;
 #define TZIF1_FIELD_SIZE 4
 #define TZIF2_FIELD_SIZE 8
-static char *local_time_type_ptr, *ttinfo_ptr, *tz_abbrev_ptr;
 #define SIZE_OF_TTINFO 6
 
 
-/// posix rule details
-typedef struct {
-	char type[2];
-	char abbr[2][MAX_TZ_ABBR_SIZE];
-	int j[2];
-	int m[2];
-	int w[2];
-	int d[2];
-	int offset[2];
-	int start_time[2];
-	int hour[2];
-	int min[2];
-	int sec[2];
-	int has_dst;
-	int save_secs[2];
-	} rule_detail;
-#define STD 0
-#define DST 1
-#define DEFAULT_START_TIME 2 * 60 * 60
-#define DEFAULT_START_HOUR 2
-#define DEFAULT_START_MIN  0
-#define DEFAULT_START_SEC  0
-
-
-#define BUFFER_INCREMENT 3  /// safe for a single year
-void* perform_a_realloc(void *old_buffer, size_t *buff_size)
-{
-	void *new_ret;
-	*buff_size = *buff_size + (sizeof(zdumpinfo) * BUFFER_INCREMENT);
-	new_ret = realloc(old_buffer, *buff_size);
-	if (new_ret == NULL) free(old_buffer);
-	/// an alternative would be that if num_entries > 0
-	/// return with what we've ZD_SUCCESSfully read
-	return new_ret;
-}
+#define SECONDS_PER_DAY 86400
+#define DEFAULT_RULE_TIME (2 * 60 * 60)	/// 02:00 local
+#define DEFAULT_RULE ",M3.2.0,M11.1.0"	/// as glibc, for a rule without dates
+
 
 signed long flip_tz_long( const char *sourceptr, const unsigned int field_size)
 {
@@ -130,27 +78,6 @@ signed long flip_tz_long( const char *sourceptr, const unsigned int field_size)
 	return retval;
 }
 
-void j_to_md ( int j, int* m, int* d)
-{
-	/// For the TZ rule,   j = 1 - 365. no leap yeaers recognized
-	/// For the tm struct, j = 0 -365, leap years ARE recognized
-	/// This function parses the TZ POSIX rule into terms compatible
-	/// with the tm struct: m = 0 - 11, d = 1 -31
-/**jan*/if (j<32)         { *m = 0; *d = j; }
-/**feb*/else if (j < 60)  { *m = 1; *d = j-31; }
-/**mar*/else if (j < 91)  { *m = 2; *d = j-60; }
-/**apr*/else if (j < 121) { *m = 3; *d = j-91 ; }
-/**may*/else if (j < 152) { *m = 4; *d = j-121; }
-/**jun*/else if (j < 182) { *m = 5; *d = j-152; }
-/**jul*/else if (j < 213) { *m = 6; *d = j-182; }
-/**aug*/else if (j < 244) { *m = 7; *d = j-213; }
-/**sep*/else if (j < 274) { *m = 8; *d = j-244; }
-/**oct*/else if (j < 305) { *m = 9; *d = j-274; }
-/**nov*/else if (j < 335) { *m = 10; *d = j-305; }
-/**dec*/else              { *m = 11; *d = j-335; }
-	return;
-}
-
 int read_tz_header( timezonefileheader *header,  const char *temp_buffer)
 {
 	const int field_size = 4;
@@ -162,296 +89,967 @@ int read_tz_header( timezonefileheader *header,  const char *temp_buffer)
 	header->timecnt = flip_tz_long(&temp_buffer[32], field_size);
 	header->typecnt = flip_tz_long(&temp_buffer[36], field_size);
 	header->charcnt = flip_tz_long(&temp_buffer[40], field_size);
-	if ( (header->typecnt == 0) || (header->timecnt == 0) ) return 0;
+	/// a zone with no transitions (eg. Etc/UTC) is all local time type 0
+	if (header->typecnt == 0) return 0;
 	return 1;
 }
 
-void add_a_rule_entry( const time_t start, void* return_data, int* num_entries,
-                       const int utc_offset, const int save_secs, const char* abbr)
+/// the local time type after the first n transitions; before the
+/// first transition, local time type 0 applies
+static int local_time_offset( const zdump_zone* zone, const unsigned long n )
 {
-	zdumpinfo* zd;
-	zd = (zdumpinfo*) return_data + *num_entries;
-	zd->start = start;
-	zd->utc_offset = utc_offset;
-	zd->save_secs = save_secs;
-	strncpy( zd->abbr, abbr, MAX_TZ_ABBR_SIZE);
-	*num_entries = *num_entries + 1;
+	return (n > 0 ? zone->local_time_types[n - 1] : 0) * SIZE_OF_TTINFO;
 }
 
-void add_a_tzif_entry( const int i, const time_t start, void* return_data, int* num_entries )
+static void add_a_tzif_entry( const zdump_zone* zone, const unsigned long n, const time_t start,
+                       void* return_data, int* num_entries )
 {
-	char* endptr;
-	int local_time_offset = local_time_type_ptr[i] * SIZE_OF_TTINFO;
-	char* tzabbr;
+	int ttinfo_offset = local_time_offset( zone, n );
+	const char* tzabbr;
 	zdumpinfo* zd;
-	int prior_local_time_offset;
 
 	zd = (zdumpinfo*) return_data + *num_entries;
 	zd->start = start;
-	zd->utc_offset = (int) flip_tz_long( ttinfo_ptr + local_time_offset, 4);
+	zd->utc_offset = (int) flip_tz_long( zone->ttinfo + ttinfo_offset, 4);
 	zd->save_secs = 0;
-	if ((i != 0) && (ttinfo_ptr[ local_time_offset + 4 ]))
+	if ((n > 1) && (zone->ttinfo[ ttinfo_offset + 4 ]))
 	{
-		prior_local_time_offset = local_time_type_ptr[i-1] * SIZE_OF_TTINFO;
 		zd->save_secs = abs( zd->utc_offset
-						- ((int) flip_tz_long( ttinfo_ptr + prior_local_time_offset, 4)) );
+				- ((int) flip_tz_long( zone->ttinfo + local_time_offset( zone, n - 1 ), 4)) );
 	}
-	tzabbr = &tz_abbrev_ptr[ (int) ttinfo_ptr[ local_time_offset + 5 ] ];
-	endptr = mempcpy( zd->abbr, tzabbr, strlen(tzabbr) );
-	memset( endptr, '\0', 1);
+	tzabbr = &zone->abbrevs[ (unsigned char) zone->ttinfo[ ttinfo_offset + 5 ] ];
+	strncpy( zd->abbr, tzabbr, MAX_TZ_ABBR_SIZE - 1 );
+	zd->abbr[MAX_TZ_ABBR_SIZE - 1] = '\0';
 	*num_entries = *num_entries + 1;
 }
 
-int get_time( char *strptr, int *hour, int *min, int *sec )
+/****************************************************
+* days_from_civil
+*   days from 1970-01-01 to a proleptic gregorian date
+***************************************************/
+static long days_from_civil( long year, const int month, const int day )
+{
+	long era, year_of_era, day_of_year, day_of_era;
+
+	year -= month <= 2;
+	era = (year >= 0 ? year : year - 399) / 400;
+	year_of_era = year - era * 400;
+	day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+	return era * 146097 + day_of_era - 719468;
+}
+
+/****************************************************
+* year_of_time
+*   the gregorian year, in UTC, of seconds from epoch
+***************************************************/
+static long year_of_time( const time_t t )
+{
+	long days, era, day_of_era, year_of_era, day_of_year, shifted_month;
+
+	days = t / SECONDS_PER_DAY - (t % SECONDS_PER_DAY < 0);
+	days += 719468;
+	era = (days >= 0 ? days : days - 146096) / 146097;
+	day_of_era = days - era * 146097;
+	year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524
+					- day_of_era / 146096) / 365;
+	day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+	shifted_month = (5 * day_of_year + 2) / 153;
+	return year_of_era + era * 400 + (shifted_month >= 10);
+}
+
+static int is_leap_year( const long year )
+{
+	return ((year % 4 == 0) && (year % 100 != 0)) || (year % 400 == 0);
+}
+
+static int days_in_month( const long year, const int month )
+{
+	static const int month_days[12] = { 31,28,31,30,31,30,31,31,30,31,30,31 };
+	return month_days[month - 1] + ((month == 2) && is_leap_year( year ));
+}
+
+/****************************************************
+* rule_number
+*   an unsigned decimal, no more than max
+***************************************************/
+static const char* rule_number( const char* s, int* value, const int max )
+{
+	if ((*s < '0') || (*s > '9')) return NULL;
+	*value = 0;
+	while ((*s >= '0') && (*s <= '9'))
+	{
+		*value = *value * 10 + (*s - '0');
+		if (*value > max) return NULL;
+		s++;
+	}
+	return s;
+}
+
+/****************************************************
+* rule_name
+*   a time zone abbreviation, either alphabetic or
+*   quoted as <...> (eg. <+0330>)
+***************************************************/
+static const char* rule_name( const char* s, char* abbr )
 {
-	int fields_found = 0;
-	int sign;
+	const char* name = s;
+	size_t len;
 
-	fields_found = sscanf(strptr, "%i:%i:%i", hour, min, sec);
-	switch (fields_found)
+	if (*s == '<')
 	{
-	case 0: *hour = DEFAULT_START_HOUR;
-	case 1: *min = DEFAULT_START_MIN;
-	case 2: *sec = DEFAULT_START_SEC;
+		name = ++s;
+		while ((*s != '>') && (*s != '\0') && (*s != '\n')) s++;
+		if (*s != '>') return NULL;
+		len = s++ - name;
 	}
-	sign = *hour < 0 ? -1 : 1;
-	return (*hour * 3600) + (sign * ((*min * 60) + *sec));
-}
-
-char* rule_julian( int i, char* next, rule_detail* p_rule )
-{
-	char julian[4];
-	int  len = 0;
-	
-
-	next++;
-	p_rule->type[i] = 'J';
-	len = strspn(next, NUMERIC);
-	if (len > 3) return NULL;
-	memcpy(&julian, next, len);
-	memset(&julian[len],'\0',1);
-	p_rule->j[i] = atoi( (char*) &julian);
-	j_to_md(p_rule->j[i], &p_rule->m[i], &p_rule->d[i]);
-	next += len;
-	if (*next == '/') p_rule->start_time[i] = get_time(next+1, 
-									&p_rule->hour[i], &p_rule->min[i], &p_rule->sec[i]);
 	else
 	{
-		p_rule->start_time[i] = DEFAULT_START_TIME;
-		p_rule->hour[i] = DEFAULT_START_HOUR;
-		p_rule->min[i] = DEFAULT_START_MIN;
-		p_rule->sec[i] = DEFAULT_START_SEC;
+		while (((*s >= 'A') && (*s <= 'Z')) || ((*s >= 'a') && (*s <= 'z'))) s++;
+		len = s - name;
 	}
-	return strchr( next, ',' );
+	if (len == 0) return NULL;
+	if (len > MAX_TZ_ABBR_SIZE - 1) len = MAX_TZ_ABBR_SIZE - 1;
+	memcpy( abbr, name, len );
+	abbr[len] = '\0';
+	return s;
 }
 
-char* rule_mwd( int i, char* next, rule_detail* p_rule )
+/****************************************************
+* rule_time
+*   [+-]hh[:mm[:ss]], in seconds; hours may run to 167,
+*   as RFC 8536 allows for transition times
+***************************************************/
+static const char* rule_time( const char* s, int* seconds )
 {
-	char *next_time  = NULL;
-	p_rule->type[i] = 'M';
-	next++;
-	// maybe error-check for 3 values read in sscanf?
-	sscanf(next, "%i.%i.%i", &p_rule->m[i], &p_rule->w[i], &p_rule->d[i]);
-	next_time = strchr( next, '/' );
-	next      = strchr( next, ',' );
-	if ((next_time != NULL) && ((next == NULL) || (next_time < next)))
+	int sign = 1;
+	int hour, min = 0, sec = 0;
+
+	if (*s == '-') { sign = -1; s++; }
+	else if (*s == '+') s++;
+	s = rule_number( s, &hour, 167 );
+	if ((s != NULL) && (*s == ':'))
 	{
-		next_time++;
-		p_rule->start_time[i] = get_time(next_time, &p_rule->hour[i], &p_rule->min[i], &p_rule->sec[i]);
+		s = rule_number( s + 1, &min, 59 );
+		if ((s != NULL) && (*s == ':')) s = rule_number( s + 1, &sec, 59 );
 	}
-	else
+	if (s == NULL) return NULL;
+	*seconds = sign * (hour * 3600 + min * 60 + sec);
+	return s;
+}
+
+/****************************************************
+* rule_date
+*   the day, and optional time, a period begins:
+*   Mm.w.d, Jn or n, then [/time]
+***************************************************/
+static const char* rule_date( const char* s, zdump_rule* rule, const int i )
+{
+	rule->type[i] = *s;
+	switch (*s)
 	{
-		p_rule->start_time[i] = DEFAULT_START_TIME;
-		p_rule->hour[i] = DEFAULT_START_HOUR;
-		p_rule->min[i] = DEFAULT_START_MIN;
-		p_rule->sec[i] = DEFAULT_START_SEC;
+	case 'M':
+		s = rule_number( s + 1, &rule->m[i], 12 );
+		if ((s == NULL) || (*s != '.') || (rule->m[i] < 1)) return NULL;
+		s = rule_number( s + 1, &rule->w[i], 5 );
+		if ((s == NULL) || (*s != '.') || (rule->w[i] < 1)) return NULL;
+		s = rule_number( s + 1, &rule->d[i], 6 );
+		break;
+	case 'J':
+		s = rule_number( s + 1, &rule->j[i], 365 );
+		if ((s != NULL) && (rule->j[i] < 1)) return NULL;
+		break;
+	default:
+		rule->type[i] = 'n';
+		s = rule_number( s, &rule->j[i], 365 );
+		break;
 	}
-	return next;
-}
-
-int rule_decode( const char* tzif, const size_t tzif_size, rule_detail* p_rule )
-{
-	char *rule_string = NULL;
-	int  rule_len;
-	char *next = NULL;
-	int  len = 0;
-	int  offset_hour, offset_min, offset_sec;
-
-	// consider error checking and bounds checking
-	// don't depend on it being a valid file
-	if ( tzif[tzif_size] == '\x0a' ) return ZD_FAILURE;
-	rule_string = memrchr( tzif, '\x0a', tzif_size);
-	if (rule_string == NULL) return ZD_FAILURE;
-	rule_string++;
-	next = rule_string;
-	setenv("TZ",rule_string,1);
-	rule_len = strlen(rule_string);
-	if (rule_len == 0) return ZD_FAILURE;
-	memset(p_rule,'\0',sizeof(rule_detail));
-	len = strcspn(rule_string, NUMERIC);
-	memcpy(p_rule->abbr[STD], rule_string, len);
-	next += len;
-	len = strspn(next, TIMERIC);
-	p_rule->offset[STD] = get_time( next, &offset_hour, &offset_min, &offset_sec );
-	next +=  len;
-	if ( next != (rule_string + rule_len -1) )
+	if (s == NULL) return NULL;
+	rule->time[i] = DEFAULT_RULE_TIME;
+	if (*s == '/') s = rule_time( s + 1, &rule->time[i] );
+	return s;
+}
+
+/****************************************************
+* zdump_rule_decode
+***************************************************/
+int zdump_rule_decode( zdump_rule* rule, const char* tz_string )
+{
+	const char* s = tz_string;
+	int offset;
+
+	memset( rule, 0, sizeof(zdump_rule) );
+	/// POSIX offsets are west of UTC; ours, like TZif's, are east
+	s = rule_name( s, rule->abbr[ZD_STD] );
+	if (s != NULL) s = rule_time( s, &offset );
+	if (s == NULL) return ZD_FAILURE;
+	rule->offset[ZD_STD] = -offset;
+	if ((*s == '\0') || (*s == '\n')) return ZD_SUCCESS;
+
+	s = rule_name( s, rule->abbr[ZD_DST] );
+	if (s == NULL) return ZD_FAILURE;
+	rule->has_dst = 1;
+	rule->offset[ZD_DST] = rule->offset[ZD_STD] + 3600;
+	if ((*s != ',') && (*s != '\0') && (*s != '\n'))
 	{
-		p_rule->has_dst = 1;
-		len = strcspn(next, NOTABBR);
-		memcpy(p_rule->abbr[DST], next, len);
-		next += len;
-		len = strspn(next, TIMERIC);
-		if (len == 0) p_rule->offset[DST] = p_rule->offset[STD] + 3600;
-		else p_rule->offset[DST] = get_time( next, &offset_hour, &offset_min, &offset_sec );
-		next += len;
-		p_rule->save_secs[STD] = abs(p_rule->offset[DST] - p_rule->offset[STD]);
-		next++;
-		if (*next == 'J') next = rule_julian(STD, next, p_rule);
-		else next = rule_mwd(STD, next, p_rule);
-		if (*next == ',')
-		{
-			next++;
-			if (*next == 'J') next = rule_julian(DST, next, p_rule);
-			else next = rule_mwd(DST, next, p_rule);
-		}
+		s = rule_time( s, &offset );
+		if (s == NULL) return ZD_FAILURE;
+		rule->offset[ZD_DST] = -offset;
 	}
-/** DEBUG
-	printf("rule details:\n\
-%c %6s j=%3d m=%2d w=%d d=%2d offset=%6d start_time=%6d h=%2d m=%2d s=%2d has_dst=%d save_secs=%d\n\
-%c %6s j=%3d m=%2d w=%d d=%2d offset=%6d start_time=%6d h=%2d m=%2d s=%2d has_dst=%d save_secs=%d\n",
-(int) p_rule->type[0], (char*) &p_rule->abbr[0], p_rule->j[0], p_rule->m[0], p_rule->w[0], p_rule->d[0],
-p_rule->offset[0], p_rule->start_time[0], p_rule->hour[0], p_rule->min[0], p_rule->sec[0], p_rule->has_dst, p_rule->save_secs[0],
-(int) p_rule->type[1], (char*) &p_rule->abbr[1], p_rule->j[1], p_rule->m[1], p_rule->w[1], p_rule->d[1],
-p_rule->offset[1], p_rule->start_time[1], p_rule->hour[1], p_rule->min[1], p_rule->sec[1], p_rule->has_dst, p_rule->save_secs[1]
-);
-exit(0);
-*/
+	if (*s != ',') s = DEFAULT_RULE;
+	s = rule_date( s + 1, rule, ZD_DST );
+	if ((s == NULL) || (*s != ',')) return ZD_FAILURE;
+	s = rule_date( s + 1, rule, ZD_STD );
+	if ((s == NULL) || ((*s != '\0') && (*s != '\n'))) return ZD_FAILURE;
 	return ZD_SUCCESS;
 }
 
-void init_tm_struct( struct tm *tmx )
+/****************************************************
+* zdump_rule_transition
+***************************************************/
+time_t zdump_rule_transition( const zdump_rule* rule, const int dst, const long year )
 {
-		tmx->tm_sec = 0;
-		tmx->tm_min = 0;
-		tmx->tm_hour = 0;
-		tmx->tm_mday = 0;
-		tmx->tm_mon = 0;
-		tmx->tm_year = 0;
-		tmx->tm_wday = 0;
-		tmx->tm_yday = 0;
-		tmx->tm_isdst = 0;
+	long day;
+	int first_wday, mday;
+
+	switch (rule->type[dst])
+	{
+	case 'M':
+		day = days_from_civil( year, rule->m[dst], 1 );
+		/// 1970-01-01 was a Thursday
+		first_wday = (int) (((day + 4) % 7 + 7) % 7);
+		mday = 1 + (rule->d[dst] - first_wday + 7) % 7 + (rule->w[dst] - 1) * 7;
+		if (mday > days_in_month( year, rule->m[dst] )) mday -= 7;
+		day += mday - 1;
+		break;
+	case 'J':
+		/// counts 1 - 365, never February 29th
+		day = days_from_civil( year, 1, 1 ) + rule->j[dst] - 1
+			+ ((rule->j[dst] >= 60) && is_leap_year( year ));
+		break;
+	default:
+		day = days_from_civil( year, 1, 1 ) + rule->j[dst];
+		break;
+	}
+	/// the time is on the clock in use before the transition
+	return (time_t) day * SECONDS_PER_DAY + rule->time[dst]
+			- rule->offset[dst == ZD_DST ? ZD_STD : ZD_DST];
 }
 
-int utc_seconds( const struct tm *tmx )
+/****************************************************
+* year_transitions
+*   a year's two transitions, in order
+***************************************************/
+static void year_transitions( const zdump_rule* rule, const long year,
+                       time_t times[2], int kinds[2] )
 {
-	return tmx->tm_sec + (tmx->tm_min * 60) + (tmx->tm_hour * 3600);
+	time_t begin, finish;
+
+	begin = zdump_rule_transition( rule, ZD_DST, year );
+	finish = zdump_rule_transition( rule, ZD_STD, year );
+	/// in the southern hemisphere, DST ends early in the year
+	kinds[0] = begin <= finish ? ZD_DST : ZD_STD;
+	kinds[1] = begin <= finish ? ZD_STD : ZD_DST;
+	times[0] = begin <= finish ? begin : finish;
+	times[1] = begin <= finish ? finish : begin;
 }
 
-int rule_dump( const char* tzif, const size_t tzif_size,
-					  const time_t start, const time_t end, time_t current,
-					  int* num_entries, void** return_data, size_t *ret_buff_size)
+/****************************************************
+* zdump_rule_offset_at
+***************************************************/
+int zdump_rule_offset_at( const zdump_rule* rule, const time_t t, zdump_offset* offset )
+{
+	time_t times[6];
+	int kinds[6];
+	int i, n, last = -1, kind = ZD_STD;
+
+	offset->start = ZD_TIME_MIN;
+	offset->until = ZD_TIME_MAX;
+	if (rule->has_dst)
+	{
+		/// the year of t in UTC, and those either side, cover any
+		/// local time the rule can name
+		for (n = 0; n < 6; n += 2)
+			year_transitions( rule, year_of_time( t ) + n / 2 - 1, times + n, kinds + n );
+		for (i = 0; i < n; i++)
+			if (times[i] <= t) last = i;
+		if (last >= 0)
+		{
+			kind = kinds[last];
+			offset->start = times[last];
+		}
+		else kind = kinds[0] == ZD_DST ? ZD_STD : ZD_DST;
+		if (last + 1 < n) offset->until = times[last + 1];
+	}
+	offset->utc_offset = rule->offset[kind];
+	offset->is_dst = kind == ZD_DST;
+	offset->abbr = rule->abbr[kind];
+	return ZD_SUCCESS;
+}
+
+/****************************************************
+* add_a_rule_entry
+***************************************************/
+static void add_a_rule_entry( const zdump_rule* rule, const int kind, const time_t start,
+                       void* return_data, int* num_entries )
 {
-	rule_detail p_rule;
-	time_t prior;
-	struct tm tm_local, tm_gmt, tm_prior;
-	int utc_offset;
-	int save_secs;
 	zdumpinfo* zd;
+
+	zd = (zdumpinfo*) return_data + *num_entries;
+	zd->start = start;
+	zd->utc_offset = rule->offset[kind];
+	zd->save_secs = kind == ZD_DST ? abs( rule->offset[ZD_DST] - rule->offset[ZD_STD] ) : 0;
+	memcpy( zd->abbr, rule->abbr[kind], MAX_TZ_ABBR_SIZE );
+	*num_entries = *num_entries + 1;
+}
+
+/****************************************************
+* rule_dump
+*   the rule's transitions after time after, up to and
+*   including end; with return_data NULL, only count
+*   them. Returns the count.
+***************************************************/
+static int rule_dump( const zdump_rule* rule, const time_t after, const time_t end,
+               void* return_data, int* num_entries )
+{
+	zdump_offset state;
+	time_t times[2];
+	int kinds[2];
+	time_t last_time = 0;
+	int kind, count = 0;
+	long year, last_year;
 	int i;
 
-// Should I make this a little simpler by using the glibc version
-// of struct tm which has additional fields:
-//  long tm_gmtoff;           /* Seconds east of UTC */
-//  const char *tm_zone;      /* Timezone abbreviation */
-// returned by gmtime_r localtime_r
-	if (rule_decode( tzif, tzif_size, &p_rule ) == ZD_FAILURE) return ZD_FAILURE;
-	init_tm_struct(&tm_local);
-	init_tm_struct(&tm_gmt);
-	if (current < start)
+	if ((!rule->has_dst) || (end <= after)) return 0;
+	zdump_rule_offset_at( rule, after, &state );
+	kind = state.is_dst ? ZD_DST : ZD_STD;
+	last_year = year_of_time( end ) + 1;
+	for (year = year_of_time( after ) - 1; year <= last_year; year++)
 	{
-		// We really should try to be totally independant of
-		// these two functions localtime_r() and gmtime_r()
-		localtime_r(&start, &tm_local);
-		gmtime_r(&start, &tm_gmt);
-		utc_offset = utc_seconds(&tm_local) - utc_seconds(&tm_gmt);
-		// FIXME - account for possibility of initial transition being
-		// from standard to standard or DST to DST, with different offsets
-		if (tm_local.tm_isdst <= 0) save_secs = tm_local.tm_isdst;
-		else
+		year_transitions( rule, year, times, kinds );
+		for (i = 0; i < 2; i++)
 		{
-			localtime_r(&current, &tm_prior);
-			gmtime_r(&current, &tm_gmt);
-			save_secs = abs(utc_offset
-						- (utc_seconds(&tm_prior) - utc_seconds(&tm_gmt)) );
+			if ((times[i] <= after) || (times[i] > end) || (kinds[i] == kind)) continue;
+			/// a rule DST all year (eg. ,0/0,J365/25) ends one year's DST
+			/// at the moment it starts the next's; the two cancel
+			if ((count > 0) && (times[i] == last_time))
+			{
+				count--;
+				if (return_data != NULL) *num_entries = *num_entries - 1;
+			}
+			else
+			{
+				if (return_data != NULL)
+					add_a_rule_entry( rule, kinds[i], times[i], return_data, num_entries );
+				count++;
+				last_time = times[i];
+			}
+			kind = kinds[i];
 		}
-		if ( !( *num_entries%BUFFER_INCREMENT) )
+	}
+	return count;
+}
+
+
+/****************************************************
+* tzif_block_size
+*   bytes of data following a header, up to the next
+*   header (or footer)
+***************************************************/
+static size_t tzif_block_size( const timezonefileheader* tzh, const unsigned int field_size )
+{
+	return tzh->timecnt * field_size + tzh->timecnt
+		 + tzh->typecnt * SIZE_OF_TTINFO + tzh->charcnt
+		 + tzh->leapcnt * (field_size + 4)
+		 + tzh->ttisstdcnt + tzh->ttisgmtcnt;
+}
+
+/****************************************************
+* zdump_zone_parse
+*   find the tables of a mapped TZif file
+***************************************************/
+static int zdump_zone_parse( zdump_zone* zone )
+{
+	timezonefileheader tzh;
+	const char* start_ptr;	/// point in the map where we start to parse
+	const char* footer;
+	const char* footer_end;
+	size_t block_size;
+	unsigned long i;
+
+	if (zone->map_size < HEADER_LEN) return ZD_TZIF_HEADER;
+	if (memcmp( zone->map, "TZif", 4 ) != 0) return ZD_TZIF_HEADER;
+	if (!read_tz_header( &tzh, zone->map )) return ZD_TZIF_HEADER;
+	start_ptr = zone->map + HEADER_LEN;
+	zone->field_size = TZIF1_FIELD_SIZE;
+	block_size = tzif_block_size( &tzh, TZIF1_FIELD_SIZE );
+	if (block_size > zone->map_size - HEADER_LEN) return ZD_TZIF_HEADER;
+
+	/// version 2 and later files repeat the data with 64 bit times,
+	/// and end with a POSIX TZ rule for times after the last transition
+	zone->rule[0] = '\0';
+	zone->rule_len = 0;
+	zone->has_rule = 0;
+	if (tzh.magicnumber[4] >= '2')
+	{
+		start_ptr += block_size;
+		if ((size_t) (start_ptr - zone->map) > zone->map_size - HEADER_LEN) return ZD_TZIF_HEADER;
+		if (memcmp( start_ptr, "TZif", 4 ) != 0) return ZD_TZIF_HEADER;
+		if (!read_tz_header( &tzh, start_ptr )) return ZD_TZIF_HEADER;
+		start_ptr += HEADER_LEN;
+		zone->field_size = TZIF2_FIELD_SIZE;
+		block_size = tzif_block_size( &tzh, TZIF2_FIELD_SIZE );
+		if (block_size > zone->map_size - (start_ptr - zone->map)) return ZD_TZIF_HEADER;
+
+		footer = start_ptr + block_size;
+		footer_end = zone->map + zone->map_size;
+		if ((footer < footer_end) && (*footer == '\n'))
 		{
-			*return_data = perform_a_realloc(*return_data, ret_buff_size);
-			if (*return_data == NULL) return ZD_FAILURE;
+			footer++;
+			footer_end = memchr( footer, '\n', footer_end - footer );
+			if ( (footer_end != NULL) && (footer_end - footer + 2 <= ZD_RULE_SIZE) )
+			{
+				zone->rule_len = footer_end - footer + 1;
+				memcpy( zone->rule, footer, zone->rule_len );
+				zone->rule[zone->rule_len] = '\0';
+				zone->has_rule = zdump_rule_decode( &zone->tz_rule, zone->rule ) == ZD_SUCCESS;
+			}
 		}
-///		The following only works when _BSD_SOURCE is set, because
-///		tm_gmtoff and *tm_zone are part of the glibc version of struct tm,
-///		currently only implemented as a BSD extension.
-///		add_a_rule_entry( start, *return_data, num_entries, utc_offset, save_secs, tm_local.tm_zone );
-// FIXME - replace "---" with a real time zone abbreviation value!
-		add_a_rule_entry( start, *return_data, num_entries, utc_offset, save_secs, "---" );
-		if (!p_rule.has_dst) return ZD_SUCCESS;
-		memcpy( (char*) &tm_prior, (char*) &tm_local, sizeof(struct tm));
 	}
-	else
+
+	zone->timecnt = tzh.timecnt;
+	zone->typecnt = tzh.typecnt;
+	zone->charcnt = tzh.charcnt;
+	zone->transition_times = start_ptr;
+	zone->local_time_types = (const unsigned char*) start_ptr + tzh.timecnt * zone->field_size;
+	zone->ttinfo = (const char*) zone->local_time_types + tzh.timecnt;
+	zone->abbrevs = zone->ttinfo + tzh.typecnt * SIZE_OF_TTINFO;
+
+	/// lookups index the tables without further checks
+	for (i = 0; i < tzh.timecnt; i++)
+		if (zone->local_time_types[i] >= tzh.typecnt) return ZD_TZIF_HEADER;
+	for (i = 0; i < tzh.typecnt; i++)
+		if ((unsigned char) zone->ttinfo[ i * SIZE_OF_TTINFO + 5 ] >= tzh.charcnt)
+			return ZD_TZIF_HEADER;
+	return ZD_SUCCESS;
+}
+
+/****************************************************
+* zdump_zone_open_at
+***************************************************/
+int zdump_zone_open_at( zdump_zone* zone, const int dir_fd, const char* path )
+{
+	struct stat file_status;
+	void* map;
+	int fd;
+	int result;
+
+	zone->map = NULL;
+	zone->map_size = 0;
+	fd = openat( dir_fd, path, O_RDONLY | O_CLOEXEC );
+	if (fd < 0) return ZD_FOPEN;
+	if ( (fstat( fd, &file_status ) != 0) || (file_status.st_size <= 0) )
+	{
+		close( fd );
+		return ZD_FREAD;
+	}
+	map = mmap( NULL, file_status.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	close( fd );
+	if (map == MAP_FAILED) return ZD_FREAD;
+
+	zone->map = map;
+	zone->map_size = file_status.st_size;
+	result = zdump_zone_parse( zone );
+	if (result != ZD_SUCCESS) zdump_zone_close( zone );
+	return result;
+}
+
+/****************************************************
+* zdump_zone_open
+***************************************************/
+int zdump_zone_open( zdump_zone* zone, const char* tzname )
+{
+	const char* tzdir;
+	const char* tzdirlist[2] = { "/usr/share/zoneinfo/",	/// libc >= 5.4.6
+								 "/usr/lib/zoneinfo/" };	/// libc <  5.4.6
+	int dir_fd = -1;
+	int result;
+
+	zone->map = NULL;
+	zone->map_size = 0;
+	if (tzname == NULL) tzname = "localtime";
+	if (tzname[0] == '/') return zdump_zone_open_at( zone, AT_FDCWD, tzname );
+
+	tzdir = getenv("TZDIR");
+	if (tzdir != NULL) dir_fd = open( tzdir, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+	if (dir_fd < 0) dir_fd = open( tzdirlist[0], O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+	if (dir_fd < 0) dir_fd = open( tzdirlist[1], O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+	if (dir_fd < 0) return ZD_DIR_PATH;
+	result = zdump_zone_open_at( zone, dir_fd, tzname );
+	close( dir_fd );
+	return result;
+}
+
+/****************************************************
+* zdump_zone_close
+***************************************************/
+void zdump_zone_close( zdump_zone* zone )
+{
+	if (zone->map != NULL) munmap( (void*) zone->map, zone->map_size );
+	zone->map = NULL;
+	zone->map_size = 0;
+}
+
+/****************************************************
+* transition_time
+*   the i'th transition of a zone, in seconds from epoch
+***************************************************/
+static time_t transition_time( const zdump_zone* zone, const unsigned long i )
+{
+	return (time_t) flip_tz_long( zone->transition_times + i * zone->field_size,
+								  zone->field_size );
+}
+
+/****************************************************
+* transitions_until
+*   binary search for the number of transitions at or
+*   before time t; the state at t is that of the last
+*   of them, or local time type 0 if there are none
+***************************************************/
+static unsigned long transitions_until( const zdump_zone* zone, const time_t t )
+{
+	unsigned long low = 0;
+	unsigned long high = zone->timecnt;
+	unsigned long middle;
+
+	while (low < high)
+	{
+		middle = low + (high - low) / 2;
+		if (transition_time( zone, middle ) <= t) low = middle + 1;
+		else high = middle;
+	}
+	return low;
+}
+
+/****************************************************
+* rule_begins
+*   the footer rule governs times after the last
+*   transition in the file, or all times if it has none
+***************************************************/
+static time_t rule_begins( const zdump_zone* zone )
+{
+	return zone->timecnt > 0 ? transition_time( zone, zone->timecnt - 1 ) : ZD_TIME_MIN;
+}
+
+/****************************************************
+* zdump_zone_offset_at
+***************************************************/
+int zdump_zone_offset_at( const zdump_zone* zone, const time_t t,
+                          zdump_offset* offset )
+{
+	unsigned long n;
+	int ttinfo_offset;
+	time_t after;
+	zdump_offset rule_state;
+
+	if (zone->map == NULL) return ZD_FAILURE;
+	after = rule_begins( zone );
+	if ((zone->has_rule) && (t > after))
 	{
-		zd = (zdumpinfo*) *return_data + (*num_entries - 1);
-		prior = zd->start;
-		localtime_r(&prior, &tm_prior);
+		zdump_rule_offset_at( &zone->tz_rule, t, offset );
+		if (offset->start < after) offset->start = after;
+		return ZD_SUCCESS;
 	}
-	if ((!tm_prior.tm_isdst) && (!p_rule.has_dst)) return ZD_SUCCESS;
-	i = tm_prior.tm_isdst > 0 ? 1 : 0;
-	while (1)
+	n = transitions_until( zone, t );
+	ttinfo_offset = local_time_offset( zone, n );
+	offset->utc_offset = (int) flip_tz_long( zone->ttinfo + ttinfo_offset, 4);
+	offset->is_dst = zone->ttinfo[ ttinfo_offset + 4 ] != 0;
+	offset->abbr = &zone->abbrevs[ (unsigned char) zone->ttinfo[ ttinfo_offset + 5 ] ];
+	offset->start = n > 0 ? transition_time( zone, n - 1 ) : ZD_TIME_MIN;
+	offset->until = n < zone->timecnt ? transition_time( zone, n ) : ZD_TIME_MAX;
+	if ((zone->has_rule) && (n == zone->timecnt))
 	{
-		tm_local.tm_hour = p_rule.hour[i];
-		tm_local.tm_min  = p_rule.min[i];
-		tm_local.tm_sec  = p_rule.sec[i];
-		switch (p_rule.type[i])
+		/// t is the last transition itself; the rule takes over after it
+		zdump_rule_offset_at( &zone->tz_rule, t, &rule_state );
+		offset->until = rule_state.until;
+	}
+	return ZD_SUCCESS;
+}
+
+/****************************************************
+* zdump_entry_at
+***************************************************/
+int zdump_entry_at( const zdumpinfo* data, const int num_entries, const time_t t )
+{
+	int low = 1;
+	int high = num_entries;
+	int middle;
+
+	/// data[0] is the state at the start of the dumped interval,
+	/// so it also answers for any earlier time
+	while (low < high)
+	{
+		middle = low + (high - low) / 2;
+		if (data[middle].start <= t) low = middle + 1;
+		else high = middle;
+	}
+	return low - 1;
+}
+
+/****************************************************
+* add_a_start_entry
+*   the state at the start of a dump
+***************************************************/
+static void add_a_start_entry( const zdump_zone* zone, const time_t start,
+                               void* return_data, int* num_entries )
+{
+	zdump_offset state;
+
+	if ((zone->has_rule) && (start > rule_begins( zone )))
+	{
+		zdump_rule_offset_at( &zone->tz_rule, start, &state );
+		add_a_rule_entry( &zone->tz_rule, state.is_dst ? ZD_DST : ZD_STD, start,
+							return_data, num_entries );
+	}
+	else add_a_tzif_entry( zone, transitions_until( zone, start ), start,
+							return_data, num_entries );
+}
+
+/****************************************************
+* zdump_zone_dump
+***************************************************/
+int zdump_zone_dump( const zdump_zone* zone,
+                     const time_t start, const time_t end,
+                     int* num_entries, void** return_data )
+{
+	unsigned long first, last, i;
+	size_t count;
+	time_t after;
+	int use_rule;
+
+	*num_entries = 0;
+	*return_data = NULL;
+	if (end < start) return ZD_BAD_VALUES;
+	if (zone->map == NULL) return ZD_FAILURE;
+
+	/// the state at start, and one entry per transition after start,
+	/// up to and including end; past the last transition in the file,
+	/// the transitions of the footer rule
+	after = rule_begins( zone );
+	use_rule = zone->has_rule && (end > after);
+	first = transitions_until( zone, start );
+	last = transitions_until( zone, end );
+	count = 1 + (last - first);
+	if (use_rule)
+		count += rule_dump( &zone->tz_rule, start > after ? start : after, end,
+							NULL, num_entries );
+	*return_data = malloc( count * sizeof(zdumpinfo) );
+	if (*return_data == NULL) return ZD_MALLOC;
+	add_a_start_entry( zone, start, *return_data, num_entries );
+	for (i = first; i < last; i++)
+		add_a_tzif_entry( zone, i + 1, transition_time( zone, i ), *return_data, num_entries );
+	if (use_rule)
+		rule_dump( &zone->tz_rule, start > after ? start : after, end,
+					*return_data, num_entries );
+	return ZD_SUCCESS;
+}
+
+
+
+/****************************************************
+* the zone cache
+*   zones by name, each with its transitions expanded
+*   over a window of years, evicted least recently used
+*   first. A read-write lock guards the table: lookups
+*   share it, so threads asking for cached zones do not
+*   wait on each other, while adding, evicting and
+*   invalidating take it alone. It is never held for file
+*   I/O. Reference counts and use stamps are atomic, so a
+*   lookup changes nothing the lock guards; an evicted or
+*   invalidated zone is freed when its last user releases
+*   it.
+***************************************************/
+#define ZD_CACHE_BUCKETS 256
+typedef struct cached_zone {
+	zdump_zone zone;		/// first, so a zone pointer finds its entry
+	char* name;
+	unsigned int hash;
+	int refcount;			/// users, plus one while in the cache; atomic
+	unsigned long last_used;	/// cache_clock at the latest lookup; atomic
+	zdumpinfo* window;		/// NULL if the window did not expand
+	int window_entries;
+	time_t window_start;
+	time_t window_end;
+	struct cached_zone* next_in_bucket;
+	} cached_zone;
+
+static cached_zone* cache_buckets[ZD_CACHE_BUCKETS];
+static int cache_count = 0;
+static int cache_capacity = ZD_CACHE_CAPACITY;
+static int cache_first_year = ZD_CACHE_FIRST_YEAR;
+static int cache_last_year = ZD_CACHE_LAST_YEAR;
+static unsigned long cache_clock = 0;
+static pthread_rwlock_t cache_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+/// a TZ value may name its file as ":America/New_York"
+static const char* cache_key( const char* tzname )
+{
+	if (tzname == NULL) return "localtime";
+	if (*tzname == ':') return tzname + 1;
+	return tzname;
+}
+
+static unsigned int cache_hash( const char* name )
+{
+	unsigned int hash = 5381;
+	while (*name) hash = hash * 33 + (unsigned char) *name++;
+	return hash;
+}
+
+static void cached_zone_free( cached_zone* entry )
+{
+	zdump_zone_close( &entry->zone );
+	free( entry->window );
+	free( entry->name );
+	free( entry );
+}
+
+/// takes a reference for the caller and marks the entry used; safe
+/// under the shared lock
+static void cache_use( cached_zone* entry )
+{
+	__atomic_add_fetch( &entry->refcount, 1, __ATOMIC_RELAXED );
+	__atomic_store_n( &entry->last_used,
+					  __atomic_add_fetch( &cache_clock, 1, __ATOMIC_RELAXED ),
+					  __ATOMIC_RELAXED );
+}
+
+/// drops a reference; returns non-zero if it was the last one
+static int cache_unref( cached_zone* entry )
+{
+	return __atomic_sub_fetch( &entry->refcount, 1, __ATOMIC_ACQ_REL ) == 0;
+}
+
+/// these expect the lock to be held, cache_find shared and the others
+/// alone
+static cached_zone* cache_find( const char* name, const unsigned int hash )
+{
+	cached_zone* entry = cache_buckets[hash % ZD_CACHE_BUCKETS];
+	while ( (entry != NULL) && ((entry->hash != hash) || strcmp( entry->name, name )) )
+		entry = entry->next_in_bucket;
+	return entry;
+}
+
+static cached_zone* cache_least_recently_used( void )
+{
+	cached_zone* oldest = NULL;
+	cached_zone* entry;
+	int i;
+
+	for (i = 0; i < ZD_CACHE_BUCKETS; i++)
+		for (entry = cache_buckets[i]; entry != NULL; entry = entry->next_in_bucket)
+			if ( (oldest == NULL) ||
+				 (long) (__atomic_load_n( &entry->last_used, __ATOMIC_RELAXED ) -
+						 __atomic_load_n( &oldest->last_used, __ATOMIC_RELAXED )) < 0 )
+				oldest = entry;
+	return oldest;
+}
+
+/// removes an entry from the cache; returns it if nobody holds it, for
+/// the caller to free once the lock is released
+static cached_zone* cache_remove( cached_zone* entry )
+{
+	cached_zone** link = &cache_buckets[entry->hash % ZD_CACHE_BUCKETS];
+
+	while (*link != entry) link = &(*link)->next_in_bucket;
+	*link = entry->next_in_bucket;
+	cache_count--;
+	if (cache_unref( entry )) return entry;
+	return NULL;
+}
+
+/****************************************************
+* cached_zone_new
+*   open a zone and expand its window, without the lock
+***************************************************/
+static int cached_zone_new( const char* name, const unsigned int hash,
+                            const int expand, cached_zone** new_entry )
+{
+	cached_zone* entry;
+	int result;
+
+	entry = calloc( 1, sizeof(cached_zone) );
+	if (entry == NULL) return ZD_MALLOC;
+	entry->name = malloc( strlen( name ) + 1 );
+	if (entry->name == NULL)
+	{
+		free( entry );
+		return ZD_MALLOC;
+	}
+	strcpy( entry->name, name );
+	entry->hash = hash;
+	entry->refcount = 1;
+	result = zdump_zone_open( &entry->zone, name );
+	if (result != ZD_SUCCESS)
+	{
+		free( entry->name );
+		free( entry );
+		return result;
+	}
+	if (expand)
+	{
+		pthread_rwlock_rdlock( &cache_lock );
+		entry->window_start = (time_t) days_from_civil( cache_first_year, 1, 1 ) * SECONDS_PER_DAY;
+		entry->window_end = (time_t) days_from_civil( cache_last_year + 1, 1, 1 ) * SECONDS_PER_DAY - 1;
+		pthread_rwlock_unlock( &cache_lock );
+		if (zdump_zone_dump( &entry->zone, entry->window_start, entry->window_end,
+							 &entry->window_entries, (void**) &entry->window ) != ZD_SUCCESS)
+			entry->window = NULL;
+	}
+	*new_entry = entry;
+	return ZD_SUCCESS;
+}
+
+/****************************************************
+* zdump_cache_get
+***************************************************/
+int zdump_cache_get( const char* tzname, const zdump_zone** zone )
+{
+	const char* name = cache_key( tzname );
+	unsigned int hash = cache_hash( name );
+	cached_zone* entry;
+	cached_zone* created = NULL;
+	cached_zone* evicted = NULL;
+	int expand;
+	int result;
+
+	pthread_rwlock_rdlock( &cache_lock );
+	entry = cache_find( name, hash );
+	if (entry != NULL)
+	{
+		cache_use( entry );
+		pthread_rwlock_unlock( &cache_lock );
+		*zone = &entry->zone;
+		return ZD_SUCCESS;
+	}
+	expand = cache_capacity > 0;
+	pthread_rwlock_unlock( &cache_lock );
+
+	result = cached_zone_new( name, hash, expand, &created );
+	if (result != ZD_SUCCESS) return result;
+
+	pthread_rwlock_wrlock( &cache_lock );
+	/// another thread may have opened it meanwhile
+	entry = cache_find( name, hash );
+	if (entry != NULL)
+	{
+		cache_use( entry );
+		evicted = created;
+	}
+	else
+	{
+		entry = created;
+		if (cache_capacity > 0)
 		{
-		case 'M':
-			tm_local.tm_mday = 1;
-			tm_local.tm_mon = p_rule.m[i] - 1;
-			if ( tm_prior.tm_mon < tm_local.tm_mon ) tm_local.tm_year = tm_prior.tm_year;
-			else tm_local.tm_year = tm_prior.tm_year + 1;
-			current = mktime(&tm_local);
-			tm_local.tm_mday = ((p_rule.w[i]-1)*7) + p_rule.d[i] + 1 + (7 - tm_local.tm_wday);
-			break;
-		case 'J':
-			if ( tm_prior.tm_yday < p_rule.j[i] ) tm_local.tm_year = tm_prior.tm_year;
-			else tm_local.tm_year = tm_prior.tm_year + 1;
-			tm_local.tm_mday  = p_rule.j[i];
-			tm_local.tm_mon  = 0;
-			break;
-		default: return ZD_FAILURE; break;
+			cache_use( entry );
+			entry->next_in_bucket = cache_buckets[hash % ZD_CACHE_BUCKETS];
+			cache_buckets[hash % ZD_CACHE_BUCKETS] = entry;
+			cache_count++;
+			if (cache_count > cache_capacity)
+				evicted = cache_remove( cache_least_recently_used() );
 		}
-		current = mktime(&tm_local);
-		if (current > end) break;
-		if ( !( *num_entries%BUFFER_INCREMENT) )
+	}
+	pthread_rwlock_unlock( &cache_lock );
+	if (evicted != NULL) cached_zone_free( evicted );
+	*zone = &entry->zone;
+	return ZD_SUCCESS;
+}
+
+/****************************************************
+* zdump_cache_release
+***************************************************/
+void zdump_cache_release( const zdump_zone* zone )
+{
+	cached_zone* entry = (cached_zone*) zone;
+
+	if (cache_unref( entry )) cached_zone_free( entry );
+}
+
+/****************************************************
+* zdump_cache_invalidate
+***************************************************/
+void zdump_cache_invalidate( const char* tzname )
+{
+	const char* name;
+	cached_zone* entry;
+	cached_zone* unused = NULL;
+	cached_zone* removed;
+	int i;
+
+	pthread_rwlock_wrlock( &cache_lock );
+	if (tzname != NULL)
+	{
+		name = cache_key( tzname );
+		entry = cache_find( name, cache_hash( name ) );
+		if (entry != NULL) unused = cache_remove( entry );
+		pthread_rwlock_unlock( &cache_lock );
+		if (unused != NULL) cached_zone_free( unused );
+		return;
+	}
+	/// the unused entries are chained through next_in_bucket, which
+	/// removal has finished with, and freed after the lock is released
+	for (i = 0; i < ZD_CACHE_BUCKETS; i++)
+		while (cache_buckets[i] != NULL)
 		{
-			*return_data = perform_a_realloc(*return_data, ret_buff_size);
-			if (*return_data == NULL) return ZD_FAILURE;
+			removed = cache_remove( cache_buckets[i] );
+			if (removed != NULL)
+			{
+				removed->next_in_bucket = unused;
+				unused = removed;
+			}
 		}
-///		The following only works when _BSD_SOURCE is set, because
-///		tm_gmtoff and *tm_zone are part of the glibc version of struct tm,
-///		currently only implemented as a BSD extension.
-///		add_a_rule_entry( current, *return_data, num_entries, tm_local.tm_gmtoff,
-///							p_rule.save_secs[i], tm_local.tm_zone );
-// FIXME - replace 0 and NULL with real values!
-		add_a_rule_entry( current, *return_data, num_entries, 0,
-							p_rule.save_secs[i], NULL );
-		// this next is only for the first pass
-		if (!p_rule.has_dst) return ZD_SUCCESS;
-		memcpy( (char*) &tm_prior, (char*) &tm_local, sizeof(struct tm));
-		i = i > 0 ? 0 : 1;
+	pthread_rwlock_unlock( &cache_lock );
+	while (unused != NULL)
+	{
+		removed = unused;
+		unused = unused->next_in_bucket;
+		cached_zone_free( removed );
 	}
-	return ZD_SUCCESS;
 }
 
+/****************************************************
+* zdump_cache_configure
+***************************************************/
+void zdump_cache_configure( const int capacity, const int first_year, const int last_year )
+{
+	pthread_rwlock_wrlock( &cache_lock );
+	cache_capacity = capacity > 0 ? capacity : 0;
+	cache_first_year = first_year;
+	cache_last_year = last_year >= first_year ? last_year : first_year;
+	pthread_rwlock_unlock( &cache_lock );
+	zdump_cache_invalidate( NULL );
+}
+
+/****************************************************
+* window_dump
+*   as zdump_zone_dump, from a cached zone's window
+***************************************************/
+static int window_dump( const cached_zone* entry, const time_t start, const time_t end,
+                        int* num_entries, void** return_data )
+{
+	zdumpinfo* zd;
+	int first, last;
+
+	first = zdump_entry_at( entry->window, entry->window_entries, start );
+	last = zdump_entry_at( entry->window, entry->window_entries, end );
+	zd = malloc( (1 + last - first) * sizeof(zdumpinfo) );
+	if (zd == NULL) return ZD_MALLOC;
+	add_a_start_entry( &entry->zone, start, zd, num_entries );
+	memcpy( zd + 1, entry->window + first + 1, (last - first) * sizeof(zdumpinfo) );
+	*num_entries = 1 + last - first;
+	*return_data = zd;
+	return ZD_SUCCESS;
+}
 
 int zdump(               /// returns 0 on ZD_SUCCESS, -1 on ZD_FAILURE
     const char* tzname,  /// fully-qualified time-zone name (eg. Asia/Baku)
@@ -470,95 +1068,20 @@ int zdump(               /// returns 0 on ZD_SUCCESS, -1 on ZD_FAILURE
                          ///    Returns NULL on ZD_FAILURE.
           )
 {
-// TODO - report errors and set errno
-	char* startdir = NULL;	/// current working directory on entry to this function
-	char* tzdir     = NULL;	/// system base timezone directory
-	char* tzdirlist[2] = { "/usr/share/zoneinfo/",	/// libc >= 5.4.6
-						   "/usr/lib/zoneinfo/" };	/// libc <  5.4.6
-	char* localtime_name = "localtime";
-	struct stat file_status;
-	char* tzif = NULL;		/// tz file copied into memory here
-	timezonefileheader tzh;
-	char* start_ptr;		/// point in *tzif where we start to parse
-	unsigned int field_size;/// different for tzif and tzif2
-	FILE *tz_file;
+	const zdump_zone* zone;
+	const cached_zone* entry;
 	int result;
-	unsigned int i;
-	signed long temp_long;
-	size_t ret_buff_size = 0;
-	char *transition_time_ptr;
 
 	*num_entries = 0;
+	*return_data = NULL;
 	if (end < start) return ZD_BAD_VALUES;
-	startdir = getcwd( NULL, 0 );
-	tzdir = getenv("TZDIR");
-	result = ZD_DIR_PATH;
-	if (tzdir != NULL) result = chdir(tzdir);
-	if (result)        result = chdir(tzdirlist[0]);
-	if (result)        result = chdir(tzdirlist[1]);
-	if (result)        return ZD_DIR_PATH;
-	result = ZD_SUCCESS;
-	if (tzname == NULL) tzname = localtime_name;
-	tz_file = fopen(tzname, "rb");
-	if (tz_file == NULL) {result= ZD_FOPEN; goto endpoint;};
-	if (fstat( fileno(tz_file), &file_status) != 0) {result= ZD_FREAD; goto endpoint;};
-	tzif = malloc( file_status.st_size );
-	if (tzif == NULL)  {result= ZD_MALLOC; goto endpoint;};
-	if (fread( tzif, file_status.st_size, 1, tz_file) != 1 )  {result= ZD_FREAD; goto endpoint;};
-	fclose(tz_file);
-	if (!read_tz_header( &tzh, tzif)) {result= ZD_TZIF_HEADER; goto endpoint;};
-	if (tzh.magicnumber[4] == 50 )
-	{
-		start_ptr = memmem( &tzif[HEADER_LEN], file_status.st_size - HEADER_LEN, "TZif2", 5 );
-		if (start_ptr == NULL) {result= ZD_TZIF_HEADER; goto endpoint;};
-		if (read_tz_header( &tzh, start_ptr ) == ZD_FAILURE ) {result= ZD_TZIF_HEADER; goto endpoint;};
-		start_ptr = start_ptr + HEADER_LEN;
-		field_size = TZIF2_FIELD_SIZE;
-	}
-	else
-	{
-		start_ptr = &tzif[HEADER_LEN];
-		field_size = TZIF1_FIELD_SIZE;
-	}
-
-	transition_time_ptr = start_ptr;
-	local_time_type_ptr = start_ptr + tzh.timecnt*field_size;
-	ttinfo_ptr = local_time_type_ptr + tzh.timecnt;
-	tz_abbrev_ptr = ttinfo_ptr + (tzh.typecnt * 6);
-	// TODO - replace this incremental search with something more efficient
-	for (i=0; i<tzh.timecnt; i++)
-	{
-		temp_long = flip_tz_long( transition_time_ptr, field_size );
-		if (temp_long >= start)
-		{
-			*return_data = perform_a_realloc(*return_data, &ret_buff_size);
-			if (*return_data == NULL) {result= ZD_MALLOC; goto endpoint;};
-			add_a_tzif_entry( i>0 ? i-1: 0, (time_t) start, *return_data, num_entries );
-			break;
-		}
-		transition_time_ptr = transition_time_ptr + field_size;
-	}
-	while (i < tzh.timecnt)
-	{
-		temp_long = flip_tz_long( transition_time_ptr, field_size );
-		if (temp_long > end) break;
-		if ( !( *num_entries%BUFFER_INCREMENT) ) *return_data = perform_a_realloc(*return_data, &ret_buff_size);
-		add_a_tzif_entry( i, (time_t) temp_long, *return_data, num_entries );
-		transition_time_ptr = transition_time_ptr + field_size;
-		i++;
-	}
-	if ((i == tzh.timecnt) && (temp_long < end))
-		result = rule_dump(tzif, file_status.st_size-2, start, end, (time_t) temp_long,
-						num_entries, return_data, &ret_buff_size);
-
-/// cleanup and exit
-endpoint:
-	if (tzif != NULL) free(tzif);
-	chdir(startdir);
-	if (!(*num_entries))
-	{
-		if (*return_data != NULL) free(*return_data);
-		result = ZD_FAILURE;
-	}
+	result = zdump_cache_get( tzname, &zone );
+	if (result != ZD_SUCCESS) return result;
+	entry = (const cached_zone*) zone;
+	if ( (entry->window != NULL)
+		&& (start >= entry->window_start) && (end <= entry->window_end) )
+		result = window_dump( entry, start, end, num_entries, return_data );
+	else result = zdump_zone_dump( zone, start, end, num_entries, return_data );
+	zdump_cache_release( zone );
 	return result;
 }
@@ -3,6 +3,13 @@
  * The file is expected to have been compiled using the glibc 'zic'
  * command.
  *
+ * This header is internal to libhdate and is not installed; it is for
+ * the programs built in this tree (hcal, hdate) and for its tests. Only
+ * zdump() and zdumpinfo are meant to be used outside libhdate itself;
+ * the zdump_zone_*, zdump_rule_*, zdump_entry_at and zdump_cache_*
+ * functions, and the layout of the structures they use, may change
+ * from one release to the next.
+ *
  * Copyright:  2012-2013 (c) Boruch Baum <zdump@gmx.com>
  *
  *  This program is free software: you can redistribute it and/or modify
@@ -18,7 +25,14 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
- 
+
+#ifndef __ZDUMP3_H__
+#define __ZDUMP3_H__
+
+#include <stddef.h>		/// for size_t
+#include <time.h>		/// for time_t
+#include <limits.h>		/// for CHAR_BIT
+
 /// zdumpinfo - an element of the array to return
 #define MAX_TZ_ABBR_SIZE   10  /// safe
 typedef struct {
@@ -56,3 +70,163 @@ zdump(                   /// returns 0 on success, -1 on failure
 #define ZD_FREAD       5004 /** unable to read file */
 #define ZD_MALLOC      5005 /** memory allocation error */
 #define ZD_TZIF_HEADER 5006 /** unable to parse tzif header */
+
+
+/// zdump_offset - the local time in effect at an instant, see
+/// zdump_zone_offset_at, zdump_rule_offset_at
+#define ZD_TIME_MIN (-ZD_TIME_MAX - 1)   /// no earlier transition
+#define ZD_TIME_MAX ((time_t) (((((time_t) 1 << (sizeof(time_t) * CHAR_BIT - 2)) - 1) << 1) + 1))
+                                         /// no later transition; the largest
+                                         ///    time_t of any width, built
+                                         ///    up without overflowing
+typedef struct {
+	time_t start;		/// the transition that began it, or ZD_TIME_MIN
+	time_t until;		/// the next transition, or ZD_TIME_MAX
+	int utc_offset;		/// in seconds
+	int is_dst;
+	const char* abbr;	/// points into the zone (or rule) it came from
+	} zdump_offset;
+
+/// zdump_rule - a POSIX TZ string, such as a TZif footer, decoded for
+/// evaluation by arithmetic alone, see zdump_rule_decode
+#define ZD_STD 0
+#define ZD_DST 1
+typedef struct {
+	char abbr[2][MAX_TZ_ABBR_SIZE];	/// indexed by ZD_STD and ZD_DST
+	int offset[2];		/// seconds east of UTC
+	int has_dst;
+	char type[2];		/// the day each period begins: 'M' m.w.d,
+						///    'J' 1-365 never counting February 29th,
+						///    or 'n' 0-365
+	int m[2];			/// 'M' month, 1-12
+	int w[2];			/// 'M' week, 1-5; 5 is the last in the month
+	int d[2];			/// 'M' week day, 0 (Sunday) - 6
+	int j[2];			/// 'J' or 'n' day
+	int time[2];		/// seconds after local midnight that it begins;
+						///    may be negative or past 24 hours
+	} zdump_rule;
+
+/// zdump_zone - an open TZif file, see zdump_zone_open. Once open,
+/// a zone is only read, so any number of threads may share it. Internal,
+/// like the rest of this header but zdump().
+#define ZD_RULE_SIZE 64  /// the POSIX TZ footer, with its newline
+typedef struct {
+	const char* map;		/// the file, mmap()ed read-only
+	size_t map_size;
+	unsigned int field_size;/// 4 for TZif, 8 for the TZif2 data
+	unsigned long timecnt;	/// number of transition times
+	unsigned long typecnt;	/// number of local time types
+	unsigned long charcnt;	/// size of the abbreviation strings
+	const char* transition_times;
+	const unsigned char* local_time_types;
+	const char* ttinfo;
+	const char* abbrevs;
+	size_t rule_len;		/// 0 if the file has no footer
+	char rule[ZD_RULE_SIZE];
+	int has_rule;			/// whether the footer decoded
+	zdump_rule tz_rule;		/// the footer, decoded
+	} zdump_zone;
+
+extern int
+zdump_zone_open(         /// returns 0 on success, a ZD_* value on failure
+    zdump_zone* zone,    /// the zone to open, close with zdump_zone_close
+    const char* tzname   /// time-zone name (eg. Asia/Baku) under $TZDIR or
+                         ///    the system zoneinfo directory, or an
+                         ///    absolute path; if NULL, "localtime"
+          );
+
+extern int
+zdump_zone_open_at(      /// returns 0 on success, a ZD_* value on failure
+    zdump_zone* zone,    /// the zone to open, close with zdump_zone_close
+    int dir_fd,          /// directory to look for a relative path in
+    const char* path     /// the TZif file
+          );
+
+extern void
+zdump_zone_close( zdump_zone* zone );
+
+extern int
+zdump_zone_offset_at(    /// returns 0 on success, a ZD_* value on failure
+    const zdump_zone* zone,
+    const time_t t,      /// seconds from epoch
+    zdump_offset* offset /// the zone's local time at t; a binary search of
+                         ///    the transitions, so O(log n). After the
+                         ///    last transition in the file, the footer
+                         ///    rule's, else the last local time type
+          );
+
+extern int
+zdump_zone_dump(         /// as zdump, for an open zone
+    const zdump_zone* zone,
+    const time_t start,
+    const time_t end,
+    int* num_entries,
+    void** return_data
+          );
+
+extern int
+zdump_rule_decode(       /// returns 0 on success, -1 on failure
+    zdump_rule* rule,
+    const char* tz_string /// a POSIX TZ value, eg. "IST-2IDT,M3.4.4/26,M10.5.0";
+                         ///    a trailing newline is allowed
+          );
+
+extern time_t
+zdump_rule_transition(   /// returns seconds from epoch
+    const zdump_rule* rule, /// a rule with DST
+    const int dst,       /// ZD_DST for the start of DST that year,
+                         ///    ZD_STD for its end
+    const long year      /// gregorian
+          );
+
+extern int
+zdump_rule_offset_at(    /// returns 0 on success, -1 on failure
+    const zdump_rule* rule,
+    const time_t t,      /// seconds from epoch
+    zdump_offset* offset /// the rule's local time at t; abbr points into
+                         ///    the rule
+          );
+
+extern int
+zdump_entry_at(          /// returns the index of the entry in effect at t
+    const zdumpinfo* data,  /// as returned by zdump or zdump_zone_dump
+    const int num_entries,
+    const time_t t       /// seconds from epoch; times before the first
+                         ///    entry answer 0
+          );
+
+/// zdump_cache - zones kept open, with their transitions expanded over
+/// a window of years, for callers who ask about the same zones again and
+/// again; zdump() itself uses it. Least recently used zones are closed
+/// first. Any number of threads may use the cache, and the zones it
+/// hands out, at once. Internal to libhdate, see above.
+#define ZD_CACHE_CAPACITY   512   /// zones kept, by default; about the
+                                  ///    whole tz database
+#define ZD_CACHE_FIRST_YEAR 1970  /// the default window, in UTC years
+#define ZD_CACHE_LAST_YEAR  2100
+
+extern int
+zdump_cache_get(         /// returns 0 on success, a ZD_* value on failure
+    const char* tzname,  /// as for zdump_zone_open; ":name", as in a TZ
+                         ///    value, is the same zone as "name"
+    const zdump_zone** zone /// the open zone, shared; never close it,
+                         ///    but zdump_cache_release it when done
+          );
+
+extern void
+zdump_cache_release( const zdump_zone* zone );
+
+extern void
+zdump_cache_invalidate(  /// drop a zone, eg. after a tzdata update; its
+                         ///    current users may go on using it
+    const char* tzname   /// the zone, or NULL for all
+          );
+
+extern void
+zdump_cache_configure(   /// drops all cached zones
+    const int capacity,  /// zones to keep; 0 turns the cache off
+    const int first_year,/// the window zdump() answers from the cached
+    const int last_year  ///    transitions, both years included
+          );
+
+#endif
@@ -0,0 +1,125 @@
+/* test_advance.c
+ * check hdate_advance against hdate_set_jd, and time a walk of 1000
+ * years day by day with each.
+ */
+
+/*
+ *  Copyright (C) 2026  libhdate contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * One date is stepped over the whole julian day range a day at a time,
+ * forward and then back, and then by random steps of up to 400 days
+ * and now and then 50000; after every step it must equal, field by
+ * field, what hdate_set_jd gives for the same day. The 1000 years from
+ * 1 January 1900 are then walked once with hdate_set_jd and once with
+ * hdate_advance, and both times are printed.
+ */
+
+#include <stdio.h>		/* for printf */
+#include <stdlib.h>		/* for rand */
+#include <string.h>		/* for memcmp */
+#include <time.h>
+#include <hdate.h>
+
+#define RANDOM_STEPS 1000000
+
+static int
+check_day (hdate_struct const *h, int jd, const char *walk)
+{
+	hdate_struct expected;
+
+	hdate_set_jd (&expected, jd);
+	if (memcmp (h, &expected, sizeof (expected)) == 0)
+		return 0;
+
+	printf ("%s, jd %d: %d %d %d / %d %d %d, expected %d %d %d / %d %d %d\n", walk, jd,
+			h->hd_day, h->hd_mon, h->hd_year, h->gd_day, h->gd_mon, h->gd_year,
+			expected.hd_day, expected.hd_mon, expected.hd_year,
+			expected.gd_day, expected.gd_mon, expected.gd_year);
+	return 1;
+}
+
+static double
+seconds (void)
+{
+	struct timespec t;
+
+	clock_gettime (CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+int
+main ()
+{
+	hdate_struct h;
+	int first = HDATE_JUL_DY_LOWER_BOUND;
+	int last = HDATE_JUL_DY_UPPER_BOUND;
+	int jd, n, k;
+	int errors = 0;
+	int start, end;
+	volatile int sink = 0;
+	double t_set_jd, t_advance;
+
+	hdate_set_jd (&h, first);
+	for (jd = first + 1; jd <= last && errors < 10; jd++)
+		errors += check_day (hdate_advance (&h, 1), jd, "forward");
+	for (jd = last - 1; jd >= first && errors < 10; jd--)
+		errors += check_day (hdate_advance (&h, -1), jd, "back");
+
+	srand (1);
+	jd = first;
+	hdate_set_jd (&h, jd);
+	for (k = 0; k < RANDOM_STEPS && errors < 10; k++)
+	{
+		n = (k % 50 == 0) ? rand () % 100001 - 50000 : rand () % 801 - 400;
+		if (jd + n < first || jd + n > last)
+			continue;
+		jd += n;
+		errors += check_day (hdate_advance (&h, n), jd, "random");
+	}
+
+	printf ("%d days each way and %d random steps: %d mismatches\n",
+			last - first, RANDOM_STEPS, errors);
+
+	start = hdate_gdate_to_jd (1, 1, 1900);
+	end = hdate_gdate_to_jd (1, 1, 2900);
+
+	t_set_jd = seconds ();
+	for (jd = start; jd < end; jd++)
+	{
+		hdate_set_jd (&h, jd);
+		sink += h.hd_day;
+	}
+	t_set_jd = seconds () - t_set_jd;
+
+	t_advance = seconds ();
+	hdate_set_jd (&h, start);
+	sink += h.hd_day;
+	for (jd = start + 1; jd < end; jd++)
+	{
+		hdate_advance (&h, 1);
+		sink += h.hd_day;
+	}
+	t_advance = seconds () - t_advance;
+
+	printf ("1000 years, %d days: hdate_set_jd %.1f ms (%.1f ns/day), "
+			"hdate_advance %.1f ms (%.1f ns/day)\n", end - start,
+			t_set_jd * 1e3, t_set_jd * 1e9 / (end - start),
+			t_advance * 1e3, t_advance * 1e9 / (end - start));
+
+	return errors ? 1 : 0;
+}
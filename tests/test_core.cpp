@@ -0,0 +1,253 @@
+/* test_core.cpp
+ * check the constexpr calendar core of hdatepp_core.h against the C
+ * library.
+ */
+
+/*
+ *  Copyright (C) 2026  libhdate contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * A few known dates are worked out by the compiler and checked with
+ * static_assert, so this file does not build unless the core folds at
+ * compile time. Then every julian day from HDATE_JUL_DY_LOWER_BOUND to
+ * HDATE_JUL_DY_UPPER_BOUND is converted by core::jd_to_hdate_struct
+ * and by hdate_set_jd, and the two must agree field by field.
+ *
+ * A DayRange over the same days is walked forward and then in reverse,
+ * and each date it yields must again match hdate_set_jd.
+ *
+ * Each of those days also goes through the std::chrono API:
+ * jd_to_sys_days and sys_days_to_jd must undo each other, and an Hdate
+ * made from the sys_days, or from its year_month_day, must be the date
+ * hdate_set_jd gives. Last, at Longyearbyen in the polar night the sun
+ * times must be sys_seconds::min (), while in Tel Aviv they are not.
+ */
+
+#include <cstdio>		/* for printf */
+#include <cstring>		/* for memcmp */
+#include <chrono>
+#include <iterator>
+#include <ranges>
+#include <hdatepp.h>
+
+namespace core = hdate::core;
+
+/* 1 Tishrey 5785 was Thursday 3 October 2024 */
+constexpr int rosh_hashana_5785 = core::hdate_to_jd (1, 1, 5785);
+constexpr core::gdate rosh_hashana_5785_g = core::jd_to_gdate (rosh_hashana_5785);
+static_assert (rosh_hashana_5785 == 2460587, "1 Tishrey 5785 julian day");
+static_assert (rosh_hashana_5785_g.day == 3 && rosh_hashana_5785_g.month == 10 &&
+			   rosh_hashana_5785_g.year == 2024, "1 Tishrey 5785 is 3 October 2024");
+
+/* 1 January 2024 was Monday 20 Tevet 5784, in a short leap year */
+constexpr hdate_struct new_year_2024 = core::jd_to_hdate_struct (core::gdate_to_jd (1, 1, 2024));
+static_assert (new_year_2024.hd_day == 20 && new_year_2024.hd_mon == 4 &&
+			   new_year_2024.hd_year == 5784, "1 January 2024 is 20 Tevet 5784");
+static_assert (new_year_2024.hd_dw == 2, "1 January 2024 is a Monday");
+static_assert (new_year_2024.hd_size_of_year == 383, "5784 has 383 days");
+
+/* the first day of the Gregorian calendar */
+static_assert (core::gdate_to_jd (15, 10, 1582) == 2299161, "15 October 1582");
+
+/* the ends of the supported range */
+static_assert (core::jd_to_hdate_struct (HDATE_JUL_DY_LOWER_BOUND).hd_jd ==
+			   HDATE_JUL_DY_LOWER_BOUND, "first julian day");
+static_assert (core::jd_to_hdate_struct (HDATE_JUL_DY_UPPER_BOUND).hd_jd ==
+			   HDATE_JUL_DY_UPPER_BOUND, "last julian day");
+
+static_assert (std::random_access_iterator<hdate::DayRange::iterator>,
+			   "DayRange::iterator is a random access iterator");
+static_assert (std::ranges::random_access_range<hdate::DayRange>,
+			   "DayRange is a random access range");
+
+static_assert (hdate::sys_days_to_jd (std::chrono::sys_days (std::chrono::year (1970) /
+															 1 / 1)) == 2440588,
+			   "1 January 1970 julian day");
+static_assert (hdate::jd_to_sys_days (2299161) ==
+			   std::chrono::sys_days (std::chrono::year (1582) / 10 / 15),
+			   "15 October 1582");
+static_assert (hdate::Hdate (std::chrono::year_month_day (std::chrono::year (2024) / 1 / 1))
+			   .get_sys_days () == std::chrono::sys_days (std::chrono::year (2024) / 1 / 1),
+			   "1 January 2024 round trip");
+
+static int
+check_core ()
+{
+	int errors = 0;
+
+	for (int jd = HDATE_JUL_DY_LOWER_BOUND; jd <= HDATE_JUL_DY_UPPER_BOUND; jd++)
+	{
+		hdate_struct expected;
+		hdate_struct h = core::jd_to_hdate_struct (jd);
+
+		hdate_set_jd (&expected, jd);
+		if (std::memcmp (&h, &expected, sizeof (h)) != 0)
+		{
+			if (errors++ < 10)
+				std::printf ("core, jd %d: %d %d %d / %d %d %d, expected %d %d %d / %d %d %d\n",
+							 jd, h.hd_day, h.hd_mon, h.hd_year, h.gd_day, h.gd_mon, h.gd_year,
+							 expected.hd_day, expected.hd_mon, expected.hd_year,
+							 expected.gd_day, expected.gd_mon, expected.gd_year);
+		}
+	}
+
+	std::printf ("core::jd_to_hdate_struct, julian days %d - %d: %d mismatches\n",
+				 HDATE_JUL_DY_LOWER_BOUND, HDATE_JUL_DY_UPPER_BOUND, errors);
+
+	return errors;
+}
+
+/**
+ @brief compare the fields of a date with those hdate_set_jd gives; the
+ first 10 differences are printed
+*/
+static int
+check_date (const hdate::Hdate &d, int jd, const char *walk, int errors)
+{
+	hdate_struct expected;
+
+	hdate_set_jd (&expected, jd);
+	if (d.get_julian () == jd &&
+		d.get_hday () == expected.hd_day && d.get_hmonth () == expected.hd_mon &&
+		d.get_hyear () == expected.hd_year && d.get_gday () == expected.gd_day &&
+		d.get_gmonth () == expected.gd_mon && d.get_gyear () == expected.gd_year &&
+		d.get_day_of_the_week () == expected.hd_dw &&
+		d.get_size_of_year () == expected.hd_size_of_year &&
+		d.get_new_year_day_of_the_week () == expected.hd_new_year_dw &&
+		d.get_days () == expected.hd_days && d.get_weeks () == expected.hd_weeks)
+		return 0;
+
+	if (errors < 10)
+		std::printf ("%s, jd %d: %d %d %d / %d %d %d, expected %d %d %d / %d %d %d\n",
+					 walk, jd, d.get_hday (), d.get_hmonth (), d.get_hyear (),
+					 d.get_gday (), d.get_gmonth (), d.get_gyear (),
+					 expected.hd_day, expected.hd_mon, expected.hd_year,
+					 expected.gd_day, expected.gd_mon, expected.gd_year);
+	return 1;
+}
+
+static int
+check_day_range ()
+{
+	hdate::DayRange all (HDATE_JUL_DY_LOWER_BOUND, HDATE_JUL_DY_UPPER_BOUND + 1);
+	int errors = 0;
+	int jd;
+
+	jd = HDATE_JUL_DY_LOWER_BOUND;
+	for (hdate::Hdate d : all)
+	{
+		errors += check_date (d, jd, "forward", errors);
+		jd++;
+	}
+	if (jd != HDATE_JUL_DY_UPPER_BOUND + 1 || all.end () - all.begin () != all.size ())
+	{
+		std::printf ("forward: walk ended at jd %d\n", jd);
+		errors++;
+	}
+
+	jd = HDATE_JUL_DY_UPPER_BOUND;
+	for (auto it = all.rbegin (); it != all.rend (); ++it)
+	{
+		errors += check_date (*it, jd, "reverse", errors);
+		jd--;
+	}
+	if (jd != HDATE_JUL_DY_LOWER_BOUND - 1)
+	{
+		std::printf ("reverse: walk ended at jd %d\n", jd);
+		errors++;
+	}
+
+	std::printf ("DayRange, %d days forward and back: %d mismatches\n", all.size (), errors);
+
+	return errors;
+}
+
+static int
+check_sys_days ()
+{
+	using namespace std::chrono;
+	int errors = 0;
+
+	for (int jd = HDATE_JUL_DY_LOWER_BOUND; jd <= HDATE_JUL_DY_UPPER_BOUND; jd++)
+	{
+		sys_days d = hdate::jd_to_sys_days (jd);
+		year_month_day ymd (d);
+		hdate::Hdate from_days (d);
+		hdate::Hdate from_ymd (ymd);
+
+		if (hdate::sys_days_to_jd (d) != jd)
+		{
+			if (errors++ < 10)
+				std::printf ("sys_days, jd %d: back to jd %d\n", jd, hdate::sys_days_to_jd (d));
+		}
+		errors += check_date (from_days, jd, "Hdate (sys_days)", errors);
+		errors += check_date (from_ymd, jd, "Hdate (year_month_day)", errors);
+		if (from_days.get_sys_days () != d || from_days.get_year_month_day () != ymd)
+		{
+			if (errors++ < 10)
+				std::printf ("sys_days, jd %d: get_sys_days or get_year_month_day differ\n", jd);
+		}
+	}
+
+	std::printf ("std::chrono dates, julian days %d - %d: %d mismatches\n",
+				 HDATE_JUL_DY_LOWER_BOUND, HDATE_JUL_DY_UPPER_BOUND, errors);
+
+	return errors;
+}
+
+static int
+check_polar_night ()
+{
+	using namespace std::chrono;
+	hdate::Hdate d (sys_days (year (2024) / December / 21));
+	int errors = 0;
+
+	/* Longyearbyen, 78.2 N 15.6 E */
+	d.set_location (78.2, -15.6, 1);
+
+	if (d.get_sunrise_time () != sys_seconds::min ())
+		errors++;
+	if (d.get_sunset_time () != sys_seconds::min ())
+		errors++;
+	if (d.get_midday_time () != sys_seconds::min ())
+		errors++;
+	if (d.get_sun_hour_duration () != seconds (0))
+		errors++;
+
+	/* and the same day in Tel Aviv has a sunrise and a sunset */
+	d.set_location (32.1, -34.8, 2);
+	if (d.get_sunrise_time () == sys_seconds::min () ||
+		d.get_sunset_time () <= d.get_sunrise_time ())
+		errors++;
+
+	std::printf ("polar night: %d mismatches\n", errors);
+
+	return errors;
+}
+
+int
+main ()
+{
+	int errors = 0;
+
+	errors += check_core ();
+	errors += check_day_range ();
+	errors += check_sys_days ();
+	errors += check_polar_night ();
+
+	return errors ? 1 : 0;
+}
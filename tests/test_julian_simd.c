@@ -0,0 +1,131 @@
+/* test_julian_simd.c
+ * check hdate_jd_to_gdate_array and hdate_gdate_to_jd_array against
+ * the scalar functions.
+ */
+
+/*
+ *  Copyright (C) 2026  libhdate contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Every julian day from HDATE_JUL_DY_LOWER_BOUND to
+ * HDATE_JUL_DY_UPPER_BOUND is converted by the array functions and
+ * compared with hdate_jd_to_gdate / hdate_gdate_to_jd. The array
+ * functions pick their path by the length of what is left: a call of
+ * 8 dates goes through the AVX2 kernel (when the cpu has it), a call
+ * of 4 through the SSE2 kernel and a call of 3 through the scalar
+ * code, so the range is walked once in each chunk size.
+ */
+
+#include <stdio.h>		/* for printf */
+#include <hdate.h>
+
+static int
+check_chunk (int const *jd, int *day, int *month, int *year, int *jd_out, int count)
+{
+	int i;
+	int d, m, y;
+	int errors = 0;
+
+	hdate_jd_to_gdate_array (jd, day, month, year, count);
+	hdate_gdate_to_jd_array (day, month, year, jd_out, count);
+
+	for (i = 0; i < count; i++)
+	{
+		hdate_jd_to_gdate (jd[i], &d, &m, &y);
+		if (d != day[i] || m != month[i] || y != year[i])
+		{
+			if (errors++ < 10)
+				printf ("jd %d: array %d-%d-%d, scalar %d-%d-%d\n",
+						jd[i], year[i], month[i], day[i], y, m, d);
+		}
+		if (jd_out[i] != hdate_gdate_to_jd (day[i], month[i], year[i]))
+		{
+			if (errors++ < 10)
+				printf ("%d-%d-%d: array jd %d, scalar jd %d\n", year[i], month[i],
+						day[i], jd_out[i], hdate_gdate_to_jd (day[i], month[i], year[i]));
+		}
+	}
+
+	return errors;
+}
+
+static int
+check_range (int chunk)
+{
+	int jd[8], day[8], month[8], year[8], jd_out[8];
+	int start, i, n;
+	int errors = 0;
+
+	for (start = HDATE_JUL_DY_LOWER_BOUND; start <= HDATE_JUL_DY_UPPER_BOUND;
+		 start += chunk)
+	{
+		n = HDATE_JUL_DY_UPPER_BOUND - start + 1;
+		if (n > chunk)
+			n = chunk;
+		for (i = 0; i < n; i++)
+			jd[i] = start + i;
+		errors += check_chunk (jd, day, month, year, jd_out, n);
+	}
+
+	return errors;
+}
+
+/**
+ @brief a chunk with one lane out of the kernels' range must come back
+ the same as the scalar functions give it
+*/
+static int
+check_out_of_range (int chunk)
+{
+	int jd[8], day[8], month[8], year[8], jd_out[8];
+	int i, lane;
+	int errors = 0;
+
+	for (lane = 0; lane < chunk; lane++)
+	{
+		for (i = 0; i < chunk; i++)
+			jd[i] = 2451545 + i;
+		jd[lane] = (lane & 1) ? -5 : 20000000;
+		errors += check_chunk (jd, day, month, year, jd_out, chunk);
+	}
+
+	return errors;
+}
+
+int
+main ()
+{
+	static const int chunks[] = { 8, 4, 3 };
+	unsigned int c;
+	int errors = 0;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	printf ("avx2: %s, sse2: %s\n",
+			__builtin_cpu_supports ("avx2") ? "yes" : "no",
+			__builtin_cpu_supports ("sse2") ? "yes" : "no");
+#endif
+
+	for (c = 0; c < sizeof (chunks) / sizeof (chunks[0]); c++)
+	{
+		int e = check_range (chunks[c]) + check_out_of_range (chunks[c]);
+
+		printf ("chunks of %d: %d mismatches\n", chunks[c], e);
+		errors += e;
+	}
+
+	return errors ? 1 : 0;
+}
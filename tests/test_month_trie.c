@@ -0,0 +1,308 @@
+/* test_month_trie.c
+ * check the month name trie of hdate_parse_month_text_ctx against the
+ * fnmatch scan it replaced, and time both.
+ */
+
+/*
+ *  Copyright (C) 2026  libhdate contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * old_parse_month_text below is parse_month_text of hdate_strings.c as
+ * it was before the trie, with its tables. Every spelling in seeds[] is
+ * fed to both, as is, in upper, lower and swapped case, and with each
+ * prefix, each one byte deletion, each swap of neighbouring bytes and
+ * each insertion of a few likely bytes, so most inputs sit just inside
+ * or just outside some pattern.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>		/* for printf */
+#include <stdlib.h>		/* for malloc */
+#include <string.h>		/* for strcpy */
+#include <strings.h>	/* for strcasecmp */
+#include <ctype.h>		/* for toupper */
+#include <fnmatch.h>
+#include <time.h>
+#include <hdate.h>
+
+#define MAX_NAME 128
+
+/* the tables of the old scan */
+static const char *old_hebrew_months[2][14] = {
+	{"Tishrei", "Cheshvan", "Kislev", "Tevet",
+	 "Shevat", "Adar", "Nisan", "Iyyar",
+	 "Sivan", "Tammuz", "Av", "Elul", "Adar_I",
+	 "Adar_II"},
+	{"תשרי", "חשון", "כסלו", "טבת", "שבט", "אדר", "ניסן", "אייר",
+	 "סיון", "תמוז", "אב", "אלול", "אדר א", "אדר ב"}
+};
+
+static const char *old_gregorian_months[2][12] = {
+	{"January", "February", "March",
+	 "April", "May", "June",
+	 "July", "August", "September",
+	 "October", "November", "December"},
+	{"Jan", "Feb", "Mar", "Apr", "May",
+	 "Jun", "Jul", "Aug", "Sep", "Oct",
+	 "Nov", "Dec"}
+};
+
+static const char *old_alt_latin_spell_hebrew_months[14] = {
+	"@(?(@(Y|J)ere@(ch|kh|h|x|j)?( |_|-)Ha?(-))@(A|Ai|Ay|Ei)t?(h)a?(h)n@(i|ee)m|Ti[cs]hr@([ie]?(y)|a[iy]))",
+	"@(b@(oo|ou|u)?(l)l|?(Mar?( |-|_))@(?(C|K)h|X|J)e[sc]hva?(h)n)",
+	"Kisl@(e|[ae][iy])v",
+	"T@(e|[ae][iy])v@(e|[ae][iy])t",
+	"[SC]h?([e'])vat",
+	"Ad?(d)a?(h)r",
+	"N@(i|ee)s?(s)a?(h)n",
+	"@(ziv|zeev|@(I|e|Ee)?(y|yy|j)?(')a?(h)r)",
+	"[SC]@(i|ee)v?(v)a?(h)n",
+	"Tam?(m)uz",
+	"?(Mena@(ch|kh|x|j)@(e|ei|ey|ai|ay|i)m?( |_|-))A?(h)v",
+	"El?(l)@(u|ou|oo)l?(l)",
+	"Ad?(d)a?(h)r?( |-|_)@(A|1|I|alef|aleph)",
+	"Ad?(d)a?(h)r?( |-|_)@(B|2|II|bet?(h))"
+};
+
+static const char *old_alt_hebrew_spell_hebrew_months[14] = {
+	"?(ירח?( |-|־)ה)איתנים",
+	"@(?(מר?( |-|־))חשון|בול)",
+	"",
+	"",
+	"",
+	"",
+	"",
+	"זיו",
+	"",
+	"",
+	"?(מנחם?( |-|־))אב",
+	"",
+	"אדר?( |-|־)א?(')",
+	"אדר?( |-|־)ב?(')"
+};
+
+/**
+ @brief month number of a month name, the fnmatch scan
+*/
+static int
+old_parse_month_text (const char *month_text, const char (*locale_months)[HDATE_CONTEXT_NAME_SIZE])
+{
+	int i;
+
+	for (i = 0; i < 24; i++)
+		if (strcasecmp (month_text, locale_months[i]) == 0)
+			return (i % 12) + 1;
+
+	for (i = 0; i < 14; i++)
+		if ((strcasecmp (month_text, old_hebrew_months[0][i]) == 0) ||
+			(strcasecmp (month_text, old_hebrew_months[1][i]) == 0))
+			return (i % 14) + 101;
+
+	for (i = 0; i < 14; i++)
+		if (fnmatch (old_alt_latin_spell_hebrew_months[i], month_text, FNM_EXTMATCH | FNM_CASEFOLD) == 0)
+			return (i + 101);
+
+	for (i = 0; i < 14; i++)
+		if (fnmatch (old_alt_hebrew_spell_hebrew_months[i], month_text, FNM_EXTMATCH | FNM_CASEFOLD) == 0)
+			return (i + 101);
+
+	for (i = 0; i < 12; i++)
+		if ((strcasecmp (month_text, old_gregorian_months[0][i]) == 0) ||
+			(strcasecmp (month_text, old_gregorian_months[1][i]) == 0))
+			return (i % 12) + 1;
+
+	return 0;
+}
+
+/* at least one spelling down each branch of each pattern, and a few
+   that match nothing */
+static const char *seeds[] = {
+	"Tishrei", "Tishri", "Tishrey", "Tisrei", "Tichrai", "Tishray",
+	"Yerech HaEitanim", "Jerekh-Ha-Aitahnim", "Yerej_Aytanim",
+	"Yerex Ha-Eithaneem", "Yereh-Ha-Athanim", "Ethanim", "Eitanim",
+	"Aythahneem",
+	"Cheshvan", "Heshvan", "Kheshvan", "Xeshvan", "Jeshvan", "Checvan",
+	"Cheshvahn", "Marcheshvan", "Mar Cheshvan", "Mar-Heshvan",
+	"Mar_Kheshvan", "Bul", "Bull", "Bool", "Booll", "Boul",
+	"Kislev", "Kislaiv", "Kisleiv", "Kislayv", "Kisleyv",
+	"Tevet", "Teivet", "Taivayt", "Teyveyt",
+	"Shvat", "Chvat", "Sh'vat", "Shevat",
+	"Adar", "Addar", "Adahr", "Addahr",
+	"Nisan", "Neesan", "Nissan", "Nisahn",
+	"Iyar", "Iyyar", "Ijar", "Eyar", "Eeyar", "I'ar", "Iyahr", "Ziv", "Zeev",
+	"Sivan", "Seevan", "Civvan", "Sivahn",
+	"Tamuz", "Tammuz",
+	"Av", "Ahv", "Menachem Av", "Menakhem-Av", "Menaxaim_Ahv", "Menajeym Av",
+	"Elul", "Ellul", "Eloul", "Elooll",
+	"Adar I", "Adar-A", "Adar_1", "AdarAlef", "Adar aleph", "Addahr I",
+	"Adar_I", "Adar II", "Adar-B", "Adar_2", "Adar bet", "Adar beth",
+	"AdarII", "Adar_II",
+	"תשרי", "חשון", "כסלו", "טבת", "שבט", "אדר", "ניסן", "אייר",
+	"סיון", "תמוז", "אב", "אלול", "אדר א", "אדר ב",
+	"איתנים", "ירח האיתנים", "ירח-האיתנים", "ירח־האיתנים", "ירחהאיתנים",
+	"מרחשון", "מר חשון", "מר-חשון", "בול", "זיו", "מנחם אב", "מנחם-אב",
+	"אדרא", "אדר-א'", "אדר ב'", "אדר־ב",
+	"January", "February", "March", "April", "May", "June", "July",
+	"August", "September", "October", "November", "December",
+	"Jan", "Feb", "Mar", "Apr", "Jun", "Jul", "Aug", "Sep", "Sept",
+	"Oct", "Nov", "Dec",
+	"", "X", "12", "Adar III", "Tishreii", "Tishrei ", " Tishrei",
+	"Heshvan-", "Menachem  Av"
+};
+
+static const char inserts[] = "h -'ea";
+
+typedef struct
+{
+	char (*text)[MAX_NAME];
+	int count;
+	int size;
+} inputs_t;
+
+static void
+add_input (inputs_t * in, const char *text)
+{
+	if (strlen (text) >= MAX_NAME)
+		return;
+	if (in->count == in->size)
+	{
+		in->size = in->size ? 2 * in->size : 4096;
+		in->text = realloc (in->text, in->size * sizeof (in->text[0]));
+		if (!in->text)
+		{
+			printf ("out of memory\n");
+			exit (1);
+		}
+	}
+	strcpy (in->text[in->count++], text);
+}
+
+static void
+add_variants (inputs_t * in, const char *seed)
+{
+	char s[MAX_NAME];
+	size_t len = strlen (seed);
+	size_t i, j;
+
+	if (len + 2 > MAX_NAME)
+		return;
+
+	add_input (in, seed);
+
+	for (i = 0; i <= len; i++)
+		s[i] = toupper ((unsigned char) seed[i]);
+	add_input (in, s);
+	for (i = 0; i <= len; i++)
+		s[i] = tolower ((unsigned char) seed[i]);
+	add_input (in, s);
+	for (i = 0; i <= len; i++)
+		s[i] = isupper ((unsigned char) seed[i]) ?
+			tolower ((unsigned char) seed[i]) : toupper ((unsigned char) seed[i]);
+	add_input (in, s);
+
+	for (i = 1; i < len; i++)
+	{
+		/* prefix */
+		memcpy (s, seed, i);
+		s[i] = '\0';
+		add_input (in, s);
+
+		/* neighbours swapped */
+		strcpy (s, seed);
+		s[i - 1] = seed[i];
+		s[i] = seed[i - 1];
+		add_input (in, s);
+	}
+
+	for (i = 0; i < len; i++)
+	{
+		/* one byte deleted */
+		memcpy (s, seed, i);
+		strcpy (s + i, seed + i + 1);
+		add_input (in, s);
+	}
+
+	for (i = 0; i <= len; i++)
+		for (j = 0; j < sizeof (inserts) - 1; j++)
+		{
+			/* one byte inserted */
+			memcpy (s, seed, i);
+			s[i] = inserts[j];
+			strcpy (s + i + 1, seed + i);
+			add_input (in, s);
+		}
+}
+
+static double
+seconds (void)
+{
+	struct timespec t;
+
+	clock_gettime (CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+int
+main ()
+{
+	hdate_format_context ctx;
+	inputs_t in = { NULL, 0, 0 };
+	unsigned int i;
+	int k, errors = 0, found = 0;
+	long sum_old = 0, sum_new = 0;
+	double t_old, t_new;
+
+	hdate_format_context_init (&ctx, 0, HDATE_STRING_LONG);
+
+	for (i = 0; i < sizeof (seeds) / sizeof (seeds[0]); i++)
+		add_variants (&in, seeds[i]);
+
+	for (k = 0; k < in.count; k++)
+	{
+		int old_month = old_parse_month_text (in.text[k], ctx.locale_months);
+		int new_month = hdate_parse_month_text_ctx (&ctx, in.text[k]);
+
+		if (old_month)
+			found++;
+		if (old_month != new_month)
+		{
+			if (errors++ < 10)
+				printf ("\"%s\": fnmatch %d, trie %d\n", in.text[k], old_month, new_month);
+		}
+	}
+
+	t_old = seconds ();
+	for (k = 0; k < in.count; k++)
+		sum_old += old_parse_month_text (in.text[k], ctx.locale_months);
+	t_old = seconds () - t_old;
+
+	t_new = seconds ();
+	for (k = 0; k < in.count; k++)
+		sum_new += hdate_parse_month_text_ctx (&ctx, in.text[k]);
+	t_new = seconds () - t_new;
+
+	printf ("%d spellings, %d of them month names: %d mismatches\n",
+			in.count, found, errors + (sum_old != sum_new));
+	printf ("fnmatch scan %.0f/s, trie %.0f/s\n",
+			in.count / (t_old > 0 ? t_old : 1e-9), in.count / (t_new > 0 ? t_new : 1e-9));
+
+	free (in.text);
+
+	return errors || sum_old != sum_new ? 1 : 0;
+}
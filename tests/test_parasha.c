@@ -0,0 +1,126 @@
+/* test_parasha.c
+ * check hdate_get_parasha_for_week, hdate_find_parasha and the parasha
+ * iterator against hdate_get_parasha.
+ */
+
+/*
+ *  Copyright (C) 2026  libhdate contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * hdate_get_parasha is asked about every day from Hebrew year
+ * HDATE_HEB_YR_LOWER_BOUND to HDATE_HEB_YR_UPPER_BOUND, in Israel and
+ * in diaspora, and its answers are the reference. The years before
+ * 3744, which the reading tables do not cover, are included.
+ */
+
+#include <stdio.h>		/* for printf */
+#include <stdlib.h>		/* for malloc */
+#include <hdate.h>
+
+static int
+check (int diaspora)
+{
+	hdate_struct h;
+	hdate_parasha_iter it;
+	int first, last, n;
+	int *reference;
+	int jd, day, reading, year, parasha, k, count;
+	int jd_tishrey1, size_of_year;
+	int days[4];
+	int errors = 0;
+
+	hdate_get_year_info (HDATE_HEB_YR_LOWER_BOUND, &first, &size_of_year);
+	hdate_get_year_info (HDATE_HEB_YR_UPPER_BOUND, &jd_tishrey1, &size_of_year);
+	last = jd_tishrey1 + size_of_year - 1;
+	n = last - first + 1;
+
+	reference = malloc (n * sizeof (int));
+	if (!reference)
+		return 1;
+	for (jd = first; jd <= last; jd++)
+		reference[jd - first] = hdate_get_parasha (hdate_set_jd (&h, jd), diaspora);
+
+	/* the iterator gives exactly the days with a reading */
+	hdate_parasha_iter_init (&it, first, last, diaspora);
+	jd = first;
+	while (hdate_parasha_iter_next (&it, &day, &reading))
+	{
+		for (; jd < day; jd++)
+			if (reference[jd - first] && errors++ < 10)
+				printf ("iterator, jd %d: missed %d\n", jd, reference[jd - first]);
+		if (reference[day - first] != reading && errors++ < 10)
+			printf ("iterator, jd %d: %d, expected %d\n", day, reading, reference[day - first]);
+		jd = day + 1;
+	}
+	for (; jd <= last; jd++)
+		if (reference[jd - first] && errors++ < 10)
+			printf ("iterator, jd %d: missed %d\n", jd, reference[jd - first]);
+
+	/* every day of a week answers for the Shabbat ending it */
+	for (jd = first; jd <= last; jd++)
+	{
+		day = jd + 6 - (jd + 1) % 7;
+		if (day > last)
+			break;
+		reading = hdate_get_parasha_for_week (jd, diaspora);
+		if (reading != reference[day - first] && errors++ < 10)
+			printf ("for week, jd %d: %d, expected %d\n", jd, reading,
+					reference[day - first]);
+	}
+
+	/* each year's days for each parasha */
+	for (year = HDATE_HEB_YR_LOWER_BOUND; year <= HDATE_HEB_YR_UPPER_BOUND; year++)
+	{
+		hdate_get_year_info (year, &jd_tishrey1, &size_of_year);
+		for (parasha = 1; parasha <= 61; parasha++)
+		{
+			count = hdate_find_parasha (year, parasha, diaspora, days, 4);
+			k = 0;
+			for (jd = jd_tishrey1; jd < jd_tishrey1 + size_of_year; jd++)
+			{
+				if (reference[jd - first] != parasha)
+					continue;
+				if ((k >= count || (k < 4 && days[k] != jd)) && errors++ < 10)
+					printf ("find, year %d, parasha %d: jd %d not found\n", year, parasha, jd);
+				k++;
+			}
+			if (k != count && errors++ < 10)
+				printf ("find, year %d, parasha %d: %d days, expected %d\n",
+						year, parasha, count, k);
+		}
+	}
+
+	free (reference);
+
+	return errors;
+}
+
+int
+main ()
+{
+	int diaspora;
+	int e, errors = 0;
+
+	for (diaspora = 0; diaspora <= 1; diaspora++)
+	{
+		e = check (diaspora);
+		printf ("%s: %d mismatches\n", diaspora ? "diaspora" : "israel", e);
+		errors += e;
+	}
+
+	return errors ? 1 : 0;
+}
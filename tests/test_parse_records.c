@@ -0,0 +1,290 @@
+/* test_parse_records.c
+ * check hdate_parse_date_records on plain, CRLF, CSV and TSV records,
+ * whole and streamed in pieces.
+ */
+
+/*
+ *  Copyright (C) 2026  libhdate contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Each record below comes with the code it must get and, for the dates
+ * it finds, the Gregorian date of the julian day, worked out by hand.
+ * Every HDATE_PARSE_* code is produced except HDATE_PARSE_UNEXPECTED,
+ * which the checks ahead of it leave no way to reach. The records are
+ * parsed as lines ending in LF and in CRLF, then as one column of CSV
+ * and TSV records, with quoting, and each time also fed to the parser a
+ * few bytes at a time with at_end false, as a stream would be.
+ */
+
+#include <stdio.h>		/* for printf */
+#include <string.h>		/* for strlen */
+#include <hdate.h>
+
+#define MAX_RECORDS 64
+#define MAX_TEXT 4096
+
+typedef struct
+{
+	const char *date;
+	int code;
+	int gd_day, gd_mon, gd_year;	/* of the julian day, if any */
+} record_case;
+
+static const record_case records[] = {
+	{"15 Nisan 5784", HDATE_PARSE_OK, 23, 4, 2024},
+	{"2024-03-31", HDATE_PARSE_OK, 31, 3, 2024},
+	{"March 31, 2024", HDATE_PARSE_OK, 31, 3, 2024},
+	{"1 Adar II 5784", HDATE_PARSE_OK, 11, 3, 2024},
+	{"Nisan 5784", HDATE_PARSE_INCOMPLETE, 9, 4, 2024},
+	{"5784", HDATE_PARSE_INCOMPLETE, 16, 9, 2023},
+	{"99999 1 1", HDATE_PARSE_BAD_YEAR, 0, 0, 0},
+	{"150 Nisan", HDATE_PARSE_BAD_YEAR, 0, 0, 0},
+	{"foo 5784", HDATE_PARSE_BAD_MONTH, 0, 0, 0},
+	{"31 1 5784", HDATE_PARSE_BAD_DAY, 0, 0, 0},
+	{"March 15 5784", HDATE_PARSE_MISMATCH, 0, 0, 0},
+	{"Nisan 15 Iyar", HDATE_PARSE_MULTIPLE_MONTHS, 0, 0, 0},
+	{"5784 5785 Nisan", HDATE_PARSE_MULTIPLE_YEARS, 0, 0, 0},
+	{"1 2 3 4", HDATE_PARSE_FIELD_COUNT, 0, 0, 0},
+	{"", HDATE_PARSE_FIELD_COUNT, 0, 0, 0},
+	{"31 31 5", HDATE_PARSE_UNSUPPORTED, 0, 0, 0},
+	{"30 Feb 2024", HDATE_PARSE_INVALID_DATE, 0, 0, 0}
+};
+
+#define N_RECORDS (sizeof (records) / sizeof (records[0]))
+
+/* CSV and TSV lines, and the record of records[] each must read as */
+typedef struct
+{
+	const char *line;
+	int record;		/* -1 for a line without the date column */
+} column_case;
+
+static const column_case csv_lines[] = {
+	{"a,15 Nisan 5784,x", 0},
+	{"\"a, b\",\"March 31, 2024\"", 2},
+	{"\"say \"\"hi\"\"\",\"1 Adar II 5784\",\"\"", 3},
+	{"a,\"30 Feb 2024\"\r", 16},
+	{",\"\",", 14},
+	{"only one column", -1},
+	{"a,\"15 Nisan 5784", -1}
+};
+
+static const column_case tsv_lines[] = {
+	{"a\t15 Nisan 5784\tx", 0},
+	{"a, b\tMarch 31, 2024", 2},
+	{"\"a\tb\"\t\"1 Adar II 5784\"\r", 3},
+	{"x\t", 14},
+	{"x", -1}
+};
+
+static int
+expected_jd (const record_case * r)
+{
+	return r->gd_year ? hdate_gdate_to_jd (r->gd_day, r->gd_mon, r->gd_year) : 0;
+}
+
+/**
+ @brief parse text whole, then in pieces of 1 to 7 bytes with at_end
+ false until the last; both must give count records with the codes and
+ julian days expected
+*/
+static int
+check_text (const hdate_parse_options * options, const char *name, const char *text,
+			const int *codes, const int *jds, int count)
+{
+	int jd[MAX_RECORDS], code[MAX_RECORDS];
+	size_t length = strlen (text);
+	size_t start, end, used;
+	int n, i, total;
+	int errors = 0;
+
+	n = hdate_parse_date_records (options, text, length, 1, jd, code, MAX_RECORDS, &used);
+	if (n != count || used != length)
+	{
+		printf ("%s: %d records, %d bytes used, expected %d, %d\n", name, n,
+				(int) used, count, (int) length);
+		errors++;
+	}
+	for (i = 0; i < n && i < count; i++)
+		if (code[i] != codes[i] || jd[i] != jds[i])
+		{
+			printf ("%s, record %d: code %d, jd %d, expected %d, %d\n", name, i,
+					code[i], jd[i], codes[i], jds[i]);
+			errors++;
+		}
+
+	/* streamed */
+	total = 0;
+	start = 0;
+	for (end = 0; end < length;)
+	{
+		end += 1 + (end * 7 + 3) % 7;
+		if (end > length)
+			end = length;
+		n = hdate_parse_date_records (options, text + start, end - start, end == length,
+									  jd + total, code + total, MAX_RECORDS - total, &used);
+		if (n < 0)
+		{
+			printf ("%s, streamed: failed at byte %d\n", name, (int) start);
+			return errors + 1;
+		}
+		/* only a whole line is parsed before the end */
+		if (end < length && used > 0 && text[start + used - 1] != '\n')
+		{
+			printf ("%s, streamed: stopped inside a line at byte %d\n", name,
+					(int) (start + used));
+			errors++;
+		}
+		total += n;
+		start += used;
+	}
+	if (total != count || start != length)
+	{
+		printf ("%s, streamed: %d records, %d bytes used, expected %d, %d\n", name,
+				total, (int) start, count, (int) length);
+		errors++;
+	}
+	for (i = 0; i < total && i < count; i++)
+		if (code[i] != codes[i] || jd[i] != jds[i])
+		{
+			printf ("%s, streamed, record %d: code %d, jd %d, expected %d, %d\n", name, i,
+					code[i], jd[i], codes[i], jds[i]);
+			errors++;
+		}
+
+	return errors;
+}
+
+static int
+check_lines (const hdate_parse_options * options, const char *eol, const char *name)
+{
+	char text[MAX_TEXT];
+	int codes[MAX_RECORDS], jds[MAX_RECORDS];
+	unsigned int i;
+
+	text[0] = '\0';
+	for (i = 0; i < N_RECORDS; i++)
+	{
+		strcat (text, records[i].date);
+		strcat (text, eol);
+		codes[i] = records[i].code;
+		jds[i] = expected_jd (&records[i]);
+	}
+
+	return check_text (options, name, text, codes, jds, N_RECORDS);
+}
+
+static int
+check_columns (const hdate_parse_options * options, const column_case * lines, int count,
+			   const char *name)
+{
+	char text[MAX_TEXT];
+	int codes[MAX_RECORDS], jds[MAX_RECORDS];
+	int i;
+
+	text[0] = '\0';
+	for (i = 0; i < count; i++)
+	{
+		strcat (text, lines[i].line);
+		/* no newline after the last line */
+		if (i + 1 < count)
+			strcat (text, "\n");
+		if (lines[i].record < 0)
+		{
+			codes[i] = HDATE_PARSE_FIELD_COUNT;
+			jds[i] = 0;
+		}
+		else
+		{
+			codes[i] = records[lines[i].record].code;
+			jds[i] = expected_jd (&records[lines[i].record]);
+		}
+	}
+
+	return check_text (options, name, text, codes, jds, count);
+}
+
+static int
+check_arguments (const hdate_parse_options * options)
+{
+	int jd[2], code[2];
+	size_t used = 99;
+	int errors = 0;
+
+	if (hdate_parse_date_records (options, "5784\n", 5, 1, NULL, code, 2, NULL) != -1 ||
+		hdate_parse_date_records (options, "5784\n", 5, 1, jd, NULL, 2, NULL) != -1 ||
+		hdate_parse_date_records (NULL, "5784\n", 5, 1, jd, code, 2, NULL) != -1 ||
+		hdate_parse_date_records (options, NULL, 0, 1, jd, code, 2, NULL) != -1 ||
+		hdate_parse_date_records (options, "5784\n", 5, 1, jd, code, -1, NULL) != -1)
+	{
+		printf ("arguments: a bad argument was accepted\n");
+		errors++;
+	}
+	if (hdate_parse_date_records (options, "5784\n", 5, 1, NULL, NULL, 0, &used) != 0 ||
+		used != 0)
+	{
+		printf ("arguments: size 0 parsed something\n");
+		errors++;
+	}
+	/* a full array stops the parse; the rest is left for the next call */
+	if (hdate_parse_date_records (options, "5784\n5785\n", 10, 1, jd, code, 1, &used) != 1 ||
+		used != 5)
+	{
+		printf ("arguments: a full array did not stop the parse\n");
+		errors++;
+	}
+	/* with at_end false, a last line without a newline waits */
+	if (hdate_parse_date_records (options, "5784\n5785", 9, 0, jd, code, 2, &used) != 1 ||
+		used != 5)
+	{
+		printf ("arguments: an unfinished line was parsed\n");
+		errors++;
+	}
+
+	return errors;
+}
+
+int
+main ()
+{
+	hdate_parse_options options;
+	int errors = 0;
+
+	hdate_parse_options_init (&options);
+	/* a fixed today, for dates without a year */
+	hdate_set_gdate (&options.today, 1, 1, 2024);
+
+	errors += check_lines (&options, "\n", "LF");
+	errors += check_lines (&options, "\r\n", "CRLF");
+
+	options.field_separator = ',';
+	options.column = 1;
+	errors += check_columns (&options, csv_lines, sizeof (csv_lines) / sizeof (csv_lines[0]),
+							 "CSV");
+	options.field_separator = '\t';
+	errors += check_columns (&options, tsv_lines, sizeof (tsv_lines) / sizeof (tsv_lines[0]),
+							 "TSV");
+
+	options.field_separator = 0;
+	errors += check_arguments (&options);
+
+	printf ("%d records, %d CSV and %d TSV lines: %d mismatches\n", (int) N_RECORDS,
+			(int) (sizeof (csv_lines) / sizeof (csv_lines[0])),
+			(int) (sizeof (tsv_lines) / sizeof (tsv_lines[0])), errors);
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+/* test_set_jd_array.c
+ * check hdate_set_jd_array against hdate_set_jd.
+ */
+
+/*
+ *  Copyright (C) 2026  libhdate contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The julian day range is converted in blocks, once for each choice of
+ * Gregorian output arrays: all three, none, and each incomplete set
+ * (which the function must leave alone). Output arrays start out filled
+ * with garbage, so a field read before it is written shows up as a
+ * wrong Hebrew date.
+ */
+
+#include <stdio.h>		/* for printf */
+#include <string.h>		/* for memset */
+#include <hdate.h>
+
+#define BLOCK 4096
+#define GARBAGE 0x5a
+
+/* which of gd_day, gd_mon, gd_year to pass */
+static const int gdate_sets[][3] = {
+	{1, 1, 1}, {0, 0, 0}, {0, 0, 1}, {1, 0, 1}, {0, 1, 1}, {1, 1, 0}
+};
+
+static int
+check_block (int const *jd, int count, int const *set)
+{
+	int hd_day[BLOCK], hd_mon[BLOCK], hd_year[BLOCK];
+	int gd_day[BLOCK], gd_mon[BLOCK], gd_year[BLOCK];
+	int dw[BLOCK], year_type[BLOCK];
+	int gdate_filled = set[0] && set[1] && set[2];
+	hdate_struct h;
+	int i;
+	int errors = 0;
+
+	memset (hd_day, GARBAGE, sizeof (hd_day));
+	memset (hd_mon, GARBAGE, sizeof (hd_mon));
+	memset (hd_year, GARBAGE, sizeof (hd_year));
+	memset (gd_day, GARBAGE, sizeof (gd_day));
+	memset (gd_mon, GARBAGE, sizeof (gd_mon));
+	memset (gd_year, GARBAGE, sizeof (gd_year));
+	memset (dw, GARBAGE, sizeof (dw));
+	memset (year_type, GARBAGE, sizeof (year_type));
+
+	if (hdate_set_jd_array (jd, count, hd_day, hd_mon, hd_year,
+							set[0] ? gd_day : NULL, set[1] ? gd_mon : NULL,
+							set[2] ? gd_year : NULL, dw, year_type) != count)
+		return 1;
+
+	for (i = 0; i < count; i++)
+	{
+		hdate_set_jd (&h, jd[i]);
+		if (hd_day[i] != h.hd_day || hd_mon[i] != h.hd_mon || hd_year[i] != h.hd_year ||
+			dw[i] != h.hd_dw || year_type[i] != h.hd_year_type ||
+			(gdate_filled &&
+			 (gd_day[i] != h.gd_day || gd_mon[i] != h.gd_mon || gd_year[i] != h.gd_year)))
+		{
+			if (errors++ < 5)
+				printf ("jd %d, gregorian arrays %d%d%d: %d-%d-%d, expected %d-%d-%d\n",
+						jd[i], set[0], set[1], set[2], hd_year[i], hd_mon[i], hd_day[i],
+						h.hd_year, h.hd_mon, h.hd_day);
+		}
+		/* an incomplete set is not written */
+		if (!gdate_filled &&
+			((set[0] && gd_day[i] == h.gd_day) || (set[1] && gd_mon[i] == h.gd_mon) ||
+			 (set[2] && gd_year[i] == h.gd_year)))
+		{
+			if (errors++ < 5)
+				printf ("jd %d, gregorian arrays %d%d%d: incomplete set written\n",
+						jd[i], set[0], set[1], set[2]);
+		}
+	}
+
+	return errors;
+}
+
+int
+main ()
+{
+	int jd[BLOCK];
+	int start, i, n;
+	unsigned int s;
+	int errors = 0;
+
+	for (s = 0; s < sizeof (gdate_sets) / sizeof (gdate_sets[0]); s++)
+	{
+		int e = 0;
+
+		for (start = HDATE_JUL_DY_LOWER_BOUND; start <= HDATE_JUL_DY_UPPER_BOUND;
+			 start += BLOCK)
+		{
+			n = HDATE_JUL_DY_UPPER_BOUND - start + 1;
+			if (n > BLOCK)
+				n = BLOCK;
+			for (i = 0; i < n; i++)
+				jd[i] = start + i;
+			e += check_block (jd, n, gdate_sets[s]);
+		}
+
+		printf ("gregorian arrays %d%d%d: %d mismatches\n",
+				gdate_sets[s][0], gdate_sets[s][1], gdate_sets[s][2], e);
+		errors += e;
+	}
+
+	return errors ? 1 : 0;
+}
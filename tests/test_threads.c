@@ -0,0 +1,195 @@
+/* test_threads.c
+ * check that the date setters give the same answers from many threads
+ * as from one.
+ */
+
+/*
+ *  Copyright (C) 2026  libhdate contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The threads start while the per year table of hdate_julian.c is still
+ * empty, each at a different point of the julian day range, and walk
+ * the whole range with hdate_set_time, calling hdate_set_today along the
+ * way. So they fill the table lazily and race each other on it. Each
+ * thread folds the fields of every day into a sum per Hebrew year; the
+ * sums are then compared with those of a single threaded walk done
+ * after the threads are joined.
+ */
+
+#include <stdio.h>		/* for printf */
+#include <stdlib.h>		/* for atoi */
+#include <pthread.h>
+#include <time.h>
+#include <hdate.h>
+
+#define MAX_THREADS 64
+#define N_YEARS (HDATE_HEB_YR_UPPER_BOUND - HDATE_HEB_YR_LOWER_BOUND + 1)
+
+/* the epoch, 1 January 1970, as a julian day */
+#define JD_EPOCH 2440588
+
+typedef struct
+{
+	int first_jd;
+	int last_jd;
+	int start_jd;
+	int today_jd;
+	int errors;
+	unsigned long long year_sum[N_YEARS];
+} walk_t;
+
+static unsigned long long
+mix (unsigned long long x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+/**
+ @brief fold the fields of one date into its year's sum; the sum does
+ not depend on the order the days are visited in
+*/
+static int
+add_day (walk_t * w, hdate_struct const *h, int jd)
+{
+	unsigned long long x;
+
+	if (h->hd_jd != jd ||
+		h->hd_year < HDATE_HEB_YR_LOWER_BOUND || h->hd_year > HDATE_HEB_YR_UPPER_BOUND)
+		return 1;
+
+	x = mix ((unsigned long long) jd);
+	x = mix (x ^ (h->hd_day | h->hd_mon << 5 | h->hd_dw << 9 | h->hd_year_type << 12));
+	x = mix (x ^ (h->gd_day | h->gd_mon << 5 | (unsigned long long) h->gd_year << 9));
+	x = mix (x ^ (h->hd_size_of_year | h->hd_new_year_dw << 9));
+	x = mix (x ^ ((unsigned long long) h->hd_days << 16 ^ h->hd_weeks));
+
+	w->year_sum[h->hd_year - HDATE_HEB_YR_LOWER_BOUND] += x;
+
+	return 0;
+}
+
+static void *
+walk (void *arg)
+{
+	walk_t *w = arg;
+	hdate_struct h;
+	int n = w->last_jd - w->first_jd + 1;
+	int i, jd;
+	long tz;
+	time_t t;
+
+	for (i = 0; i < n; i++)
+	{
+		jd = w->first_jd + (w->start_jd - w->first_jd + i) % n;
+
+		/* a moment whose local date is jd, at an offset that varies by day */
+		tz = (long) (jd % 29 - 14) * 3600;
+		t = (time_t) (jd - JD_EPOCH) * 86400 + 43200 - tz;
+
+		hdate_set_time (&h, t, tz);
+		w->errors += add_day (w, &h, jd);
+
+		if (i % 4096 == 0)
+		{
+			hdate_set_today (&h);
+			if (h.hd_jd != w->today_jd)
+			{
+				/* allow for midnight passing while we run */
+				if (h.hd_jd == w->today_jd + 1)
+					w->today_jd++;
+				else
+					w->errors++;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+int
+main (int argc, char *argv[])
+{
+	static walk_t walks[MAX_THREADS + 1];
+	pthread_t threads[MAX_THREADS];
+	walk_t *ref = &walks[MAX_THREADS];
+	int first_jd = HDATE_JUL_DY_LOWER_BOUND;
+	int last_jd = HDATE_JUL_DY_UPPER_BOUND;
+	int n_threads = 8;
+	int i, y;
+	int errors = 0;
+	hdate_struct today;
+
+	if (argc > 1)
+		n_threads = atoi (argv[1]);
+	if (n_threads < 1 || n_threads > MAX_THREADS)
+		n_threads = 8;
+
+	/* the moments must fit in time_t */
+	if (sizeof (time_t) < 8)
+	{
+		first_jd = JD_EPOCH - 24855 + 1;
+		last_jd = JD_EPOCH + 24855 - 1;
+	}
+
+	hdate_set_today (&today);
+
+	for (i = 0; i < n_threads; i++)
+	{
+		walks[i].first_jd = first_jd;
+		walks[i].last_jd = last_jd;
+		walks[i].start_jd = first_jd + (int) ((long long) (last_jd - first_jd) * i / n_threads);
+		walks[i].today_jd = today.hd_jd;
+		if (pthread_create (&threads[i], NULL, walk, &walks[i]))
+		{
+			printf ("pthread_create failed\n");
+			return 1;
+		}
+	}
+	for (i = 0; i < n_threads; i++)
+		pthread_join (threads[i], NULL);
+
+	/* the same walk in this thread alone, with the table filled */
+	ref->first_jd = first_jd;
+	ref->last_jd = last_jd;
+	ref->start_jd = first_jd;
+	ref->today_jd = walks[0].today_jd;
+	walk (ref);
+	errors += ref->errors;
+
+	for (i = 0; i < n_threads; i++)
+	{
+		int e = walks[i].errors;
+
+		for (y = 0; y < N_YEARS; y++)
+			if (walks[i].year_sum[y] != ref->year_sum[y])
+			{
+				if (e++ < 10)
+					printf ("thread %d: year %d differs\n", i, y + HDATE_HEB_YR_LOWER_BOUND);
+			}
+		errors += e;
+	}
+
+	printf ("%d threads, julian days %d - %d: %d mismatches\n",
+			n_threads, first_jd, last_jd, errors);
+
+	return errors ? 1 : 0;
+}
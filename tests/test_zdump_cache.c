@@ -0,0 +1,235 @@
+/* test_zdump_cache.c
+ * check zdump, answering through the zone cache from many threads,
+ * against zdump_zone_dump.
+ */
+
+/*
+ *  Copyright (C) 2026  libhdate contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Each zone of zones[] that the system has is opened once here with
+ * zdump_zone_open, and its zdump_zone_dump answers are the reference.
+ * The threads then ask zdump, and zdump_cache_get with
+ * zdump_zone_offset_at, about random zones and random spans, some
+ * inside the cached window of years and some across its ends. Meanwhile
+ * one thread keeps dropping zones, or the whole cache, with
+ * zdump_cache_invalidate, and another keeps changing the capacity and
+ * the window with zdump_cache_configure, turning the cache off now and
+ * then. Without tzdata there is nothing to test, and the test is
+ * skipped.
+ */
+
+#include <stdio.h>		/* for printf */
+#include <stdlib.h>		/* for free */
+#include <string.h>		/* for strcmp */
+#include <pthread.h>
+#include "zdump3.h"
+
+#define N_THREADS 8
+#define STEPS 3000
+
+/* the exit status automake takes for a skipped test */
+#define SKIP 77
+
+#define SECONDS_PER_YEAR 31556952L
+
+static const char *zones[] = {
+	"Asia/Jerusalem", "America/New_York", "Europe/London", "Europe/Moscow",
+	"Australia/Sydney", "Australia/Lord_Howe", "Pacific/Auckland",
+	"Pacific/Chatham", "America/Sao_Paulo", "America/Santiago",
+	"America/St_Johns", "Asia/Tehran", "Asia/Kolkata", "Asia/Kathmandu",
+	"Africa/Cairo", "Africa/Casablanca", "Europe/Dublin", "Asia/Baku",
+	"America/Godthab", "Antarctica/Troll", "UTC"
+};
+
+#define N_ZONES (sizeof (zones) / sizeof (zones[0]))
+
+static zdump_zone reference[N_ZONES];
+static int available[N_ZONES];
+static int n_available;
+
+/* the years the spans are drawn from; narrowed if time_t has 32 bits */
+static int first_year = 1900;
+static int last_year = 2200;
+
+typedef struct
+{
+	int id;
+	unsigned int seed;
+	int errors;
+	int answers;
+} worker_t;
+
+static unsigned int
+next_random (unsigned int *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 8) & 0xffffff;
+}
+
+static time_t
+year_start (int year)
+{
+	return (time_t) (year - 1970) * SECONDS_PER_YEAR;
+}
+
+static int
+compare_dump (worker_t * w, int z, time_t start, time_t end)
+{
+	zdumpinfo *got, *expected;
+	int n_got, n_expected, i;
+	int result_got, result_expected;
+	int errors = 0;
+
+	result_got = zdump (zones[z], start, end, &n_got, (void **) &got);
+	result_expected = zdump_zone_dump (&reference[z], start, end, &n_expected,
+									   (void **) &expected);
+
+	if (result_got != result_expected || n_got != n_expected)
+		errors = 1;
+	else
+		for (i = 0; i < n_got && !errors; i++)
+			if (got[i].start != expected[i].start ||
+				got[i].utc_offset != expected[i].utc_offset ||
+				got[i].save_secs != expected[i].save_secs ||
+				strcmp (got[i].abbr, expected[i].abbr) != 0)
+				errors = 1;
+
+	if (errors && w->errors < 10)
+		printf ("thread %d, %s, %ld - %ld: %d entries (%d), expected %d (%d)\n",
+				w->id, zones[z], (long) start, (long) end, n_got, result_got,
+				n_expected, result_expected);
+
+	free (got);
+	free (expected);
+	w->answers++;
+
+	return errors;
+}
+
+static int
+compare_offset (worker_t * w, int z, time_t t)
+{
+	const zdump_zone *zone;
+	zdump_offset got, expected;
+	int errors = 0;
+
+	if (zdump_cache_get (zones[z], &zone) != 0)
+	{
+		if (w->errors < 10)
+			printf ("thread %d, %s: zdump_cache_get failed\n", w->id, zones[z]);
+		return 1;
+	}
+	if (zdump_zone_offset_at (zone, t, &got) != 0 ||
+		zdump_zone_offset_at (&reference[z], t, &expected) != 0 ||
+		got.utc_offset != expected.utc_offset || got.is_dst != expected.is_dst ||
+		strcmp (got.abbr, expected.abbr) != 0)
+		errors = 1;
+	zdump_cache_release (zone);
+
+	if (errors && w->errors < 10)
+		printf ("thread %d, %s, %ld: offset %d, expected %d\n",
+				w->id, zones[z], (long) t, got.utc_offset, expected.utc_offset);
+	w->answers++;
+
+	return errors;
+}
+
+static void *
+work (void *arg)
+{
+	static const int capacities[] = { 16, 2, 0, 512, 1 };
+	static const int windows[][2] = { {1970, 2100}, {2000, 2030}, {1900, 2200}, {2020, 2020} };
+	worker_t *w = arg;
+	int k, z, span;
+	time_t start;
+
+	for (k = 0; k < STEPS; k++)
+	{
+		z = available[next_random (&w->seed) % n_available];
+		start = year_start (first_year) +
+			(time_t) (next_random (&w->seed) % (last_year - first_year - 40)) * SECONDS_PER_YEAR +
+			(time_t) (next_random (&w->seed) % 86400) * 366;
+		span = next_random (&w->seed) % 3;
+		span = (span == 0) ? 86400 : (span == 1) ? 366 * 86400 : 40 * SECONDS_PER_YEAR;
+
+		if (k % 4 == 3)
+			w->errors += compare_offset (w, z, start);
+		else
+			w->errors += compare_dump (w, z, start, start + span);
+
+		if (w->id == 0 && k % 50 == 0)
+			zdump_cache_invalidate ((k % 200) ? zones[z] : NULL);
+		if (w->id == 1 && k % 150 == 0)
+			zdump_cache_configure (capacities[(k / 150) % 5],
+								   windows[(k / 150) % 4][0], windows[(k / 150) % 4][1]);
+	}
+
+	return NULL;
+}
+
+int
+main ()
+{
+	static worker_t workers[N_THREADS];
+	pthread_t threads[N_THREADS];
+	unsigned int z;
+	int i, errors = 0, answers = 0;
+
+	if (sizeof (time_t) < 8)
+	{
+		first_year = 1902;
+		last_year = 2037;
+	}
+
+	for (z = 0; z < N_ZONES; z++)
+		if (zdump_zone_open (&reference[z], zones[z]) == 0)
+			available[n_available++] = z;
+	if (n_available == 0)
+	{
+		printf ("no tzdata, skipped\n");
+		return SKIP;
+	}
+
+	zdump_cache_configure (16, 1970, 2100);
+
+	for (i = 0; i < N_THREADS; i++)
+	{
+		workers[i].id = i;
+		workers[i].seed = 7 * i + 1;
+		if (pthread_create (&threads[i], NULL, work, &workers[i]))
+		{
+			printf ("pthread_create failed\n");
+			return 1;
+		}
+	}
+	for (i = 0; i < N_THREADS; i++)
+	{
+		pthread_join (threads[i], NULL);
+		errors += workers[i].errors;
+		answers += workers[i].answers;
+	}
+
+	zdump_cache_invalidate (NULL);
+	for (i = 0; i < n_available; i++)
+		zdump_zone_close (&reference[available[i]]);
+
+	printf ("%d threads, %d zones, %d answers: %d mismatches\n",
+			N_THREADS, n_available, answers, errors);
+
+	return errors ? 1 : 0;
+}
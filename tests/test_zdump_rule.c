@@ -0,0 +1,240 @@
+/* test_zdump_rule.c
+ * check zdump_rule_decode, zdump_rule_transition and
+ * zdump_rule_offset_at on hand written POSIX TZ strings.
+ */
+
+/*
+ *  Copyright (C) 2026  libhdate contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The expected epochs were worked out from the calendar by hand; the
+ * comment by each gives the UTC moment. No tzdata is needed.
+ */
+
+#include <stdio.h>		/* for printf */
+#include <string.h>		/* for strcmp */
+#include "zdump3.h"
+
+typedef struct
+{
+	const char *tz;
+	const char *abbr[2];	/* indexed by ZD_STD and ZD_DST */
+	int offset[2];
+	int has_dst;
+} decode_case;
+
+static const decode_case decodes[] = {
+	{"IST-2IDT,M3.4.4/26,M10.5.0", {"IST", "IDT"}, {7200, 10800}, 1},
+	{"AEST-10AEDT,M10.1.0,M4.1.0/3", {"AEST", "AEDT"}, {36000, 39600}, 1},
+	{"<+0330>-3:30<+0430>,J79/24,J263/24", {"+0330", "+0430"}, {12600, 16200}, 1},
+	{"<-02>2<-01>,M3.5.0/-1,M10.5.0/0", {"-02", "-01"}, {-7200, -3600}, 1},
+	{"EST5EDT,0/0,J365/25", {"EST", "EDT"}, {-18000, -14400}, 1},
+	{"NZST-12NZDT-13:45,M9.5.0,M4.1.0/3", {"NZST", "NZDT"}, {43200, 49500}, 1},
+	{"EST5EDT", {"EST", "EDT"}, {-18000, -14400}, 1},
+	{"<+0545>-5:45", {"+0545", ""}, {20700, 0}, 0},
+	{"UTC0\n", {"UTC", ""}, {0, 0}, 0}
+};
+
+/* strings zdump_rule_decode must refuse */
+static const char *bad_rules[] = {
+	"", "5EST", "EST", "<+03", "EST5EDT,M3.2.0", "EST5EDT,M13.2.0,M11.1.0",
+	"EST5EDT,M3.0.0,M11.1.0", "EST5EDT,M3.2.7,M11.1.0", "EST5EDT,J0,J300",
+	"EST5EDT,J366,J300", "EST5EDT,366,300", "EST5EDT,M3.2.0/168,M11.1.0",
+	"EST5EDT,M3.2.0/2:60,M11.1.0", "EST5EDT,M3.2.0,M11.1.0x"
+};
+
+typedef struct
+{
+	const char *tz;
+	long year;
+	time_t dst;		/* DST begins */
+	time_t std;		/* DST ends */
+} transition_case;
+
+static const transition_case transitions[] = {
+	/* the day after the fourth Thursday of March at 02:00, 00:00 UTC;
+	   the last Sunday of October at 02:00 IDT, 23:00 UTC the day before */
+	{"IST-2IDT,M3.4.4/26,M10.5.0", 2023, 1679616000, 1698534000},	/* 24 Mar, 28 Oct */
+	{"IST-2IDT,M3.4.4/26,M10.5.0", 2024, 1711670400, 1729983600},	/* 29 Mar, 26 Oct */
+	/* southern hemisphere: DST ends in April and begins in October */
+	{"AEST-10AEDT,M10.1.0,M4.1.0/3", 2024, 1728144000, 1712419200},	/* 5 Oct 16:00, 6 Apr 16:00 */
+	/* DST all year: from 1 January 00:00 EST to 31 December 25:00 EDT,
+	   the moment the next year's DST begins */
+	{"EST5EDT,0/0,J365/25", 2024, 1704085200, 1735707600},	/* 1 Jan 2024 05:00, 1 Jan 2025 05:00 */
+	/* J never counts 29 February, so J60 is always 1 March */
+	{"EST5EDT,J60/0,J300", 2023, 1677646800, 1698386400},	/* 1 Mar 05:00, 27 Oct 06:00 */
+	{"EST5EDT,J60/0,J300", 2024, 1709269200, 1730008800},	/* 1 Mar 05:00, 27 Oct 06:00 */
+	/* n counts from 0, and counts 29 February */
+	{"EST5EDT,59/0,299", 2023, 1677646800, 1698386400},	/* 1 Mar 05:00, 27 Oct 06:00 */
+	{"EST5EDT,59/0,299", 2024, 1709182800, 1729922400},	/* 29 Feb 05:00, 26 Oct 06:00 */
+	/* quoted names, a half hour offset and 24:00 */
+	{"<+0330>-3:30<+0430>,J79/24,J263/24", 2021, 1616272200, 1632166200},	/* 20 Mar 20:30, 20 Sep 19:30 */
+	{"<+0330>-3:30<+0430>,J79/24,J263/24", 2024, 1710966600, 1726860600},	/* 20 Mar 20:30, 20 Sep 19:30 */
+	/* a negative time: 23:00 local on the Saturday */
+	{"<-02>2<-01>,M3.5.0/-1,M10.5.0/0", 2024, 1711846800, 1729990800},	/* 31 Mar 01:00, 27 Oct 01:00 */
+	/* no dates: glibc's default, the second Sunday of March to the
+	   first of November */
+	{"EST5EDT", 2024, 1710054000, 1730613600}	/* 10 Mar 07:00, 3 Nov 06:00 */
+};
+
+typedef struct
+{
+	const char *tz;
+	time_t t;
+	int utc_offset;
+	int is_dst;
+	time_t start;
+	time_t until;
+} offset_case;
+
+static const offset_case offsets[] = {
+	{"IST-2IDT,M3.4.4/26,M10.5.0", 1711670399, 7200, 0, 1698534000, 1711670400},
+	{"IST-2IDT,M3.4.4/26,M10.5.0", 1711670400, 10800, 1, 1711670400, 1729983600},
+	/* 15 January, summer in Sydney */
+	{"AEST-10AEDT,M10.1.0,M4.1.0/3", 1705320000, 39600, 1, 1696089600, 1712419200},
+	{"AEST-10AEDT,M10.1.0,M4.1.0/3", 1719792000, 36000, 0, 1712419200, 1728144000},
+	/* DST all year, even across the new year, as RFC 8536 reads the
+	   rule; glibc's localtime gives EST for the last hours of the year */
+	{"EST5EDT,0/0,J365/25", 1719792000, -14400, 1, 1704085200, 1735707600},
+	{"EST5EDT,0/0,J365/25", 1735696800, -14400, 1, 1704085200, 1735707600},
+	{"EST5EDT,0/0,J365/25", 1735707600, -14400, 1, 1735707600, 1767243600},
+	{"<-02>2<-01>,M3.5.0/-1,M10.5.0/0", 1711846799, -7200, 0, 1698541200, 1711846800},
+	{"<-02>2<-01>,M3.5.0/-1,M10.5.0/0", 1711846800, -3600, 1, 1711846800, 1729990800}
+};
+
+#define COUNT(a) (sizeof (a) / sizeof ((a)[0]))
+
+static int
+check_decode (void)
+{
+	zdump_rule rule;
+	unsigned int i;
+	int k, errors = 0;
+
+	for (i = 0; i < COUNT (decodes); i++)
+	{
+		const decode_case *c = &decodes[i];
+
+		if (zdump_rule_decode (&rule, c->tz) != ZD_SUCCESS)
+		{
+			printf ("decode \"%s\": failed\n", c->tz);
+			errors++;
+			continue;
+		}
+		if (rule.has_dst != c->has_dst)
+		{
+			printf ("decode \"%s\": has_dst %d\n", c->tz, rule.has_dst);
+			errors++;
+		}
+		for (k = ZD_STD; k <= (c->has_dst ? ZD_DST : ZD_STD); k++)
+			if (strcmp (rule.abbr[k], c->abbr[k]) != 0 || rule.offset[k] != c->offset[k])
+			{
+				printf ("decode \"%s\": %s %d, expected %s %d\n", c->tz,
+						rule.abbr[k], rule.offset[k], c->abbr[k], c->offset[k]);
+				errors++;
+			}
+	}
+
+	for (i = 0; i < COUNT (bad_rules); i++)
+		if (zdump_rule_decode (&rule, bad_rules[i]) == ZD_SUCCESS)
+		{
+			printf ("decode \"%s\": accepted\n", bad_rules[i]);
+			errors++;
+		}
+
+	return errors;
+}
+
+static int
+check_transitions (void)
+{
+	zdump_rule rule;
+	unsigned int i;
+	time_t dst, std;
+	int errors = 0;
+
+	for (i = 0; i < COUNT (transitions); i++)
+	{
+		const transition_case *c = &transitions[i];
+
+		if (zdump_rule_decode (&rule, c->tz) != ZD_SUCCESS)
+		{
+			printf ("transition \"%s\": decode failed\n", c->tz);
+			errors++;
+			continue;
+		}
+		dst = zdump_rule_transition (&rule, ZD_DST, c->year);
+		std = zdump_rule_transition (&rule, ZD_STD, c->year);
+		if (dst != c->dst || std != c->std)
+		{
+			printf ("transition \"%s\", %ld: %ld %ld, expected %ld %ld\n", c->tz, c->year,
+					(long) dst, (long) std, (long) c->dst, (long) c->std);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+static int
+check_offsets (void)
+{
+	zdump_rule rule;
+	zdump_offset o;
+	unsigned int i;
+	int errors = 0;
+
+	for (i = 0; i < COUNT (offsets); i++)
+	{
+		const offset_case *c = &offsets[i];
+
+		if (zdump_rule_decode (&rule, c->tz) != ZD_SUCCESS ||
+			zdump_rule_offset_at (&rule, c->t, &o) != ZD_SUCCESS)
+		{
+			printf ("offset \"%s\", %ld: failed\n", c->tz, (long) c->t);
+			errors++;
+			continue;
+		}
+		if (o.utc_offset != c->utc_offset || o.is_dst != c->is_dst ||
+			o.start != c->start || o.until != c->until)
+		{
+			printf ("offset \"%s\", %ld: %d %d from %ld until %ld, "
+					"expected %d %d from %ld until %ld\n", c->tz, (long) c->t,
+					o.utc_offset, o.is_dst, (long) o.start, (long) o.until,
+					c->utc_offset, c->is_dst, (long) c->start, (long) c->until);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+int
+main ()
+{
+	int errors = 0;
+
+	errors += check_decode ();
+	errors += check_transitions ();
+	errors += check_offsets ();
+
+	printf ("%d decodes, %d refusals, %d transitions, %d offsets: %d mismatches\n",
+			(int) COUNT (decodes), (int) COUNT (bad_rules), (int) COUNT (transitions),
+			(int) COUNT (offsets), errors);
+
+	return errors ? 1 : 0;
+}